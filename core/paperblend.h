@@ -0,0 +1,81 @@
+#ifndef PAPERBLEND_H
+#define PAPERBLEND_H
+
+#include <QtGlobal>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PAPER_BLEND_SSE2
+#endif
+
+/**
+ * @brief 纸张效果的逐行混合内核
+ *
+ * out = (src × (255 - w) + paper × w) / 255 + add（饱和），
+ * paper/weight/add 已按通道展开，与像素字节一一对应。
+ * SSE2 是 x64 的基线指令集，无需运行时检测；其余平台走标量循环。
+ * 单独成文件以便 tools/paperbench 对照标量实现校验。
+ */
+namespace PaperBlend {
+
+// 定点除以 255 并四舍五入（x ≤ 255 × 255）
+inline int div255(int x)
+{
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+inline void blendRowScalar(uchar* pixels, const uchar* paper, const uchar* weight,
+                           const uchar* add, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        const int w = weight[i];
+        const int blended = div255(pixels[i] * (255 - w) + paper[i] * w);
+        pixels[i] = static_cast<uchar>(std::min(255, blended + add[i]));
+    }
+}
+
+#if defined(PAPER_BLEND_SSE2)
+// 8 个 16 位通道：乘积不超过 255 × 255，16 位足够
+inline __m128i blendLanes(__m128i src, __m128i paper, __m128i weight, __m128i full, __m128i half)
+{
+    __m128i x = _mm_add_epi16(_mm_mullo_epi16(src, _mm_sub_epi16(full, weight)),
+                              _mm_mullo_epi16(paper, weight));
+    x = _mm_add_epi16(x, half);
+    return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+#endif
+
+inline void blendRow(uchar* pixels, const uchar* paper, const uchar* weight,
+                     const uchar* add, int count)
+{
+    int i = 0;
+
+#if defined(PAPER_BLEND_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i full = _mm_set1_epi16(255);
+    const __m128i half = _mm_set1_epi16(128);
+    for (; i + 16 <= count; i += 16) {
+        const __m128i src = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i));
+        const __m128i bg = _mm_loadu_si128(reinterpret_cast<const __m128i*>(paper + i));
+        const __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(weight + i));
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(add + i));
+
+        const __m128i lo = blendLanes(_mm_unpacklo_epi8(src, zero), _mm_unpacklo_epi8(bg, zero),
+                                      _mm_unpacklo_epi8(w, zero), full, half);
+        const __m128i hi = blendLanes(_mm_unpackhi_epi8(src, zero), _mm_unpackhi_epi8(bg, zero),
+                                      _mm_unpackhi_epi8(w, zero), full, half);
+
+        const __m128i out = _mm_adds_epu8(_mm_packus_epi16(lo, hi), a);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + i), out);
+    }
+#endif
+
+    // 剩余字节（或不支持 SSE2 的平台）
+    blendRowScalar(pixels + i, paper + i, weight + i, add + i, count - i);
+}
+
+} // namespace PaperBlend
+
+#endif // PAPERBLEND_H
@@ -1,10 +1,14 @@
 #include "papereffectenhancer.h"
+#include "paperblend.h"
 #include <QMutexLocker>
+#include <algorithm>
 #include <random>
+#include <vector>
 
 PaperEffectEnhancer::PaperEffectEnhancer(const AdvancedOptions& opt)
     : m_options(opt)
 {
+    rebuildIntensityTable();
 }
 
 PaperEffectEnhancer::~PaperEffectEnhancer()
@@ -17,102 +21,40 @@ QImage PaperEffectEnhancer::enhance(const QImage& input)
         return input;
     }
 
-    // 转换为 OpenCV Mat
-    cv::Mat img = qImageToCvMat(input);
-    if (img.empty()) {
+    // 直接在 RGB888 / 灰度图上处理，不再来回转换 BGR Mat
+    const bool isGray = (input.format() == QImage::Format_Grayscale8);
+    QImage image = (isGray || input.format() == QImage::Format_RGB888)
+                       ? input : input.convertToFormat(QImage::Format_RGB888);
+    if (image.isNull()) {
         return input;
     }
 
     // 1. 创建文字遮罩 (黑色=文字, 白色=背景)
-    cv::Mat textMask = createTextMask(img);
-
-    // 2. 应用纸张背景色
-    applyPaperBackground(img, textMask);
-
-    // 3. 应用纸张纹理（如果启用）
-    if (m_options.enablePaperTexture) {
-        applyPaperTexture(img, textMask);
+    cv::Mat gray;
+    {
+        const cv::Mat view(image.height(), image.width(), isGray ? CV_8UC1 : CV_8UC3,
+                           const_cast<uchar*>(image.constBits()),
+                           static_cast<size_t>(image.bytesPerLine()));
+        if (isGray) {
+            gray = view;
+        } else {
+            cv::cvtColor(view, gray, cv::COLOR_RGB2GRAY);
+        }
     }
+    cv::Mat textMask = createTextMask(gray);
 
-    // 转换回 QImage
-    return cvMatToQImage(img);
+    // 2. 纸张背景色 + 纸张纹理（一次遍历）
+    applyPaperLayer(image, textMask);
+
+    return image;
 }
 
 void PaperEffectEnhancer::setOptions(const AdvancedOptions& opt)
 {
     m_options = opt;
 
-    // 清除纹理缓存，下次使用时重新生成
-    m_cachedTexture = cv::Mat();
-}
-
-cv::Mat PaperEffectEnhancer::qImageToCvMat(const QImage& image)
-{
-    cv::Mat mat;
-    switch (image.format()) {
-    case QImage::Format_RGB32:
-    case QImage::Format_ARGB32:
-    case QImage::Format_ARGB32_Premultiplied:
-    {
-        mat = cv::Mat(image.height(), image.width(), CV_8UC4,
-                      const_cast<uchar*>(image.bits()),
-                      static_cast<size_t>(image.bytesPerLine()));
-        cv::Mat result;
-        cv::cvtColor(mat, result, cv::COLOR_RGBA2BGR);
-        return result.clone();
-    }
-    case QImage::Format_RGB888:
-    {
-        mat = cv::Mat(image.height(), image.width(), CV_8UC3,
-                      const_cast<uchar*>(image.bits()),
-                      static_cast<size_t>(image.bytesPerLine()));
-        cv::Mat result;
-        cv::cvtColor(mat, result, cv::COLOR_RGB2BGR);
-        return result.clone();
-    }
-    case QImage::Format_Grayscale8:
-    {
-        mat = cv::Mat(image.height(), image.width(), CV_8UC1,
-                      const_cast<uchar*>(image.bits()),
-                      static_cast<size_t>(image.bytesPerLine()));
-        return mat.clone();
-    }
-    default:
-    {
-        QImage convertedImage = image.convertToFormat(QImage::Format_RGB888);
-        return qImageToCvMat(convertedImage);
-    }
-    }
-}
-
-QImage PaperEffectEnhancer::cvMatToQImage(const cv::Mat& mat)
-{
-    switch (mat.type()) {
-    case CV_8UC1:
-    {
-        QImage image(mat.data, mat.cols, mat.rows,
-                     static_cast<int>(mat.step), QImage::Format_Grayscale8);
-        return image.copy();
-    }
-    case CV_8UC3:
-    {
-        cv::Mat rgb;
-        cv::cvtColor(mat, rgb, cv::COLOR_BGR2RGB);
-        QImage image(rgb.data, rgb.cols, rgb.rows,
-                     static_cast<int>(rgb.step), QImage::Format_RGB888);
-        return image.copy();
-    }
-    case CV_8UC4:
-    {
-        cv::Mat rgba;
-        cv::cvtColor(mat, rgba, cv::COLOR_BGRA2RGBA);
-        QImage image(rgba.data, rgba.cols, rgba.rows,
-                     static_cast<int>(rgba.step), QImage::Format_ARGB32);
-        return image.copy();
-    }
-    default:
-        return QImage();
-    }
+    // 纹理与选项无关，保留；强度表随中心/边缘强度变化
+    rebuildIntensityTable();
 }
 
 int PaperEffectEnhancer::calculateAdaptiveThreshold(const cv::Mat& gray)
@@ -130,18 +72,8 @@ int PaperEffectEnhancer::calculateAdaptiveThreshold(const cv::Mat& gray)
     return adaptiveThreshold;
 }
 
-cv::Mat PaperEffectEnhancer::createTextMask(const cv::Mat& img)
+cv::Mat PaperEffectEnhancer::createTextMask(const cv::Mat& gray)
 {
-    cv::Mat gray;
-
-    // 转换为灰度图
-    if (img.channels() == 3) {
-        cv::cvtColor(img, gray, cv::COLOR_BGR2GRAY);
-    } else {
-        gray = img.clone();
-    }
-
-
     int finalThreshold = m_options.threshold;
     if (m_options.useAdaptiveThreshold && m_options.threshold == 0) {
         finalThreshold = calculateAdaptiveThreshold(gray);
@@ -189,107 +121,108 @@ cv::Mat PaperEffectEnhancer::detectTextEdges(const cv::Mat& gray)
     return edges;
 }
 
-cv::Mat PaperEffectEnhancer::createProgressiveIntensityMask(const cv::Size& size)
+void PaperEffectEnhancer::rebuildIntensityTable()
 {
-    cv::Mat intensityMask(size, CV_32F);
-
-    // 计算中心点
-    float centerX = size.width / 2.0f;
-    float centerY = size.height / 2.0f;
-
-    // 最大半径（从中心到角落的距离）
-    float maxRadius = std::sqrt(centerX * centerX + centerY * centerY);
+    // 表项 i 对应归一化距离平方 i / INTENSITY_TABLE_SIZE（0=中心, 1=角落）
+    m_intensityTable.resize(INTENSITY_TABLE_SIZE + 1);
+    for (int i = 0; i <= INTENSITY_TABLE_SIZE; ++i) {
+        const double normalizedDistance = std::sqrt(static_cast<double>(i) / INTENSITY_TABLE_SIZE);
 
-    // 生成径向渐变
-    for (int y = 0; y < size.height; y++) {
-        for (int x = 0; x < size.width; x++) {
-            // 计算当前点到中心的距离
-            float dx = x - centerX;
-            float dy = y - centerY;
-            float distance = std::sqrt(dx * dx + dy * dy);
+        // 线性插值：中心用 centerIntensity，边缘用 edgeIntensity
+        const double intensity = m_options.centerIntensity +
+                                 (m_options.edgeIntensity - m_options.centerIntensity) * normalizedDistance;
 
-            // 归一化距离 (0=中心, 1=边缘)
-            float normalizedDistance = distance / maxRadius;
-
-            // 线性插值：中心用 centerIntensity，边缘用 edgeIntensity
-            float intensity = m_options.centerIntensity +
-                              (m_options.edgeIntensity - m_options.centerIntensity) * normalizedDistance;
-
-            intensityMask.at<float>(y, x) = intensity;
-        }
+        m_intensityTable[i] = cv::saturate_cast<uchar>(intensity * 255.0);
     }
-
-    return intensityMask;
 }
 
-void PaperEffectEnhancer::applyPaperBackground(cv::Mat& img, const cv::Mat& textMask)
+void PaperEffectEnhancer::applyPaperLayer(QImage& image, const cv::Mat& textMask)
 {
-    // 创建纸张背景图
-    cv::Mat paperBackground(img.size(), img.type(), m_options.paperColor);
-
-    // 如果是灰度图，转换纸张颜色为灰度
-    if (img.channels() == 1) {
-        cv::cvtColor(paperBackground, paperBackground, cv::COLOR_BGR2GRAY);
+    const int channels = (image.format() == QImage::Format_Grayscale8) ? 1 : 3;
+    const int width = image.width();
+    const int rowBytes = width * channels;
+    const cv::Size size(width, image.height());
+
+    // 纸张颜色（BGR → 图像字节顺序；灰度图按 BT.601 换算）
+    const cv::Vec3b& color = m_options.paperColor;
+    uchar paperPixel[3] = { color[2], color[1], color[0] };
+    if (channels == 1) {
+        paperPixel[0] = cv::saturate_cast<uchar>(0.114 * color[0] + 0.587 * color[1] + 0.299 * color[2]);
     }
 
-    cv::Mat intensityMask;
-    if (m_options.useProgressiveIntensity) {
-        intensityMask = createProgressiveIntensityMask(img.size());
+    std::vector<uchar> paperRow(rowBytes);
+    for (int i = 0; i < rowBytes; ++i) {
+        paperRow[i] = paperPixel[i % channels];
     }
 
-    // 归一化遮罩到 0-1 范围
-    cv::Mat maskFloat;
-    textMask.convertTo(maskFloat, CV_32F, 1.0/255.0);
-
-    // 分通道混合
-    if (img.channels() == 3) {
-        std::vector<cv::Mat> channels(3);
-        std::vector<cv::Mat> bgChannels(3);
-        cv::split(img, channels);
-        cv::split(paperBackground, bgChannels);
-
-        for (int i = 0; i < 3; i++) {
-            channels[i].convertTo(channels[i], CV_32F);
-            bgChannels[i].convertTo(bgChannels[i], CV_32F);
-
-            // 根据是否使用渐进式强度，计算混合权重
-            cv::Mat blendWeight;
-            if (m_options.useProgressiveIntensity) {
-                blendWeight = intensityMask.mul(maskFloat);
-            } else {
-                blendWeight = maskFloat * m_options.colorIntensity;
-            }
+    // 着色强度：渐进式时距离平方拆成列分量 + 行分量（已按强度表量化），逐像素只需一次查表
+    const bool progressive = m_options.useProgressiveIntensity;
+    const int constantIntensity = cvRound(std::clamp(m_options.colorIntensity, 0.0, 1.0) * 255.0);
+    const double centerX = size.width / 2.0;
+    const double centerY = size.height / 2.0;
+    const double distanceScale = INTENSITY_TABLE_SIZE / (centerX * centerX + centerY * centerY);
+
+    std::vector<int> columnTerm;
+    if (progressive) {
+        columnTerm.resize(width);
+        for (int x = 0; x < width; ++x) {
+            const double dx = x - centerX;
+            columnTerm[x] = cvRound(dx * dx * distanceScale);
+        }
+    }
 
-            // 文字区域(mask=0)保持原图，背景区域(mask=1)使用纸张色
-            channels[i] = channels[i].mul(1.0 - blendWeight) + bgChannels[i].mul(blendWeight);
-            channels[i].convertTo(channels[i], CV_8U);
+    // 纹理强度（Q8 定点），纹理按坐标取模平铺
+    const cv::Mat* texture = nullptr;
+    int textureQ8 = 0;
+    if (m_options.enablePaperTexture) {
+        texture = &paperTextureTile();
+        textureQ8 = cvRound(std::clamp(m_options.textureIntensity, 0.0, 1.0) * 256.0);
+    }
+    constexpr int tileMask = TEXTURE_TILE_SIZE - 1;
+
+    std::vector<uchar> weightRow(rowBytes);
+    std::vector<uchar> addRow(rowBytes, 0);
+
+    for (int y = 0; y < size.height; ++y) {
+        const uchar* mask = textMask.ptr<uchar>(y);
+        const uchar* noise = texture ? texture->ptr<uchar>(y & tileMask) : nullptr;
+        int rowTerm = 0;
+        if (progressive) {
+            const double dy = y - centerY;
+            rowTerm = cvRound(dy * dy * distanceScale);
         }
-        cv::merge(channels, img);
-    } else {
-        cv::Mat imgFloat, bgFloat;
-        img.convertTo(imgFloat, CV_32F);
-        paperBackground.convertTo(bgFloat, CV_32F);
-
-        cv::Mat blendWeight;
-        if (m_options.useProgressiveIntensity) {
-            blendWeight = intensityMask.mul(maskFloat);
-        } else {
-            blendWeight = maskFloat * m_options.colorIntensity;
+
+        // 逐像素权重：文字区域(mask=0)保持原图，背景区域(mask=255)按强度着色并叠加纹理
+        uchar* w = weightRow.data();
+        uchar* a = addRow.data();
+        for (int x = 0; x < width; ++x) {
+            const int m = mask[x];
+            const int level = progressive
+                ? m_intensityTable[std::min(columnTerm[x] + rowTerm, int(INTENSITY_TABLE_SIZE))]
+                : constantIntensity;
+            const uchar pixelWeight = static_cast<uchar>(PaperBlend::div255(level * m));
+            const uchar pixelAdd = noise
+                ? static_cast<uchar>((PaperBlend::div255(noise[x & tileMask] * m) * textureQ8 + 128) >> 8)
+                : 0;
+            for (int c = 0; c < channels; ++c) {
+                *w++ = pixelWeight;
+                *a++ = pixelAdd;
+            }
         }
 
-        img = imgFloat.mul(1.0 - blendWeight) + bgFloat.mul(blendWeight);
-        img.convertTo(img, CV_8U);
+        PaperBlend::blendRow(image.scanLine(y), paperRow.data(), weightRow.data(), addRow.data(),
+                             rowBytes);
     }
 }
 
-cv::Mat PaperEffectEnhancer::generatePaperTexture(const cv::Size& size)
+const cv::Mat& PaperEffectEnhancer::paperTextureTile()
 {
-    // 检查缓存
-    if (!m_cachedTexture.empty() && m_cachedTextureSize == size) {
-        return m_cachedTexture.clone();
+    // 只生成一次，与页面尺寸和缩放无关
+    if (!m_textureTile.empty()) {
+        return m_textureTile;
     }
 
-    cv::Mat texture(size, CV_8UC3);
+    cv::Mat texture(TEXTURE_TILE_SIZE, TEXTURE_TILE_SIZE, CV_8UC1);
 
     // 使用随机数生成器
     std::random_device rd;
@@ -297,69 +230,24 @@ cv::Mat PaperEffectEnhancer::generatePaperTexture(const cv::Size& size)
     std::normal_distribution<float> dis(0.0f, 10.0f);  // 均值0，标准差10
 
     // 生成细腻的噪点
-    for (int y = 0; y < size.height; y++) {
-        for (int x = 0; x < size.width; x++) {
+    for (int y = 0; y < TEXTURE_TILE_SIZE; y++) {
+        uchar* row = texture.ptr<uchar>(y);
+        for (int x = 0; x < TEXTURE_TILE_SIZE; x++) {
             float noise = dis(gen);
             // 限制噪点范围在 [-20, 20]
             noise = std::max(-20.0f, std::min(20.0f, noise));
 
-            uchar value = cv::saturate_cast<uchar>(noise);
-            texture.at<cv::Vec3b>(y, x) = cv::Vec3b(value, value, value);
+            row[x] = cv::saturate_cast<uchar>(noise);
         }
     }
 
-    // 轻微模糊，让纹理更自然（模拟纸张纤维）
-    cv::GaussianBlur(texture, texture, cv::Size(3, 3), 0.5);
-
-    // 缓存纹理
-    m_cachedTexture = texture.clone();
-    m_cachedTextureSize = size;
-
-    return texture;
-}
-
-void PaperEffectEnhancer::applyPaperTexture(cv::Mat& img, const cv::Mat& mask)
-{
-    // 生成纹理
-    cv::Mat texture = generatePaperTexture(img.size());
-
-    // 如果是灰度图，转换纹理为灰度
-    if (img.channels() == 1) {
-        cv::cvtColor(texture, texture, cv::COLOR_BGR2GRAY);
-    }
-
-    // 归一化遮罩（只在背景区域应用纹理）
-    cv::Mat maskFloat;
-    mask.convertTo(maskFloat, CV_32F, 1.0/255.0);
-
-    // 转换为浮点数进行混合
-    cv::Mat imgFloat, textureFloat;
-    img.convertTo(imgFloat, CV_32F);
-    texture.convertTo(textureFloat, CV_32F);
-
-    // 纹理强度
-    float intensity = m_options.textureIntensity;
-
-    if (img.channels() == 3) {
-        std::vector<cv::Mat> imgChannels(3);
-        std::vector<cv::Mat> texChannels(3);
-        cv::split(imgFloat, imgChannels);
-        cv::split(textureFloat, texChannels);
-
-        for (int i = 0; i < 3; i++) {
-            // 只在背景区域（mask=1）添加纹理
-            cv::Mat textureContribution = texChannels[i].mul(maskFloat) * intensity;
-            imgChannels[i] = imgChannels[i] + textureContribution;
-        }
-
-        cv::merge(imgChannels, imgFloat);
-    } else {
-        cv::Mat textureContribution = textureFloat.mul(maskFloat) * intensity;
-        imgFloat = imgFloat + textureContribution;
-    }
+    // 轻微模糊，让纹理更自然（模拟纸张纤维）；按环绕方式扩边后再模糊，平铺时没有接缝
+    cv::Mat padded;
+    cv::copyMakeBorder(texture, padded, 1, 1, 1, 1, cv::BORDER_WRAP);
+    cv::GaussianBlur(padded, padded, cv::Size(3, 3), 0.5);
+    m_textureTile = padded(cv::Rect(1, 1, TEXTURE_TILE_SIZE, TEXTURE_TILE_SIZE)).clone();
 
-    // 转换回8位
-    imgFloat.convertTo(img, CV_8U);
+    return m_textureTile;
 }
 
 void PaperEffectEnhancer::featherMask(cv::Mat& mask, int radius)
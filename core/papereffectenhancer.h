@@ -4,6 +4,7 @@
 #include <opencv2/opencv.hpp>
 #include <QImage>
 #include <QMutex>
+#include <vector>
 
 struct AdvancedOptions {
     bool enabled = true;
@@ -82,33 +83,39 @@ public:
     AdvancedOptions options() const { return m_options; }
 
 private:
-    // 格式转换
-    cv::Mat qImageToCvMat(const QImage& image);
-    QImage cvMatToQImage(const cv::Mat& mat);
-
     // 核心处理函数
-    cv::Mat createTextMask(const cv::Mat& img);
-    void applyPaperBackground(cv::Mat& img, const cv::Mat& textMask);
+    cv::Mat createTextMask(const cv::Mat& gray);
     void featherMask(cv::Mat& mask, int radius);
 
+    /**
+     * @brief 叠加纸张层：背景着色与纹理在一次逐行遍历中完成
+     *
+     * 权重按 8 位定点计算，混合在 16 位整数通道上进行（PaperBlend::blendRow，SSE2，其余走标量），
+     * 不再分离通道或分配整页大小的浮点矩阵。
+     * @param image RGB888 或 Grayscale8 图像（原地修改）
+     * @param textMask 文字遮罩（0=文字, 255=背景）
+     */
+    void applyPaperLayer(QImage& image, const cv::Mat& textMask);
+
     // 1. 自适应阈值计算
     int calculateAdaptiveThreshold(const cv::Mat& gray);
 
-    // 2. 生成纸张纹理
-    cv::Mat generatePaperTexture(const cv::Size& size);
-    void applyPaperTexture(cv::Mat& img, const cv::Mat& mask);
+    // 2. 纸张纹理：首次使用时生成一块可平铺的噪点，渲染时按坐标取模平铺
+    const cv::Mat& paperTextureTile();
 
     // 3. 检测文字边缘
     cv::Mat detectTextEdges(const cv::Mat& gray);
 
-    // 4. 创建渐进式强度遮罩
-    cv::Mat createProgressiveIntensityMask(const cv::Size& size);
+    // 4. 渐进式强度：按归一化距离平方查表（选项变化时重建），渲染时不再逐像素开方
+    void rebuildIntensityTable();
+
+    static constexpr int TEXTURE_TILE_SIZE = 256;       // 纹理块边长（2 的幂，便于取模）
+    static constexpr int INTENSITY_TABLE_SIZE = 4096;   // 距离平方的量化级数
 
     AdvancedOptions m_options;
 
-    // 纹理缓存（避免重复生成）
-    cv::Mat m_cachedTexture;
-    cv::Size m_cachedTextureSize;
+    cv::Mat m_textureTile;                  // 可平铺纹理（CV_8UC1，与页面尺寸无关）
+    std::vector<uchar> m_intensityTable;    // 距离平方 → 着色强度（255 = 1.0）
 };
 
 #endif // PAPEREFFECTENHANCER_ADVANCED_H
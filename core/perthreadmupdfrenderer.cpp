@@ -1,14 +1,21 @@
 #include "perthreadmupdfrenderer.h"
+#include "textfolding.h"
+#include "appconfig.h"
 #include <QDebug>
+#include <QPainter>
 #include <QThread>
+#include <QTransform>
 #include <cstring>
+#include <algorithm>
+
+#include <mupdf/pdf.h>
 
 
 PerThreadMuPDFRenderer::PerThreadMuPDFRenderer()
     : m_context(nullptr)
     , m_document(nullptr)
     , m_pageCount(0)
-    , m_paperEffectEnabled(false)
+    , m_displayListClock(0)
 {
 }
 
@@ -17,7 +24,7 @@ PerThreadMuPDFRenderer::PerThreadMuPDFRenderer(const QString& documentPath)
     , m_context(nullptr)
     , m_document(nullptr)
     , m_pageCount(0)
-    , m_paperEffectEnabled(false)
+    , m_displayListClock(0)
 {
     if (!createContext()) {
         qCritical() << "PerThreadMuPDFRenderer: Failed to initialize context";
@@ -53,6 +60,8 @@ PerThreadMuPDFRenderer::PerThreadMuPDFRenderer(const QString& documentPath)
 
 PerThreadMuPDFRenderer::~PerThreadMuPDFRenderer()
 {
+    clearDisplayLists();
+
     if (isDocumentLoaded()) {
         if (m_document && m_context) {
             fz_drop_document(m_context, m_document);
@@ -114,6 +123,8 @@ void PerThreadMuPDFRenderer::destroyContext()
         return;
     }
 
+    clearDisplayLists();
+
     // 销毁 context
     fz_drop_context(m_context);
     m_context = nullptr;
@@ -312,12 +323,6 @@ RenderResult PerThreadMuPDFRenderer::renderPage(int pageIndex, double zoom, int
 
         result.image = pixmapToQImage(m_context, pixmap);
 
-        // ============ 添加纸质增强处理 ============
-        if (m_paperEffectEnabled && !result.image.isNull()) {
-            result.image = m_paperEffectEnhancer.enhance(result.image);
-        }
-        // ========================================
-
         result.success = true;
 
         fz_close_device(m_context, device);
@@ -336,12 +341,620 @@ RenderResult PerThreadMuPDFRenderer::renderPage(int pageIndex, double zoom, int
 
     return result;
 }
-void PerThreadMuPDFRenderer::setPaperEffectEnabled(bool enabled)
+namespace {
+
+/**
+ * @brief 缩略图用的像素图转换：灰度保持 8 位，其余转为 RGB；带透明通道时放弃
+ */
+QImage pixmapToThumbnailImage(fz_context* ctx, fz_pixmap* pixmap)
+{
+    if (!pixmap || fz_pixmap_alpha(ctx, pixmap)) {
+        return QImage();
+    }
+
+    const int width = fz_pixmap_width(ctx, pixmap);
+    const int height = fz_pixmap_height(ctx, pixmap);
+    const int components = fz_pixmap_components(ctx, pixmap);
+
+    if (components == 1) {
+        QImage image(width, height, QImage::Format_Grayscale8);
+        const int stride = fz_pixmap_stride(ctx, pixmap);
+        const unsigned char* samples = fz_pixmap_samples(ctx, pixmap);
+        for (int y = 0; y < height; ++y) {
+            memcpy(image.scanLine(y), samples + y * stride, width);
+        }
+        return image;
+    }
+
+    if (components == 3 && fz_colorspace_is_rgb(ctx, fz_pixmap_colorspace(ctx, pixmap))) {
+        return pixmapToQImage(ctx, pixmap);
+    }
+
+    // CMYK、Lab 等先转换到 RGB
+    fz_pixmap* rgb = fz_convert_pixmap(ctx, pixmap, fz_device_rgb(ctx), nullptr, nullptr,
+                                       fz_default_color_params, 0);
+    QImage image = pixmapToQImage(ctx, rgb);
+    fz_drop_pixmap(ctx, rgb);
+    return image;
+}
+
+QImage rotateThumbnail(const QImage& image, int rotation)
+{
+    int normalized = rotation % 360;
+    if (normalized < 0) normalized += 360;
+    if (normalized == 0 || image.isNull()) {
+        return image;
+    }
+    return image.transformed(QTransform().rotate(normalized));
+}
+
+/**
+ * @brief 单图像页探测设备：记录唯一一张图像，出现其他可见内容即中止
+ *
+ * 图像之前的填充路径（常见的白色底）允许存在，只要最终被图像完全覆盖；
+ * 不可见文字（扫描件的 OCR 文本层）不影响判断
+ */
+struct ImageProbeDevice
+{
+    fz_device super;
+    fz_cookie* cookie;
+    fz_image* image;
+    fz_matrix ctm;
+    fz_rect pathBounds;     // 图像之前的填充路径范围
+    int imageCount;
+    bool mixed;
+};
+
+void markMixed(fz_device* dev)
+{
+    ImageProbeDevice* probe = reinterpret_cast<ImageProbeDevice*>(dev);
+    probe->mixed = true;
+    probe->cookie->abort = 1;
+}
+
+void imageProbeFillPath(fz_context* ctx, fz_device* dev, const fz_path* path, int, fz_matrix ctm,
+                        fz_colorspace*, const float*, float, fz_color_params)
+{
+    ImageProbeDevice* probe = reinterpret_cast<ImageProbeDevice*>(dev);
+    if (probe->imageCount > 0) {
+        markMixed(dev);
+        return;
+    }
+    probe->pathBounds = fz_union_rect(probe->pathBounds, fz_bound_path(ctx, path, nullptr, ctm));
+}
+
+void imageProbeStrokePath(fz_context*, fz_device* dev, const fz_path*, const fz_stroke_state*,
+                          fz_matrix, fz_colorspace*, const float*, float, fz_color_params)
+{
+    markMixed(dev);
+}
+
+void imageProbeFillText(fz_context*, fz_device* dev, const fz_text*, fz_matrix,
+                        fz_colorspace*, const float*, float, fz_color_params)
+{
+    markMixed(dev);
+}
+
+void imageProbeStrokeText(fz_context*, fz_device* dev, const fz_text*, const fz_stroke_state*,
+                          fz_matrix, fz_colorspace*, const float*, float, fz_color_params)
+{
+    markMixed(dev);
+}
+
+void imageProbeClipText(fz_context*, fz_device* dev, const fz_text*, fz_matrix, fz_rect)
+{
+    markMixed(dev);
+}
+
+void imageProbeClipStrokeText(fz_context*, fz_device* dev, const fz_text*,
+                              const fz_stroke_state*, fz_matrix, fz_rect)
+{
+    markMixed(dev);
+}
+
+void imageProbeFillShade(fz_context*, fz_device* dev, fz_shade*, fz_matrix, float, fz_color_params)
+{
+    markMixed(dev);
+}
+
+void imageProbeFillImageMask(fz_context*, fz_device* dev, fz_image*, fz_matrix,
+                             fz_colorspace*, const float*, float, fz_color_params)
+{
+    markMixed(dev);
+}
+
+void imageProbeClipImageMask(fz_context*, fz_device* dev, fz_image*, fz_matrix, fz_rect)
+{
+    markMixed(dev);
+}
+
+void imageProbeFillImage(fz_context* ctx, fz_device* dev, fz_image* image, fz_matrix ctm,
+                         float alpha, fz_color_params)
+{
+    ImageProbeDevice* probe = reinterpret_cast<ImageProbeDevice*>(dev);
+    if (probe->imageCount > 0 || alpha < 1.0f) {
+        markMixed(dev);
+        return;
+    }
+    probe->image = fz_keep_image(ctx, image);
+    probe->ctm = ctm;
+    probe->imageCount = 1;
+}
+
+/**
+ * @brief 颜色探测设备：遇到第一个彩色绘制即中止，用于判断页面能否渲染为灰度图
+ *
+ * 只看绘制操作声明的颜色和图像色彩空间，不解码图像；RGB/CMYK 图像一律视为彩色。
+ * 只有 DeviceGray / ICC 灰度算作灰色：单通道的 Separation（专色）可能是彩色，
+ * Indexed 要看调色板的颜色
+ */
+struct ColorProbeDevice
+{
+    fz_device super;
+    fz_cookie* cookie;
+    bool color;
+};
+
+bool isGrayRgb(const float* rgb)
+{
+    return qAbs(rgb[0] - rgb[1]) < 0.01f && qAbs(rgb[1] - rgb[2]) < 0.01f;
+}
+
+// 其他色彩空间（Indexed、Separation、DeviceN、Lab 等）转换到 RGB 后比较，转换失败视为彩色
+bool isGrayAfterConversion(fz_context* ctx, fz_colorspace* colorspace, const float* color)
+{
+    float rgb[3] = {0, 0, 0};
+    fz_try(ctx) {
+        fz_convert_color(ctx, colorspace, color, fz_device_rgb(ctx), rgb, nullptr,
+                         fz_default_color_params);
+    }
+    fz_catch(ctx) {
+        return false;
+    }
+    return isGrayRgb(rgb);
+}
+
+bool isGrayColor(fz_context* ctx, fz_colorspace* colorspace, const float* color)
+{
+    if (!colorspace || fz_colorspace_is_gray(ctx, colorspace)) {
+        return true;
+    }
+    if (fz_colorspace_is_rgb(ctx, colorspace)) {
+        return isGrayRgb(color);
+    }
+    if (fz_colorspace_is_cmyk(ctx, colorspace)) {
+        return color[0] < 0.01f && color[1] < 0.01f && color[2] < 0.01f;
+    }
+    return isGrayAfterConversion(ctx, colorspace, color);
+}
+
+// 图像只看色彩空间：灰度、基色为灰度或调色板全为灰色的 Indexed 算作灰色，
+// Separation/DeviceN 等逐像素才能确定的一律视为彩色
+bool isGrayImageColorspace(fz_context* ctx, fz_colorspace* colorspace)
+{
+    if (!colorspace || fz_colorspace_is_gray(ctx, colorspace)) {
+        return true;
+    }
+    if (!fz_colorspace_is_indexed(ctx, colorspace)) {
+        return false;
+    }
+
+    fz_colorspace* base = fz_base_colorspace(ctx, colorspace);
+    if (base && fz_colorspace_is_gray(ctx, base)) {
+        return true;
+    }
+
+    // 直接检查调色板（0..high 项，每项为 base 色彩空间的 n 个字节），不逐项走颜色转换
+    const int high = colorspace->u.indexed.high;
+    const unsigned char* lookup = colorspace->u.indexed.lookup;
+    const int n = base ? fz_colorspace_n(ctx, base) : 0;
+    if (!lookup || n <= 0 || n > FZ_MAX_COLORS) {
+        return false;
+    }
+
+    float entry[FZ_MAX_COLORS];
+    for (int index = 0; index <= high; ++index) {
+        const unsigned char* components = lookup + index * n;
+        for (int k = 0; k < n; ++k) {
+            entry[k] = components[k] / 255.0f;
+        }
+        if (!isGrayColor(ctx, base, entry)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void probeColor(fz_context* ctx, fz_device* dev, fz_colorspace* colorspace, const float* color)
+{
+    ColorProbeDevice* probe = reinterpret_cast<ColorProbeDevice*>(dev);
+    if (!probe->color && !isGrayColor(ctx, colorspace, color)) {
+        probe->color = true;
+        probe->cookie->abort = 1;
+    }
+}
+
+void colorProbeFillPath(fz_context* ctx, fz_device* dev, const fz_path*, int, fz_matrix,
+                        fz_colorspace* colorspace, const float* color, float, fz_color_params)
+{
+    probeColor(ctx, dev, colorspace, color);
+}
+
+void colorProbeStrokePath(fz_context* ctx, fz_device* dev, const fz_path*, const fz_stroke_state*,
+                          fz_matrix, fz_colorspace* colorspace, const float* color, float,
+                          fz_color_params)
+{
+    probeColor(ctx, dev, colorspace, color);
+}
+
+void colorProbeFillText(fz_context* ctx, fz_device* dev, const fz_text*, fz_matrix,
+                        fz_colorspace* colorspace, const float* color, float, fz_color_params)
+{
+    probeColor(ctx, dev, colorspace, color);
+}
+
+void colorProbeStrokeText(fz_context* ctx, fz_device* dev, const fz_text*, const fz_stroke_state*,
+                          fz_matrix, fz_colorspace* colorspace, const float* color, float,
+                          fz_color_params)
+{
+    probeColor(ctx, dev, colorspace, color);
+}
+
+void colorProbeFillImageMask(fz_context* ctx, fz_device* dev, fz_image*, fz_matrix,
+                             fz_colorspace* colorspace, const float* color, float, fz_color_params)
+{
+    probeColor(ctx, dev, colorspace, color);
+}
+
+void colorProbeFillShade(fz_context*, fz_device* dev, fz_shade*, fz_matrix, float, fz_color_params)
+{
+    ColorProbeDevice* probe = reinterpret_cast<ColorProbeDevice*>(dev);
+    probe->color = true;
+    probe->cookie->abort = 1;
+}
+
+void colorProbeFillImage(fz_context* ctx, fz_device* dev, fz_image* image, fz_matrix,
+                         float, fz_color_params)
+{
+    ColorProbeDevice* probe = reinterpret_cast<ColorProbeDevice*>(dev);
+    if (!isGrayImageColorspace(ctx, image->colorspace)) {
+        probe->color = true;
+        probe->cookie->abort = 1;
+    }
+}
+
+} // namespace
+
+RenderResult PerThreadMuPDFRenderer::renderThumbnail(int pageIndex, int targetWidth, int rotation,
+                                                     ThumbnailSource* source)
+{
+    if (isDocumentLoaded() && pageIndex >= 0 && pageIndex < m_pageCount && targetWidth > 0) {
+        ThumbnailSource from = ThumbnailSource::Embedded;
+        QImage image = loadEmbeddedThumbnail(pageIndex, targetWidth);
+        if (image.isNull()) {
+            from = ThumbnailSource::ImageDecode;
+            image = decodeSingleImagePage(pageIndex, targetWidth);
+        }
+
+        if (!image.isNull()) {
+            if (source) *source = from;
+
+            RenderResult result;
+            result.image = rotateThumbnail(image, rotation);
+            result.success = true;
+            return result;
+        }
+    }
+
+    if (source) *source = ThumbnailSource::Render;
+
+    RenderResult result;
+    if (!isDocumentLoaded() || pageIndex < 0 || pageIndex >= m_pageCount || targetWidth <= 0) {
+        result.errorMessage = QString("Invalid thumbnail request for page %1").arg(pageIndex);
+        return result;
+    }
+
+    result.image = renderThumbnailPage(pageIndex, targetWidth, rotation);
+    result.success = !result.image.isNull();
+    if (!result.success) {
+        result.errorMessage = getLastError();
+    }
+    return result;
+}
+
+QImage PerThreadMuPDFRenderer::loadEmbeddedThumbnail(int pageIndex, int targetWidth)
+{
+    pdf_document* pdfDoc = pdf_specifics(m_context, m_document);
+    const QSizeF size = pageSize(pageIndex);
+    if (!pdfDoc || size.isEmpty()) {
+        return QImage();
+    }
+
+    QImage image;
+    fz_image* thumb = nullptr;
+    fz_pixmap* pixmap = nullptr;
+
+    fz_var(thumb);
+    fz_var(pixmap);
+
+    fz_try(m_context) {
+        pdf_obj* pageObj = pdf_lookup_page_obj(m_context, pdfDoc, pageIndex);
+        pdf_obj* thumbObj = pdf_dict_gets(m_context, pageObj, "Thumb");
+        if (pdf_is_stream(m_context, thumbObj)) {
+            thumb = pdf_load_image(m_context, pdfDoc, thumbObj);
+            int width = thumb->w;
+            int height = thumb->h;
+            pixmap = fz_get_pixmap_from_image(m_context, thumb, nullptr, nullptr, &width, &height);
+            image = pixmapToThumbnailImage(m_context, pixmap);
+        }
+    }
+    fz_always(m_context) {
+        fz_drop_pixmap(m_context, pixmap);
+        fz_drop_image(m_context, thumb);
+    }
+    fz_catch(m_context) {
+        image = QImage();
+    }
+
+    if (image.isNull()) {
+        return image;
+    }
+
+    // 太小放大后模糊；比例与页面不符说明缩略图已过期（页面被裁切或替换过）
+    const double pageAspect = size.height() / size.width();
+    const double thumbAspect = double(image.height()) / image.width();
+    if (image.width() < targetWidth * AppConfig::instance().thumbnailEmbeddedMinScale() ||
+        qAbs(thumbAspect - pageAspect) > pageAspect * 0.05) {
+        return QImage();
+    }
+
+    return image.scaledToWidth(targetWidth, Qt::SmoothTransformation);
+}
+
+QImage PerThreadMuPDFRenderer::decodeSingleImagePage(int pageIndex, int targetWidth)
+{
+    QImage canvas;
+    fz_page* page = nullptr;
+    ImageProbeDevice* device = nullptr;
+    fz_pixmap* pixmap = nullptr;
+    fz_cookie cookie = {};
+
+    fz_var(page);
+    fz_var(device);
+    fz_var(pixmap);
+
+    fz_try(m_context) {
+        page = fz_load_page(m_context, m_document, pageIndex);
+        const fz_rect bounds = fz_bound_page(m_context, page);
+
+        // 只解释内容流，不解码图像
+        device = fz_new_derived_device(m_context, ImageProbeDevice);
+        device->super.fill_path = imageProbeFillPath;
+        device->super.stroke_path = imageProbeStrokePath;
+        device->super.fill_text = imageProbeFillText;
+        device->super.stroke_text = imageProbeStrokeText;
+        device->super.clip_text = imageProbeClipText;
+        device->super.clip_stroke_text = imageProbeClipStrokeText;
+        device->super.fill_shade = imageProbeFillShade;
+        device->super.fill_image = imageProbeFillImage;
+        device->super.fill_image_mask = imageProbeFillImageMask;
+        device->super.clip_image_mask = imageProbeClipImageMask;
+        device->cookie = &cookie;
+        device->image = nullptr;
+        device->ctm = fz_identity;
+        device->pathBounds = fz_empty_rect;
+        device->imageCount = 0;
+        device->mixed = false;
+
+        fz_run_page(m_context, page, &device->super, fz_identity, &cookie);
+        fz_close_device(m_context, &device->super);
+
+        const fz_matrix ctm = device->ctm;
+        const fz_rect imageRect = fz_transform_rect(fz_unit_rect, ctm);
+        const fz_rect visible = fz_intersect_rect(imageRect, bounds);
+        const float pageArea = (bounds.x1 - bounds.x0) * (bounds.y1 - bounds.y0);
+        const float visibleArea = fz_is_empty_rect(visible)
+            ? 0.0f : (visible.x1 - visible.x0) * (visible.y1 - visible.y0);
+
+        // 只处理不旋转、不翻转、铺满页面且盖住底色的单张图像
+        const bool usable = !device->mixed && device->image &&
+                            ctm.b == 0 && ctm.c == 0 && ctm.a > 0 && ctm.d > 0 &&
+                            pageArea > 0 &&
+                            visibleArea >= pageArea * AppConfig::instance().thumbnailImagePageCoverage() &&
+                            (fz_is_empty_rect(device->pathBounds) ||
+                             fz_contains_rect(fz_expand_rect(imageRect, 1), device->pathBounds));
+
+        if (usable) {
+            const float zoom = targetWidth / (bounds.x1 - bounds.x0);
+            int width = qMax(1, qRound(ctm.a * zoom));
+            int height = qMax(1, qRound(ctm.d * zoom));
+
+            // 传入目标尺寸，解码器按 2 的幂次降采样（JPEG 直接在 DCT 阶段缩小）
+            fz_matrix scaled = fz_scale(width, height);
+            pixmap = fz_get_pixmap_from_image(m_context, device->image, nullptr, &scaled, &width, &height);
+            QImage decoded = pixmapToThumbnailImage(m_context, pixmap);
+
+            if (!decoded.isNull()) {
+                const QRectF target((imageRect.x0 - bounds.x0) * zoom,
+                                    (imageRect.y0 - bounds.y0) * zoom,
+                                    (imageRect.x1 - imageRect.x0) * zoom,
+                                    (imageRect.y1 - imageRect.y0) * zoom);
+
+                canvas = QImage(targetWidth, qMax(1, qRound((bounds.y1 - bounds.y0) * zoom)),
+                                QImage::Format_RGB888);
+                canvas.fill(Qt::white);
+
+                QPainter painter(&canvas);
+                painter.setRenderHint(QPainter::SmoothPixmapTransform);
+                painter.drawImage(target, decoded);
+            }
+        }
+    }
+    fz_always(m_context) {
+        fz_drop_pixmap(m_context, pixmap);
+        if (device) {
+            fz_drop_image(m_context, device->image);
+            fz_drop_device(m_context, &device->super);
+        }
+        fz_drop_page(m_context, page);
+    }
+    fz_catch(m_context) {
+        // 发现其他内容后中止解释，部分版本会抛出 abort 错误
+        canvas = QImage();
+    }
+
+    return canvas;
+}
+
+QImage PerThreadMuPDFRenderer::renderThumbnailPage(int pageIndex, int targetWidth, int rotation)
+{
+    QImage image;
+    fz_display_list* list = nullptr;
+    ColorProbeDevice* probe = nullptr;
+    fz_device* device = nullptr;
+    fz_pixmap* pixmap = nullptr;
+    fz_cookie cookie = {};
+    const int savedAALevel = fz_aa_level(m_context);
+
+    fz_var(list);
+    fz_var(probe);
+    fz_var(device);
+    fz_var(pixmap);
+
+    fz_try(m_context) {
+        list = displayListFor(pageIndex);
+        const fz_rect bounds = fz_bound_display_list(m_context, list);
+        const float pageWidth = bounds.x1 - bounds.x0;
+        if (pageWidth <= 0) {
+            fz_throw(m_context, FZ_ERROR_GENERIC, "empty page");
+        }
+
+        // 先遍历一次 display list 判断是否只有灰色内容（不做光栅化）
+        probe = fz_new_derived_device(m_context, ColorProbeDevice);
+        probe->super.fill_path = colorProbeFillPath;
+        probe->super.stroke_path = colorProbeStrokePath;
+        probe->super.fill_text = colorProbeFillText;
+        probe->super.stroke_text = colorProbeStrokeText;
+        probe->super.fill_shade = colorProbeFillShade;
+        probe->super.fill_image = colorProbeFillImage;
+        probe->super.fill_image_mask = colorProbeFillImageMask;
+        probe->cookie = &cookie;
+        probe->color = false;
+
+        fz_run_display_list(m_context, list, &probe->super, fz_identity, fz_infinite_rect, &cookie);
+        fz_close_device(m_context, &probe->super);
+        const bool gray = !probe->color;
+
+        const fz_matrix matrix = calculateMatrixForMuPDF(targetWidth / pageWidth, rotation);
+        const fz_irect bbox = fz_round_rect(fz_transform_rect(bounds, matrix));
+
+        pixmap = fz_new_pixmap_with_bbox(
+            m_context,
+            gray ? fz_device_gray(m_context) : fz_device_rgb(m_context),
+            bbox,
+            nullptr,
+            0
+            );
+        fz_clear_pixmap_with_value(m_context, pixmap, 0xff);
+
+        fz_set_aa_level(m_context, AppConfig::instance().thumbnailAALevel());
+        device = fz_new_draw_device(m_context, fz_identity, pixmap);
+        fz_run_display_list(m_context, list, device, matrix, fz_infinite_rect, nullptr);
+        fz_close_device(m_context, device);
+
+        image = pixmapToThumbnailImage(m_context, pixmap);
+    }
+    fz_always(m_context) {
+        fz_set_aa_level(m_context, savedAALevel);
+        fz_drop_device(m_context, device);
+        if (probe) {
+            fz_drop_device(m_context, &probe->super);
+        }
+        fz_drop_pixmap(m_context, pixmap);
+        fz_drop_display_list(m_context, list);
+    }
+    fz_catch(m_context) {
+        QString err = QString("Failed to render thumbnail for page %1: %2")
+        .arg(pageIndex)
+            .arg(fz_caught_message(m_context));
+        setLastError(err);
+        qWarning() << "PerThreadMuPDFRenderer:" << err;
+        image = QImage();
+    }
+
+    return image;
+}
+
+fz_display_list* PerThreadMuPDFRenderer::displayListFor(int pageIndex)
+{
+    auto it = m_displayLists.find(pageIndex);
+    if (it != m_displayLists.end()) {
+        it->lastUse = ++m_displayListClock;
+        return fz_keep_display_list(m_context, it->list);
+    }
+
+    fz_display_list* list = nullptr;
+    fz_page* page = fz_load_page(m_context, m_document, pageIndex);
+    fz_try(m_context) {
+        list = fz_new_display_list_from_page(m_context, page);
+    }
+    fz_always(m_context) {
+        fz_drop_page(m_context, page);
+    }
+    fz_catch(m_context) {
+        fz_rethrow(m_context);
+    }
+
+    // 超出容量时丢弃最久未用的
+    const int capacity = AppConfig::instance().thumbnailDisplayListCacheSize();
+    while (!m_displayLists.isEmpty() && m_displayLists.size() >= capacity) {
+        auto victim = m_displayLists.begin();
+        for (auto candidate = m_displayLists.begin(); candidate != m_displayLists.end(); ++candidate) {
+            if (candidate->lastUse < victim->lastUse) {
+                victim = candidate;
+            }
+        }
+        fz_drop_display_list(m_context, victim->list);
+        m_displayLists.erase(victim);
+    }
+
+    if (capacity > 0) {
+        CachedDisplayList entry;
+        entry.list = fz_keep_display_list(m_context, list);
+        entry.lastUse = ++m_displayListClock;
+        m_displayLists.insert(pageIndex, entry);
+    }
+
+    return list;
+}
+
+void PerThreadMuPDFRenderer::clearDisplayLists()
+{
+    if (m_context) {
+        for (const CachedDisplayList& entry : std::as_const(m_displayLists)) {
+            fz_drop_display_list(m_context, entry.list);
+        }
+    }
+    m_displayLists.clear();
+}
+
+bool PerThreadMuPDFRenderer::extractText(int pageIndex, PageTextData& outData, QString* errorMsg,
+                                         TextExtractDetail detail)
+{
+    return loadPageContent(pageIndex, outData, nullptr, detail, errorMsg);
+}
+
+bool PerThreadMuPDFRenderer::analyzePage(int pageIndex, PageTextData& outText,
+                                         PageAnalysis& outAnalysis,
+                                         TextExtractDetail detail, QString* errorMsg)
 {
-    m_paperEffectEnabled = enabled;
+    outAnalysis = PageAnalysis();
+    return loadPageContent(pageIndex, outText, &outAnalysis, detail, errorMsg);
 }
 
-bool PerThreadMuPDFRenderer::extractText(int pageIndex, PageTextData& outData, QString* errorMsg)
+bool PerThreadMuPDFRenderer::loadPageContent(int pageIndex, PageTextData& outData,
+                                             PageAnalysis* analysis,
+                                             TextExtractDetail detail, QString* errorMsg)
 {
     if (!isDocumentLoaded()) {
         if (errorMsg) *errorMsg = "Document not loaded";
@@ -356,23 +969,32 @@ bool PerThreadMuPDFRenderer::extractText(int pageIndex, PageTextData& outData, Q
     outData = PageTextData();
     outData.pageIndex = pageIndex;
 
+    const bool withCharBoxes = (detail == TextExtractDetail::Full);
+    bool hasImages = false;
+
     fz_stext_page* stext = nullptr;
     fz_page* page = nullptr;
 
     fz_try(m_context) {
-        // 加载页面
+        // 加载页面（分析时尺寸、文本、图像、链接都来自这一次加载）
         page = fz_load_page(m_context, m_document, pageIndex);
 
         // 获取原始边界
         fz_rect bound = fz_bound_page(m_context, page);
 
+        if (analysis) {
+            analysis->pageIndex = pageIndex;
+            analysis->size = QSizeF(bound.x1 - bound.x0, bound.y1 - bound.y0);
+            m_pageSizeCache[pageIndex] = analysis->size;
+        }
+
         // 创建 stext_page
         stext = fz_new_stext_page(m_context, bound);
 
-        // 设置选项
+        // 设置选项（分析时保留图像块用于判断扫描页，图像本身不解码）
         fz_stext_options opts;
         memset(&opts, 0, sizeof(opts));
-        opts.flags = 0;
+        opts.flags = analysis ? FZ_STEXT_PRESERVE_IMAGES : 0;
 
         // 创建设备
         fz_device* dev = fz_new_stext_device(m_context, stext, &opts);
@@ -383,43 +1005,51 @@ bool PerThreadMuPDFRenderer::extractText(int pageIndex, PageTextData& outData, Q
         fz_close_device(m_context, dev);
         fz_drop_device(m_context, dev);
 
-        // 提取文本
+        // 提取文本（直接写入扁平数组，坐标按页面边界量化）
+        outData.bounds = QRectF(bound.x0, bound.y0,
+                                bound.x1 - bound.x0,
+                                bound.y1 - bound.y0);
+
         for (fz_stext_block* block = stext->first_block; block; block = block->next) {
+            if (block->type == FZ_STEXT_BLOCK_IMAGE) {
+                hasImages = true;
+                continue;
+            }
             if (block->type != FZ_STEXT_BLOCK_TEXT) continue;
 
-            TextBlock tb;
-            tb.bbox = QRectF(block->bbox.x0, block->bbox.y0,
-                             block->bbox.x1 - block->bbox.x0,
-                             block->bbox.y1 - block->bbox.y0);
+            outData.beginBlock(QRectF(block->bbox.x0, block->bbox.y0,
+                                      block->bbox.x1 - block->bbox.x0,
+                                      block->bbox.y1 - block->bbox.y0));
 
             for (fz_stext_line* line = block->u.t.first_line; line; line = line->next) {
-                TextLine tl;
-                tl.bbox = QRectF(line->bbox.x0, line->bbox.y0,
-                                 line->bbox.x1 - line->bbox.x0,
-                                 line->bbox.y1 - line->bbox.y0);
+                outData.beginLine(QRectF(line->bbox.x0, line->bbox.y0,
+                                         line->bbox.x1 - line->bbox.x0,
+                                         line->bbox.y1 - line->bbox.y0));
 
-                for (fz_stext_char* ch = line->first_char; ch; ch = ch->next) {
-                    TextChar tc;
-                    tc.character = QChar(ch->c);
+                if (!withCharBoxes) {
+                    for (fz_stext_char* ch = line->first_char; ch; ch = ch->next) {
+                        outData.appendChar(static_cast<char32_t>(ch->c));
+                    }
+                    continue;
+                }
 
+                for (fz_stext_char* ch = line->first_char; ch; ch = ch->next) {
                     fz_quad q = ch->quad;
                     qreal minX = qMin(qMin(q.ul.x, q.ur.x), qMin(q.ll.x, q.lr.x));
                     qreal maxX = qMax(qMax(q.ul.x, q.ur.x), qMax(q.ll.x, q.lr.x));
                     qreal minY = qMin(qMin(q.ul.y, q.ur.y), qMin(q.ll.y, q.lr.y));
                     qreal maxY = qMax(qMax(q.ul.y, q.ur.y), qMax(q.ll.y, q.lr.y));
 
-                    tc.bbox = QRectF(QPointF(minX, minY), QPointF(maxX, maxY));
-
-                    tl.chars.append(tc);
-                    outData.fullText.append(tc.character);
+                    outData.appendChar(static_cast<char32_t>(ch->c),
+                                       QRectF(QPointF(minX, minY), QPointF(maxX, maxY)));
                 }
-
-                tb.lines.append(tl);
-                outData.fullText.append('\n');
             }
+        }
 
-            outData.blocks.append(tb);
-            outData.fullText.append("\n\n");
+        outData.finish();
+
+        if (analysis) {
+            loadLinks(page, analysis->links);
         }
 
         if (stext) fz_drop_stext_page(m_context, stext);
@@ -429,6 +1059,10 @@ bool PerThreadMuPDFRenderer::extractText(int pageIndex, PageTextData& outData, Q
         if (stext) fz_drop_stext_page(m_context, stext);
         if (page) fz_drop_page(m_context, page);
 
+        // 丢弃写了一半的偏移表
+        outData = PageTextData();
+        outData.pageIndex = pageIndex;
+
         if (errorMsg) {
             *errorMsg = QString("Failed to extract text on page %1: %2")
             .arg(pageIndex)
@@ -437,9 +1071,57 @@ bool PerThreadMuPDFRenderer::extractText(int pageIndex, PageTextData& outData, Q
         return false;
     }
 
+    if (analysis) {
+        analysis->hasTextLayer = std::any_of(outData.codepoints.cbegin(), outData.codepoints.cend(),
+                                             [](char32_t c) { return c > 32; });
+        analysis->imageOnly = !analysis->hasTextLayer && hasImages;
+    }
+
+    // 提取时一次性生成折叠影子文本，不敏感搜索无需在查询时做规范化
+    TextFolding::buildFoldedText(outData);
+
     return true;
 }
 
+void PerThreadMuPDFRenderer::loadLinks(fz_page* page, QVector<PDFLink>& outLinks)
+{
+    fz_link* links = nullptr;
+
+    fz_try(m_context) {
+        links = fz_load_links(m_context, page);
+
+        for (fz_link* current = links; current; current = current->next) {
+            PDFLink pdfLink;
+            pdfLink.rect = QRectF(current->rect.x0, current->rect.y0,
+                                  current->rect.x1 - current->rect.x0,
+                                  current->rect.y1 - current->rect.y0);
+
+            if (current->uri) {
+                pdfLink.uri = QString::fromUtf8(current->uri);
+
+                // 解析内部跳转目标，失败时按外部链接处理
+                fz_try(m_context) {
+                    fz_location loc = fz_resolve_link(m_context, m_document, current->uri,
+                                                      nullptr, nullptr);
+                    pdfLink.targetPage = fz_page_number_from_location(m_context, m_document, loc);
+                }
+                fz_catch(m_context) {
+                    pdfLink.targetPage = -1;
+                }
+            }
+
+            outLinks.append(pdfLink);
+        }
+    }
+    fz_always(m_context) {
+        fz_drop_link(m_context, links);
+    }
+    fz_catch(m_context) {
+        // 链接加载失败不影响文本
+        outLinks.clear();
+    }
+}
+
 bool PerThreadMuPDFRenderer::isTextPDF(int samplePages)
 {
     if (!isDocumentLoaded() || m_pageCount == 0) {
@@ -451,50 +1133,181 @@ bool PerThreadMuPDFRenderer::isTextPDF(int samplePages)
         pagesToCheck = m_pageCount;
     }
 
+    const double threshold = AppConfig::TEXT_PDF_THRESHOLD;
     int textPageCount = 0;
 
     for (int i = 0; i < pagesToCheck; ++i) {
-        bool hasText = false;
-
-        fz_try(m_context) {
-            fz_page* page = fz_load_page(m_context, m_document, i);
-            fz_stext_page* stext = fz_new_stext_page(m_context, fz_bound_page(m_context, page));
-            fz_stext_options options = {0};
-            fz_device* device = fz_new_stext_device(m_context, stext, &options);
-            fz_run_page(m_context, page, device, fz_identity, nullptr);
-            fz_close_device(m_context, device);
-            fz_drop_device(m_context, device);
-
-            // 检查是否有文本
-            for (fz_stext_block* block = stext->first_block; block; block = block->next) {
-                if (block->type == FZ_STEXT_BLOCK_TEXT) {
-                    for (fz_stext_line* line = block->u.t.first_line; line; line = line->next) {
-                        for (fz_stext_char* ch = line->first_char; ch; ch = ch->next) {
-                            if (ch->c > 32) {
-                                hasText = true;
-                                break;
-                            }
-                        }
-                        if (hasText) break;
-                    }
-                    if (hasText) break;
-                }
-            }
+        // 采样页均匀分布在整个文档中（首页、末页和中间），避免只看封面和目录
+        int pageIndex = (pagesToCheck == 1) ? 0
+            : static_cast<int>((static_cast<qint64>(i) * (m_pageCount - 1) + (pagesToCheck - 1) / 2)
+                               / (pagesToCheck - 1));
 
-            fz_drop_stext_page(m_context, stext);
-            fz_drop_page(m_context, page);
-        }
-        fz_catch(m_context) {
-            hasText = false;
+        if (pageMayHaveText(pageIndex) && probePageGlyphs(pageIndex)) {
+            textPageCount++;
         }
 
-        if (hasText) {
-            textPageCount++;
+        // 结果已确定时提前结束：已达到阈值，或剩余页全部有文本也达不到阈值
+        int remaining = pagesToCheck - i - 1;
+        if (textPageCount >= threshold * pagesToCheck) {
+            return true;
+        }
+        if (textPageCount + remaining < threshold * pagesToCheck) {
+            return false;
         }
     }
 
     double ratio = static_cast<double>(textPageCount) / pagesToCheck;
-    return ratio >= 0.3;
+    return ratio >= threshold;
+}
+
+namespace {
+
+/**
+ * @brief 资源字典（及一层 Form XObject）中是否声明了字体
+ */
+bool resourcesHaveFonts(fz_context* ctx, pdf_obj* resources, int depth)
+{
+    if (!resources) {
+        return false;
+    }
+
+    pdf_obj* fonts = pdf_dict_get(ctx, resources, PDF_NAME(Font));
+    if (pdf_is_dict(ctx, fonts) && pdf_dict_len(ctx, fonts) > 0) {
+        return true;
+    }
+
+    if (depth <= 0) {
+        return false;
+    }
+
+    pdf_obj* xobjects = pdf_dict_get(ctx, resources, PDF_NAME(XObject));
+    int count = pdf_dict_len(ctx, xobjects);
+    for (int i = 0; i < count; ++i) {
+        pdf_obj* xobj = pdf_dict_get_val(ctx, xobjects, i);
+        if (pdf_name_eq(ctx, pdf_dict_get(ctx, xobj, PDF_NAME(Subtype)), PDF_NAME(Form))
+            && resourcesHaveFonts(ctx, pdf_dict_get(ctx, xobj, PDF_NAME(Resources)), depth - 1)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 只关心文本的探测设备：遇到第一个可见字形即中止页面解释
+ */
+struct GlyphProbeDevice
+{
+    fz_device super;
+    fz_cookie* cookie;
+    bool found;
+};
+
+void probeText(fz_device* dev, const fz_text* text)
+{
+    GlyphProbeDevice* probe = reinterpret_cast<GlyphProbeDevice*>(dev);
+    for (fz_text_span* span = text->head; span && !probe->found; span = span->next) {
+        for (int i = 0; i < span->len; ++i) {
+            if (span->items[i].ucs > 32) {
+                probe->found = true;
+                probe->cookie->abort = 1;
+                break;
+            }
+        }
+    }
+}
+
+void probeFillText(fz_context*, fz_device* dev, const fz_text* text, fz_matrix,
+                   fz_colorspace*, const float*, float, fz_color_params)
+{
+    probeText(dev, text);
+}
+
+void probeStrokeText(fz_context*, fz_device* dev, const fz_text* text, const fz_stroke_state*,
+                     fz_matrix, fz_colorspace*, const float*, float, fz_color_params)
+{
+    probeText(dev, text);
+}
+
+void probeClipText(fz_context*, fz_device* dev, const fz_text* text, fz_matrix, fz_rect)
+{
+    probeText(dev, text);
+}
+
+void probeClipStrokeText(fz_context*, fz_device* dev, const fz_text* text,
+                         const fz_stroke_state*, fz_matrix, fz_rect)
+{
+    probeText(dev, text);
+}
+
+void probeIgnoreText(fz_context*, fz_device* dev, const fz_text* text, fz_matrix)
+{
+    probeText(dev, text);
+}
+
+} // namespace
+
+bool PerThreadMuPDFRenderer::pageMayHaveText(int pageIndex)
+{
+    pdf_document* pdfDoc = pdf_specifics(m_context, m_document);
+    if (!pdfDoc) {
+        return true;
+    }
+
+    bool result = true;
+    fz_try(m_context) {
+        pdf_obj* pageObj = pdf_lookup_page_obj(m_context, pdfDoc, pageIndex);
+        pdf_obj* annots = pdf_dict_get(m_context, pageObj, PDF_NAME(Annots));
+        pdf_obj* resources = pdf_dict_get_inheritable(m_context, pageObj, PDF_NAME(Resources));
+
+        if (resourcesHaveFonts(m_context, resources, 1)) {
+            // 声明了字体不代表真的画了字，交给字形探测确认
+            result = true;
+        } else {
+            // 注释外观流可能带文字，无法仅凭页面资源判断
+            result = pdf_array_len(m_context, annots) > 0;
+        }
+    }
+    fz_catch(m_context) {
+        result = true;
+    }
+    return result;
+}
+
+bool PerThreadMuPDFRenderer::probePageGlyphs(int pageIndex)
+{
+    bool found = false;
+    fz_page* page = nullptr;
+    GlyphProbeDevice* device = nullptr;
+    fz_cookie cookie = {};
+
+    fz_var(page);
+    fz_var(device);
+
+    fz_try(m_context) {
+        page = fz_load_page(m_context, m_document, pageIndex);
+        device = fz_new_derived_device(m_context, GlyphProbeDevice);
+        device->super.fill_text = probeFillText;
+        device->super.stroke_text = probeStrokeText;
+        device->super.clip_text = probeClipText;
+        device->super.clip_stroke_text = probeClipStrokeText;
+        device->super.ignore_text = probeIgnoreText;
+        device->cookie = &cookie;
+        device->found = false;
+
+        fz_run_page(m_context, page, &device->super, fz_identity, &cookie);
+        fz_close_device(m_context, &device->super);
+    }
+    fz_always(m_context) {
+        if (device) {
+            found = device->found;
+            fz_drop_device(m_context, &device->super);
+        }
+        fz_drop_page(m_context, page);
+    }
+    fz_catch(m_context) {
+        // 中止解释后部分版本会抛出 abort 错误，已找到字形时不算失败
+    }
+    return found;
 }
 
 QString PerThreadMuPDFRenderer::getLastError() const
@@ -5,8 +5,8 @@
 #include <QImage>
 #include <QSizeF>
 #include <QVector>
+#include <QHash>
 #include <QMutex>
-#include "papereffectenhancer.h"
 #include "datastructure.h"
 
 extern "C" {
@@ -14,6 +14,15 @@ extern "C" {
 }
 
 
+/**
+ * @brief 缩略图来源
+ */
+enum class ThumbnailSource {
+    Embedded,       ///< 页面自带的 /Thumb 图像
+    ImageDecode,    ///< 整页只有一张图像，按缩略图尺寸降采样解码
+    Render          ///< 完整渲染页面
+};
+
 /**
  * @brief 线程隔离的MuPDF渲染器
  *
@@ -72,17 +81,54 @@ public:
      */
     RenderResult renderPage(int pageIndex, double zoom, int rotation);
 
+    /**
+     * @brief 生成缩略图
+     *
+     * 依次尝试：页面自带的 /Thumb 图像（足够大且比例与页面一致时）→
+     * 整页只有一张图像的扫描页，按目标尺寸降采样解码该图像 → 渲染页面
+     *
+     * 渲染页面时使用缩略图专用配置：低抗锯齿级别、不加纸质效果、
+     * 只含灰色内容的页面渲染为 8 位灰度图，页面解释结果（display list）缓存复用
+     *
+     * @param pageIndex 页面索引
+     * @param targetWidth 目标宽度（像素，未旋转时的页面宽度）
+     * @param rotation 旋转角度 (0, 90, 180, 270)
+     * @param source 输出：实际使用的来源
+     */
+    RenderResult renderThumbnail(int pageIndex, int targetWidth, int rotation,
+                                 ThumbnailSource* source = nullptr);
+
     /**
      * @brief 提取页面文本
      * @param pageIndex 页面索引
      * @param outData 输出的文本数据
      * @param errorMsg 错误信息输出参数
+     * @param detail TextOnly 时不保存字符边界框（后台预加载、建索引用）
+     * @return 成功返回 true
+     */
+    bool extractText(int pageIndex, PageTextData& outData, QString* errorMsg = nullptr,
+                     TextExtractDetail detail = TextExtractDetail::Full);
+
+    /**
+     * @brief 分析页面：只加载一次页面，同时得到文本、尺寸、链接和扫描页判断
+     * @param pageIndex 页面索引
+     * @param outText 输出的文本数据
+     * @param outAnalysis 输出的尺寸、链接、文本层/纯图像标记
+     * @param detail 文本详细程度
+     * @param errorMsg 错误信息输出参数
      * @return 成功返回 true
      */
-    bool extractText(int pageIndex, PageTextData& outData, QString* errorMsg = nullptr);
+    bool analyzePage(int pageIndex, PageTextData& outText, PageAnalysis& outAnalysis,
+                     TextExtractDetail detail = TextExtractDetail::Full,
+                     QString* errorMsg = nullptr);
 
     /**
      * @brief 检测是否为文本 PDF
+     *
+     * 采样页均匀分布在整个文档中；每页先检查资源字典里是否声明了字体，
+     * 没有字体的页直接判为无文本，有字体时再运行页面、找到第一个可见字形即停止。
+     * 结果确定后不再检查剩余采样页
+     *
      * @param samplePages 采样页数，0 表示全部检查
      * @return 如果采样页面中 30% 以上有文本则返回 true
      */
@@ -93,9 +139,6 @@ public:
      */
     QString getLastError() const;
 
-    void setPaperEffectEnabled(bool enabled);
-    bool paperEffectEnabled() const { return m_paperEffectEnabled; }
-
     fz_context* context() const { return m_context; }
     fz_document* document() const { return m_document; }
 
@@ -117,6 +160,57 @@ private:
      */
     void setLastError(const QString& error) const;
 
+    /**
+     * @brief 加载页面并提取文本（analysis 非空时同时完成页面分析）
+     */
+    bool loadPageContent(int pageIndex, PageTextData& outData, PageAnalysis* analysis,
+                         TextExtractDetail detail, QString* errorMsg);
+
+    /**
+     * @brief 读取页面链接并解析内部跳转目标
+     */
+    void loadLinks(fz_page* page, QVector<PDFLink>& outLinks);
+
+    /**
+     * @brief 检查页面（及一层 Form XObject）的资源字典是否声明了字体
+     * @return 确定没有文本返回 false；声明了字体、带注释或非 PDF 文档返回 true
+     */
+    bool pageMayHaveText(int pageIndex);
+
+    /**
+     * @brief 运行页面直到出现第一个可见字形
+     * @return 页面上有可见字形返回 true
+     */
+    bool probePageGlyphs(int pageIndex);
+
+    /**
+     * @brief 读取页面自带的 /Thumb 缩略图并缩放到目标宽度
+     * @return 没有、太小或比例不符时返回空图像
+     */
+    QImage loadEmbeddedThumbnail(int pageIndex, int targetWidth);
+
+    /**
+     * @brief 页面只由一张铺满页面的图像构成时，直接按目标尺寸解码该图像
+     * @return 页面还有其他内容（文字、路径、多张图像等）时返回空图像
+     */
+    QImage decodeSingleImagePage(int pageIndex, int targetWidth);
+
+    /**
+     * @brief 按缩略图配置渲染页面（低抗锯齿、无纸质效果、灰度页输出灰度图）
+     */
+    QImage renderThumbnailPage(int pageIndex, int targetWidth, int rotation);
+
+    /**
+     * @brief 获取页面的 display list（缓存未命中时解释页面并加入缓存）
+     * @return 增加了引用计数的 display list，调用方负责 fz_drop_display_list
+     */
+    fz_display_list* displayListFor(int pageIndex);
+
+    /**
+     * @brief 释放缓存的 display list（关闭文档或销毁 context 前调用）
+     */
+    void clearDisplayLists();
+
 private:
     QString m_documentPath;                     // 文档路径
     fz_context* m_context;                      // MuPDF context (独立实例)
@@ -125,8 +219,12 @@ private:
     mutable QVector<QSizeF> m_pageSizeCache;    // 页面尺寸缓存
     mutable QString m_lastError;                // 最后的错误信息
 
-    PaperEffectEnhancer m_paperEffectEnhancer;
-    bool m_paperEffectEnabled;
+    struct CachedDisplayList {
+        fz_display_list* list = nullptr;
+        qint64 lastUse = 0;
+    };
+    QHash<int, CachedDisplayList> m_displayLists;   // 页索引 -> display list（LRU）
+    qint64 m_displayListClock;
 };
 
 #endif // PERTHREADMUPDFRENDERER_H
@@ -7,6 +7,7 @@
 #include <QDebug>
 #include <QFileInfo>
 #include <QTimer>
+#include <QtConcurrent>
 
 PDFContentHandler::PDFContentHandler(PerThreadMuPDFRenderer* renderer, QObject* parent)
     : QObject(parent)
@@ -14,6 +15,7 @@ PDFContentHandler::PDFContentHandler(PerThreadMuPDFRenderer* renderer, QObject*
     , m_outlineManager(std::make_unique<OutlineManager>(m_renderer, this))
     , m_thumbnailManager(std::make_unique<ThumbnailManagerV2>(m_renderer, this))
     , m_outlineEditor(std::make_unique<OutlineEditor>(m_renderer, this))
+    , m_typeDetectGeneration(0)
 {
     setupConnections();
 }
@@ -65,6 +67,8 @@ void PDFContentHandler::closeDocument()
         m_renderer->closeDocument();
     }
 
+    ++m_typeDetectGeneration;
+
     clearOutline();
     clearThumbnails();
 
@@ -146,16 +150,14 @@ void PDFContentHandler::loadThumbnails()
     emit thumbnailsInitialized(pageCount);
 }
 
-void PDFContentHandler::handleVisibleRangeChanged(const QSet<int>& visibleIndices, int margin)
+void PDFContentHandler::handleVisibleRangeChanged(const QSet<int>& visibleIndices, int preloadPages,
+                                                  bool scrolling)
 {
-    Q_UNUSED(margin);
-
     if (!m_thumbnailManager) {
         return;
     }
 
-    // 仅大文档慢速滚动时响应
-    m_thumbnailManager->handleSlowScroll(visibleIndices);
+    m_thumbnailManager->updateViewport(visibleIndices, preloadPages, scrolling);
 }
 
 void PDFContentHandler::startInitialThumbnailLoad(const QSet<int>& initialVisible)
@@ -164,23 +166,19 @@ void PDFContentHandler::startInitialThumbnailLoad(const QSet<int>& initialVisibl
         return;
     }
 
-    // 启动智能加载（自动选择策略）
+    // 按视口调度加载
     m_thumbnailManager->startLoading(initialVisible);
 }
 
-void PDFContentHandler::syncLoadUnloadedPages(const QSet<int>& unloadedPages)
+void PDFContentHandler::requestThumbnails(const QSet<int>& pages)
 {
-    if (!m_thumbnailManager || unloadedPages.isEmpty()) {
+    if (!m_thumbnailManager || pages.isEmpty()) {
         return;
     }
 
-    // 转换为 QVector 并同步加载
-    QVector<int> pagesToLoad = unloadedPages.values().toVector();
+    qInfo() << "PDFContentHandler: Requesting" << pages.size() << "unloaded thumbnails";
 
-    qInfo() << "PDFContentHandler: Sync loading" << pagesToLoad.size()
-            << "unloaded pages after scroll stop";
-
-    m_thumbnailManager->syncLoadPages(pagesToLoad);
+    m_thumbnailManager->requestPages(pages);
 }
 
 QImage PDFContentHandler::getThumbnail(int pageIndex, bool preferHighRes) const
@@ -231,6 +229,39 @@ bool PDFContentHandler::isTextPDF(int samplePages) const
     return m_renderer->isTextPDF(samplePages);
 }
 
+void PDFContentHandler::detectDocumentTypeAsync(int samplePages)
+{
+    if (!isDocumentLoaded()) {
+        return;
+    }
+
+    const QString filePath = m_renderer->documentPath();
+    const int generation = ++m_typeDetectGeneration;
+
+    // 在后台线程用独立的 context/document 检测，不阻塞首屏渲染
+    QFuture<bool> future = QtConcurrent::run([filePath, samplePages]() {
+        PerThreadMuPDFRenderer renderer(filePath);
+        return renderer.isDocumentLoaded() && renderer.isTextPDF(samplePages);
+    });
+
+    QFutureWatcher<bool>* watcher = new QFutureWatcher<bool>(this);
+
+    connect(watcher, &QFutureWatcher<bool>::finished,
+            this, [this, watcher, filePath, generation]() {
+                bool isTextPDF = watcher->result();
+                watcher->deleteLater();
+
+                // 检测期间文档已关闭或重新打开
+                if (generation != m_typeDetectGeneration) {
+                    return;
+                }
+
+                emit documentTypeDetected(filePath, isTextPDF);
+            });
+
+    watcher->setFuture(future);
+}
+
 void PDFContentHandler::reset()
 {
     closeDocument();
@@ -38,9 +38,9 @@ public:
 
     // 缩略图管理
     void loadThumbnails();
-    void handleVisibleRangeChanged(const QSet<int>& visibleIndices, int margin);
+    void handleVisibleRangeChanged(const QSet<int>& visibleIndices, int preloadPages, bool scrolling);
     void startInitialThumbnailLoad(const QSet<int>& initialVisible);
-    void syncLoadUnloadedPages(const QSet<int>& unloadedPages);
+    void requestThumbnails(const QSet<int>& pages);
 
     QImage getThumbnail(int pageIndex, bool preferHighRes = false) const;
     bool hasThumbnail(int pageIndex) const;
@@ -59,6 +59,7 @@ public:
 
     // 工具方法
     bool isTextPDF(int samplePages = 5) const;
+    void detectDocumentTypeAsync(int samplePages = 5);
     void reset();
 
     // 获取子管理器
@@ -71,6 +72,7 @@ signals:
     void documentLoaded(const QString& filePath, int pageCount);
     void documentClosed();
     void documentError(const QString& error);
+    void documentTypeDetected(const QString& filePath, bool isTextPDF);
 
     // 大纲事件
     void outlineLoaded(bool success, int itemCount);
@@ -91,6 +93,7 @@ private:
     std::unique_ptr<OutlineManager> m_outlineManager;
     std::unique_ptr<ThumbnailManagerV2> m_thumbnailManager;
     std::unique_ptr<OutlineEditor> m_outlineEditor;
+    int m_typeDetectGeneration;     // 文档打开/关闭时递增，丢弃过期的类型检测结果
 };
 
 #endif // PDFCONTENTHANDLER_H
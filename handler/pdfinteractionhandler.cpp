@@ -4,6 +4,7 @@
 #include "searchmanager.h"
 #include "linkmanager.h"
 #include "textselector.h"
+#include "appconfig.h"
 #include <QDebug>
 #include <QDesktopServices>
 #include <QUrl>
@@ -25,7 +26,7 @@ PDFInteractionHandler::PDFInteractionHandler(PerThreadMuPDFRenderer* renderer,
     }
 
     m_searchManager = std::make_unique<SearchManager>(m_renderer, m_textCacheManager, this);
-    m_linkManager = std::make_unique<LinkManager>(m_renderer, this);
+    m_linkManager = std::make_unique<LinkManager>(m_renderer, m_textCacheManager, this);
     m_textSelector = std::make_unique<TextSelector>(m_renderer, m_textCacheManager, this);
 
     setupConnections();
@@ -38,7 +39,8 @@ PDFInteractionHandler::~PDFInteractionHandler()
 void PDFInteractionHandler::startSearch(const QString& query,
                                         bool caseSensitive,
                                         bool wholeWords,
-                                        int startPage)
+                                        int startPage,
+                                        bool foldInsensitive)
 {
     if (!m_searchManager) {
         return;
@@ -52,7 +54,8 @@ void PDFInteractionHandler::startSearch(const QString& query,
     SearchOptions options;
     options.caseSensitive = caseSensitive;
     options.wholeWords = wholeWords;
-    options.maxResults = 1000;
+    options.foldInsensitive = foldInsensitive;
+    options.maxResults = AppConfig::instance().searchMaxResults();
 
     m_searchManager->startSearch(query, options, startPage);
 }
@@ -98,6 +101,21 @@ SearchResult PDFInteractionHandler::findPrevious()
     return result;
 }
 
+SearchResult PDFInteractionHandler::findAt(int index)
+{
+    if (!m_searchManager) {
+        return SearchResult();
+    }
+
+    SearchResult result = m_searchManager->matchAt(index);
+
+    if (result.isValid()) {
+        emit searchNavigationCompleted(result, index, m_searchManager->totalMatches());
+    }
+
+    return result;
+}
+
 void PDFInteractionHandler::clearSearchResults()
 {
     if (m_searchManager) {
@@ -115,6 +133,14 @@ QVector<SearchResult> PDFInteractionHandler::getPageSearchResults(int pageIndex)
     return m_searchManager->getPageResults(pageIndex);
 }
 
+std::shared_ptr<const SearchResultSnapshot> PDFInteractionHandler::searchResultSnapshot() const
+{
+    if (!m_searchManager) {
+        return nullptr;
+    }
+    return m_searchManager->resultSnapshot();
+}
+
 void PDFInteractionHandler::addSearchHistory(const QString& query)
 {
     if (m_searchManager) {
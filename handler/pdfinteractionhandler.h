@@ -13,6 +13,7 @@ class SearchManager;
 class LinkManager;
 class TextSelector;
 struct SearchResult;
+struct SearchResultSnapshot;
 struct PDFLink;
 struct TextSelection;
 
@@ -42,7 +43,8 @@ public:
     void startSearch(const QString& query,
                      bool caseSensitive = false,
                      bool wholeWords = false,
-                     int startPage = 0);
+                     int startPage = 0,
+                     bool foldInsensitive = false);
 
     /**
      * @brief 取消搜索
@@ -59,6 +61,11 @@ public:
      */
     SearchResult findPrevious();
 
+    /**
+     * @brief 跳转到指定索引的搜索结果（结果列表点击）
+     */
+    SearchResult findAt(int index);
+
     /**
      * @brief 清除搜索结果
      */
@@ -69,6 +76,11 @@ public:
      */
     QVector<SearchResult> getPageSearchResults(int pageIndex) const;
 
+    /**
+     * @brief 获取搜索结果快照（按页分桶，无锁只读，供绘制使用）
+     */
+    std::shared_ptr<const SearchResultSnapshot> searchResultSnapshot() const;
+
     /**
      * @brief 添加搜索历史
      */
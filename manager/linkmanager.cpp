@@ -1,13 +1,17 @@
 #include "linkmanager.h"
 #include "perthreadmupdfrenderer.h"
+#include "textcachemanager.h"
 
 #include <mupdf/fitz.h>
 #include <mupdf/pdf.h>
 #include <QDebug>
 
-LinkManager::LinkManager(PerThreadMuPDFRenderer* renderer, QObject* parent)
+LinkManager::LinkManager(PerThreadMuPDFRenderer* renderer,
+                         TextCacheManager* textCache,
+                         QObject* parent)
     : QObject(parent)
     , m_renderer(renderer)
+    , m_textCache(textCache)
 {
 }
 
@@ -25,6 +29,13 @@ QVector<PDFLink> LinkManager::loadPageLinks(int pageIndex)
 
     QVector<PDFLink> links;
 
+    // 后台页面分析已经加载过该页时直接使用其结果
+    PageAnalysis analysis;
+    if (m_textCache && m_textCache->pageAnalysis(pageIndex, &analysis)) {
+        m_cachedLinks[pageIndex] = analysis.links;
+        return analysis.links;
+    }
+
     if (!m_renderer || !m_renderer->isDocumentLoaded()) {
         return links;
     }
@@ -7,33 +7,17 @@
 #include <QString>
 #include <QMap>
 
-class PerThreadMuPDFRenderer;
-
-/**
- * @brief PDF链接信息
- */
-struct PDFLink
-{
-    QRectF rect;          ///< 链接区域（页面坐标）
-    int targetPage;       ///< 目标页码（-1表示外部链接）
-    QString uri;          ///< 链接URI
-
-    /**
-     * @brief 判断是否为内部链接
-     */
-    bool isInternal() const { return targetPage >= 0; }
+#include "datastructure.h"
 
-    /**
-     * @brief 判断是否为外部链接
-     */
-    bool isExternal() const { return !uri.isEmpty() && targetPage < 0; }
-};
+class PerThreadMuPDFRenderer;
+class TextCacheManager;
 
 /**
  * @brief PDF链接管理器
  *
  * 负责提取和管理PDF页面中的链接
  * 支持内部链接（页面跳转）和外部链接（URL）
+ * 后台页面分析已经得到的链接直接复用，不再重复加载页面
  */
 class LinkManager : public QObject
 {
@@ -43,9 +27,12 @@ public:
     /**
      * @brief 构造函数
      * @param renderer MuPDF渲染器指针
+     * @param textCache 文本缓存（提供后台分析得到的链接，可为空）
      * @param parent 父对象
      */
-    explicit LinkManager(PerThreadMuPDFRenderer* renderer, QObject* parent = nullptr);
+    explicit LinkManager(PerThreadMuPDFRenderer* renderer,
+                         TextCacheManager* textCache = nullptr,
+                         QObject* parent = nullptr);
 
     /**
      * @brief 析构函数
@@ -96,6 +83,7 @@ private:
 
 private:
     PerThreadMuPDFRenderer* m_renderer;                       ///< MuPDF渲染器
+    TextCacheManager* m_textCache;                            ///< 页面分析结果来源
     QMap<int, QVector<PDFLink>> m_cachedLinks;      ///< 缓存的链接（按页索引）
 };
 
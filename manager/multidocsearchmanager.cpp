@@ -0,0 +1,282 @@
+#include "multidocsearchmanager.h"
+#include "perthreadmupdfrenderer.h"
+#include "searchmanager.h"
+#include "chinesetokenizer.h"
+#include "appconfig.h"
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QRunnable>
+#include <QMetaObject>
+#include <QElapsedTimer>
+
+// ========================================
+// DocumentSearchTask - 单文档搜索任务
+// ========================================
+class DocumentSearchTask : public QRunnable
+{
+public:
+    DocumentSearchTask(MultiDocSearchManager* manager,
+                       int searchId,
+                       const QString& filePath,
+                       const QString& query,
+                       const SearchOptions& options)
+        : m_manager(manager)
+        , m_searchId(searchId)
+        , m_filePath(filePath)
+        , m_query(query)
+        , m_options(options)
+    {
+        setAutoDelete(true);
+    }
+
+    void run() override
+    {
+        if (!m_manager || isStale()) {
+            return;
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+
+        // 每个任务独立打开文档，任务结束即释放
+        PerThreadMuPDFRenderer renderer(m_filePath);
+        if (!renderer.isDocumentLoaded()) {
+            qWarning() << "DocumentSearchTask: Failed to open" << m_filePath
+                       << renderer.getLastError();
+            reportFinished(0, renderer.getLastError());
+            return;
+        }
+
+        int pageCount = renderer.pageCount();
+        int matchCount = 0;
+        QVector<SearchResult> pending;
+
+        const bool useWordIndex = m_options.wholeWords &&
+                                  AppConfig::instance().searchCJKWordIndex() &&
+                                  ChineseTokenizer::instance().ensureInitialized(
+                                      AppConfig::instance().jiebaDictDir());
+
+        for (int pageIndex = 0; pageIndex < pageCount; ++pageIndex) {
+            // 每页检查是否过期（被取消或已开始新搜索），过期任务不再上报
+            if (isStale()) {
+                qDebug() << "DocumentSearchTask: Cancelled at page" << pageIndex
+                         << "of" << m_filePath;
+                return;
+            }
+
+            // 页文本只在本次循环内存活；先只提取文本，有匹配时再完整提取
+            PageTextData pageData;
+            if (!renderer.extractText(pageIndex, pageData, nullptr, TextExtractDetail::TextOnly) ||
+                pageData.isEmpty()) {
+                continue;
+            }
+
+            // 分词索引只服务于全词匹配
+            if (useWordIndex) {
+                ChineseTokenizer::instance().buildWordIndex(pageData);
+            }
+
+            QVector<SearchResult> pageResults =
+                SearchManager::searchTextData(pageData, m_query, m_options);
+
+            if (!pageResults.isEmpty() &&
+                renderer.extractText(pageIndex, pageData, nullptr, TextExtractDetail::Full)) {
+                if (useWordIndex) {
+                    ChineseTokenizer::instance().buildWordIndex(pageData);
+                }
+                pageResults = SearchManager::searchTextData(pageData, m_query, m_options);
+            }
+
+            if (m_options.maxResults > 0) {
+                int room = m_options.maxResults - matchCount;
+                if (pageResults.size() > room) {
+                    pageResults.resize(room);
+                }
+            }
+
+            // 页文本即将释放，多文档结果在此生成上下文
+            for (SearchResult& result : pageResults) {
+                result.context = SearchManager::buildContext(pageData, result);
+            }
+
+            matchCount += pageResults.size();
+            pending += pageResults;
+
+            // 分批投递，避免每页一次跨线程调用
+            if (pending.size() >= FLUSH_RESULT_COUNT ||
+                (!pending.isEmpty() && (pageIndex + 1) % FLUSH_PAGE_INTERVAL == 0)) {
+                reportResults(pending);
+                pending.clear();
+            }
+
+            if (m_options.maxResults > 0 && matchCount >= m_options.maxResults) {
+                break;
+            }
+        }
+
+        if (!pending.isEmpty()) {
+            reportResults(pending);
+        }
+
+        qDebug() << "DocumentSearchTask:" << QFileInfo(m_filePath).fileName()
+                 << "pages:" << pageCount
+                 << "matches:" << matchCount
+                 << "time:" << timer.elapsed() << "ms";
+
+        reportFinished(matchCount, QString());
+    }
+
+private:
+    bool isStale() const
+    {
+        return m_manager->m_searchId.loadAcquire() != m_searchId;
+    }
+
+    void reportResults(const QVector<SearchResult>& results)
+    {
+        QMetaObject::invokeMethod(m_manager, "handleDocumentResults",
+                                  Qt::QueuedConnection,
+                                  Q_ARG(int, m_searchId),
+                                  Q_ARG(QString, m_filePath),
+                                  Q_ARG(QVector<SearchResult>, results));
+    }
+
+    void reportFinished(int matchCount, const QString& error)
+    {
+        QMetaObject::invokeMethod(m_manager, "handleDocumentFinished",
+                                  Qt::QueuedConnection,
+                                  Q_ARG(int, m_searchId),
+                                  Q_ARG(QString, m_filePath),
+                                  Q_ARG(int, matchCount),
+                                  Q_ARG(QString, error));
+    }
+
+    static constexpr int FLUSH_RESULT_COUNT = 64;    // 累积到多少条结果就投递
+    static constexpr int FLUSH_PAGE_INTERVAL = 16;   // 或每隔多少页投递一次
+
+    MultiDocSearchManager* m_manager;
+    int m_searchId;
+    QString m_filePath;
+    QString m_query;
+    SearchOptions m_options;
+};
+
+// ========================================
+// MultiDocSearchManager 实现
+// ========================================
+MultiDocSearchManager::MultiDocSearchManager(QObject* parent)
+    : QObject(parent)
+    , m_searchId(0)
+    , m_isSearching(false)
+    , m_totalDocuments(0)
+    , m_finishedDocuments(0)
+    , m_totalMatches(0)
+{
+    m_threadPool.setMaxThreadCount(AppConfig::instance().multiDocSearchMaxDocuments());
+}
+
+MultiDocSearchManager::~MultiDocSearchManager()
+{
+    cancelSearch();
+    m_threadPool.waitForDone();
+}
+
+void MultiDocSearchManager::startSearch(const QStringList& filePaths,
+                                        const QString& query,
+                                        const SearchOptions& options)
+{
+    cancelSearch();
+
+    if (query.isEmpty() || filePaths.isEmpty()) {
+        return;
+    }
+
+    // 新的搜索代号，旧任务自动失效
+    int searchId = m_searchId.fetchAndAddOrdered(1) + 1;
+
+    m_currentQuery = query;
+    m_isSearching = true;
+    m_totalDocuments = filePaths.size();
+    m_finishedDocuments = 0;
+    m_totalMatches = 0;
+
+    qDebug() << "MultiDocSearchManager: Searching" << m_totalDocuments << "documents"
+             << "with" << m_threadPool.maxThreadCount() << "workers";
+
+    emit searchStarted(m_totalDocuments);
+
+    for (const QString& filePath : filePaths) {
+        m_threadPool.start(new DocumentSearchTask(this, searchId, filePath, query, options));
+    }
+}
+
+void MultiDocSearchManager::cancelSearch()
+{
+    // 递增代号让运行中的任务在下一页退出，并丢弃尚未开始的任务
+    m_searchId.ref();
+    m_threadPool.clear();
+
+    if (m_isSearching) {
+        m_isSearching = false;
+        qDebug() << "MultiDocSearchManager: Search cancelled";
+        emit searchCancelled();
+    }
+}
+
+void MultiDocSearchManager::setMaxConcurrentDocuments(int count)
+{
+    m_threadPool.setMaxThreadCount(qMax(1, count));
+}
+
+int MultiDocSearchManager::maxConcurrentDocuments() const
+{
+    return m_threadPool.maxThreadCount();
+}
+
+QStringList MultiDocSearchManager::collectPdfFiles(const QString& dirPath, bool recursive)
+{
+    QStringList files;
+
+    QDirIterator it(dirPath, QStringList() << "*.pdf" << "*.PDF",
+                    QDir::Files | QDir::Readable,
+                    recursive ? QDirIterator::Subdirectories : QDirIterator::NoIteratorFlags);
+    while (it.hasNext()) {
+        files.append(it.next());
+    }
+
+    files.removeDuplicates();
+    files.sort(Qt::CaseInsensitive);
+    return files;
+}
+
+void MultiDocSearchManager::handleDocumentResults(int searchId, QString filePath,
+                                                  QVector<SearchResult> results)
+{
+    if (searchId != m_searchId.loadAcquire() || !m_isSearching) {
+        return;
+    }
+
+    m_totalMatches += results.size();
+    emit documentResultsReady(filePath, results);
+}
+
+void MultiDocSearchManager::handleDocumentFinished(int searchId, QString filePath,
+                                                   int matchCount, QString error)
+{
+    if (searchId != m_searchId.loadAcquire() || !m_isSearching) {
+        return;
+    }
+
+    ++m_finishedDocuments;
+    emit documentFinished(filePath, matchCount, error);
+    emit searchProgress(m_finishedDocuments, m_totalDocuments, m_totalMatches);
+
+    if (m_finishedDocuments >= m_totalDocuments) {
+        m_isSearching = false;
+        qDebug() << "MultiDocSearchManager: Search completed," << m_totalMatches
+                 << "matches in" << m_totalDocuments << "documents";
+        emit searchCompleted(m_currentQuery, m_totalDocuments, m_totalMatches);
+    }
+}
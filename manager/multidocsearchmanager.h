@@ -0,0 +1,91 @@
+#ifndef MULTIDOCSEARCHMANAGER_H
+#define MULTIDOCSEARCHMANAGER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QAtomicInt>
+#include <QThreadPool>
+
+#include "datastructure.h"
+
+class DocumentSearchTask;
+
+/**
+ * @brief 多文档搜索管理器
+ *
+ * 在多个PDF文件（已打开的文档或指定文件夹）中并行搜索：
+ * - 有界线程池，每个工作线程一次只打开一个文档，逐页提取并搜索
+ * - 页文本用完即释放，同时驻留内存的文档数不超过并发文档数
+ * - 结果按文档分组，分批流式投递到 UI 线程
+ *
+ * 与单文档 SearchManager 共用匹配逻辑（SearchManager::searchTextData）
+ */
+class MultiDocSearchManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MultiDocSearchManager(QObject* parent = nullptr);
+    ~MultiDocSearchManager();
+
+    // 搜索控制
+    void startSearch(const QStringList& filePaths,
+                     const QString& query,
+                     const SearchOptions& options = SearchOptions());
+    void cancelSearch();
+    bool isSearching() const { return m_isSearching; }
+
+    // 并发文档数（即同时驻留内存的文档文本上限）
+    void setMaxConcurrentDocuments(int count);
+    int maxConcurrentDocuments() const;
+
+    /**
+     * @brief 收集目录下的PDF文件
+     * @param dirPath 目录路径
+     * @param recursive 是否包含子目录
+     */
+    static QStringList collectPdfFiles(const QString& dirPath, bool recursive = true);
+
+signals:
+    void searchStarted(int totalDocuments);
+
+    /**
+     * @brief 某个文档的一批结果（同一文档可能分多批到达）
+     */
+    void documentResultsReady(const QString& filePath, const QVector<SearchResult>& results);
+
+    /**
+     * @brief 某个文档搜索结束
+     * @param error 为空表示成功
+     */
+    void documentFinished(const QString& filePath, int matchCount, const QString& error);
+
+    void searchProgress(int finishedDocuments, int totalDocuments, int totalMatches);
+    void searchCompleted(const QString& query, int totalDocuments, int totalMatches);
+    void searchCancelled();
+
+private slots:
+    // 由 DocumentSearchTask 通过 QMetaObject::invokeMethod 调用
+    void handleDocumentResults(int searchId, QString filePath, QVector<SearchResult> results);
+    void handleDocumentFinished(int searchId, QString filePath, int matchCount, QString error);
+
+private:
+    friend class DocumentSearchTask;
+
+    // 线程池（线程数 = 并发文档数）
+    QThreadPool m_threadPool;
+
+    // 搜索代号：每次开始/取消搜索递增，旧任务据此判断自己已过期
+    QAtomicInt m_searchId;
+
+    // 当前搜索状态（仅在主线程访问）
+    QString m_currentQuery;
+    bool m_isSearching;
+    int m_totalDocuments;
+    int m_finishedDocuments;
+    int m_totalMatches;
+};
+
+#endif // MULTIDOCSEARCHMANAGER_H
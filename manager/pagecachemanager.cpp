@@ -23,17 +23,16 @@ bool PageCacheManager::addPage(int pageIndex, double zoom, int rotation, const Q
 
     PageCacheKey key(pageIndex, zoom, rotation);
 
-    // 如果已存在，更新
+    // 如果已存在，更新（原图变化后派生图层失效）
     if (m_cache.contains(key)) {
         m_cache[key] = image;
+        m_layers.remove(key);
         updateAccessTime(key);
         return true;
     }
 
     // 如果缓存已满，执行淘汰
-    if (m_cache.size() >= m_maxSize) {
-        evict();
-    }
+    evictForInsert();
 
     // 添加新页面
     m_cache.insert(key, image);
@@ -67,11 +66,55 @@ bool PageCacheManager::contains(int pageIndex, double zoom, int rotation) const
     return m_cache.contains(key);
 }
 
+QImage PageCacheManager::getLayer(int pageIndex, double zoom, int rotation)
+{
+    QMutexLocker locker(&m_mutex);
+
+    PageCacheKey key(pageIndex, zoom, rotation);
+    auto it = m_layers.constFind(key);
+    if (it == m_layers.constEnd()) {
+        return QImage();
+    }
+
+    updateAccessTime(key);
+    return it.value();
+}
+
+void PageCacheManager::setLayer(int pageIndex, double zoom, int rotation, const QImage& layer)
+{
+    if (layer.isNull()) {
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    PageCacheKey key(pageIndex, zoom, rotation);
+    if (!m_layers.contains(key)) {
+        evictForInsert();
+    }
+    m_layers.insert(key, layer);
+    updateAccessTime(key);
+}
+
+void PageCacheManager::clearLayers()
+{
+    QMutexLocker locker(&m_mutex);
+
+    // 只有图层的键不再占用访问记录
+    for (auto it = m_layers.constBegin(); it != m_layers.constEnd(); ++it) {
+        if (!m_cache.contains(it.key())) {
+            m_accessTime.remove(it.key());
+        }
+    }
+    m_layers.clear();
+}
+
 void PageCacheManager::removePage(int pageIndex, double zoom, int rotation)
 {
     QMutexLocker locker(&m_mutex);
     PageCacheKey key(pageIndex, zoom, rotation);
     m_cache.remove(key);
+    m_layers.remove(key);
     m_accessTime.remove(key);
 }
 
@@ -79,6 +122,7 @@ void PageCacheManager::clear()
 {
     QMutexLocker locker(&m_mutex);
     m_cache.clear();
+    m_layers.clear();
     m_accessTime.clear();
     m_visiblePages.clear();
     m_timeCounter = 0;
@@ -92,7 +136,8 @@ void PageCacheManager::clearByZoomRotation(double zoom, int rotation)
 
     QList<PageCacheKey> keysToRemove;
 
-    for (auto it = m_cache.constBegin(); it != m_cache.constEnd(); ++it) {
+    // 遍历访问记录，只有图层的键也一并清理
+    for (auto it = m_accessTime.constBegin(); it != m_accessTime.constEnd(); ++it) {
         const PageCacheKey& key = it.key();
 
         bool shouldRemove = false;
@@ -118,6 +163,7 @@ void PageCacheManager::clearByZoomRotation(double zoom, int rotation)
 
     for (const PageCacheKey& key : keysToRemove) {
         m_cache.remove(key);
+        m_layers.remove(key);
         m_accessTime.remove(key);
     }
 }
@@ -133,7 +179,7 @@ void PageCacheManager::setMaxSize(int maxSize)
     m_maxSize = maxSize;
 
     // 如果新大小小于当前缓存，执行淘汰
-    while (m_cache.size() > m_maxSize) {
+    while (imageCount() > m_maxSize && !m_accessTime.isEmpty()) {
         evict();
     }
 }
@@ -165,6 +211,12 @@ void PageCacheManager::setCurrentPage(int pageIndex, double zoom, int rotation)
 qint64 PageCacheManager::memoryUsage() const
 {
     QMutexLocker locker(&m_mutex);
+    return memoryUsageLocked();
+}
+
+qint64 PageCacheManager::memoryUsageLocked() const
+{
+    // 注意：调用此方法前必须已经获取互斥锁
 
     qint64 totalBytes = 0;
 
@@ -172,6 +224,10 @@ qint64 PageCacheManager::memoryUsage() const
         totalBytes += image.sizeInBytes();
     }
 
+    for (const QImage& layer : m_layers) {
+        totalBytes += layer.sizeInBytes();
+    }
+
     return totalBytes;
 }
 
@@ -188,10 +244,10 @@ QString PageCacheManager::getStatistics() const
     qint64 totalAccess = m_hitCount + m_missCount;
     double hitRate = (totalAccess > 0) ? (m_hitCount * 100.0 / totalAccess) : 0;
 
-    return QString("Cache: %1/%2 pages, Memory: %3 MB, Hit Rate: %4%, Hits: %5, Misses: %6")
-        .arg(m_cache.size())
+    return QString("Cache: %1/%2 images, Memory: %3 MB, Hit Rate: %4%, Hits: %5, Misses: %6")
+        .arg(imageCount())
         .arg(m_maxSize)
-        .arg(memoryUsage() / 1024.0 / 1024.0, 0, 'f', 2)
+        .arg(memoryUsageLocked() / 1024.0 / 1024.0, 0, 'f', 2)
         .arg(hitRate, 0, 'f', 1)
         .arg(m_hitCount)
         .arg(m_missCount);
@@ -201,13 +257,14 @@ void PageCacheManager::evict()
 {
     // 注意：调用此方法前必须已经获取互斥锁
 
-    if (m_cache.isEmpty()) {
+    if (m_accessTime.isEmpty()) {
         return;
     }
 
     PageCacheKey keyToRemove = selectKeyToEvict();
 
     m_cache.remove(keyToRemove);
+    m_layers.remove(keyToRemove);
     m_accessTime.remove(keyToRemove);
 }
 
@@ -215,7 +272,8 @@ PageCacheKey PageCacheManager::selectKeyToEvict()
 {
     // 注意：调用此方法前必须已经获取互斥锁
 
-    QList<PageCacheKey> cachedKeys = m_cache.keys();
+    // 原始页面和派生图层的键并集
+    QList<PageCacheKey> cachedKeys = m_accessTime.keys();
 
     if (cachedKeys.isEmpty()) {
         return PageCacheKey();
@@ -304,3 +362,19 @@ void PageCacheManager::updateAccessTime(const PageCacheKey& key)
     // 注意：调用此方法前必须已经获取互斥锁
     m_accessTime[key] = ++m_timeCounter;
 }
+
+int PageCacheManager::imageCount() const
+{
+    // 注意：调用此方法前必须已经获取互斥锁
+    return m_cache.size() + m_layers.size();
+}
+
+void PageCacheManager::evictForInsert()
+{
+    // 注意：调用此方法前必须已经获取互斥锁
+
+    // 每次淘汰至少移除一张图像，访问记录为空时缓存也为空
+    while (imageCount() >= m_maxSize && !m_accessTime.isEmpty()) {
+        evict();
+    }
+}
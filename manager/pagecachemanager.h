@@ -73,6 +73,7 @@ inline uint qHash(const PageCacheKey& key, uint seed = 0) {
  * - 智能预加载
  * - 线程安全
  * - 内存使用监控
+ * - 派生图层（如纸质效果）：与原始页面同键存放，原始页面更新时失效；可以单独存在，共用同一套访问记录参与淘汰
  */
 class PageCacheManager
 {
@@ -122,6 +123,22 @@ public:
      */
     bool contains(int pageIndex, double zoom, int rotation) const;
 
+    /**
+     * @brief 获取页面的派生图层（命中时更新访问时间）
+     * @return 图层图像，不存在时返回空QImage
+     */
+    QImage getLayer(int pageIndex, double zoom, int rotation);
+
+    /**
+     * @brief 保存页面的派生图层（原始页面不在缓存中时也保存，与原始页面一起参与淘汰）
+     */
+    void setLayer(int pageIndex, double zoom, int rotation, const QImage& layer);
+
+    /**
+     * @brief 清空所有派生图层，原始页面保留
+     */
+    void clearLayers();
+
     /**
      * @brief 移除指定页面
      * @param pageIndex 页码
@@ -216,14 +233,30 @@ private:
      */
     void updateAccessTime(const PageCacheKey& key);
 
+    /**
+     * @brief 缓存中的图像张数（原始页面 + 派生图层）
+     */
+    int imageCount() const;
+
+    /**
+     * @brief 淘汰到能再放入一张图像为止
+     */
+    void evictForInsert();
+
+    /**
+     * @brief 计算内存占用（调用前必须已持有互斥锁）
+     */
+    qint64 memoryUsageLocked() const;
+
 private:
     mutable QMutex m_mutex;                     ///< 线程安全锁
 
-    int m_maxSize;                              ///< 最大缓存大小
+    int m_maxSize;                              ///< 最大缓存大小（原始页面和派生图层合计张数）
     CacheStrategy m_strategy;                   ///< 缓存策略
 
     QMap<PageCacheKey, QImage> m_cache;         ///< 页面缓存
-    QMap<PageCacheKey, qint64> m_accessTime;    ///< 访问时间戳
+    QMap<PageCacheKey, QImage> m_layers;        ///< 派生图层（键可以不在 m_cache 中）
+    QMap<PageCacheKey, qint64> m_accessTime;    ///< 访问时间戳（m_cache 和 m_layers 的键并集）
     QSet<int> m_visiblePages;                   ///< 当前可见的页面集合
 
     PageCacheKey m_currentKey;                  ///< 当前页面键
@@ -1,12 +1,14 @@
 #include "searchmanager.h"
 #include "perthreadmupdfrenderer.h"
 #include "textcachemanager.h"
+#include "textfolding.h"
 #include <QDebug>
 #include <QMutexLocker>
 #include <QThread>
 #include <QCoreApplication>
 #include <QMetaObject>
 #include <QTimer>
+#include <algorithm>
 
 // ----------------- SearchManager 实现 -----------------
 
@@ -16,6 +18,7 @@ SearchManager::SearchManager(PerThreadMuPDFRenderer* renderer,
     : QObject(parent)
     , m_renderer(renderer)
     , m_textCacheManager(textCacheManager)
+    , m_snapshot(std::make_shared<const SearchResultSnapshot>())
     , m_currentMatchIndex(-1)
     , m_isSearching(false)
     , m_cancelRequested(false)
@@ -64,7 +67,7 @@ void SearchManager::startSearch(const QString& query,
         QMutexLocker locker(&m_mutex);
         m_currentQuery = query;
         m_currentOptions = options;
-        m_results.clear();
+        publishSnapshot(std::make_shared<const SearchResultSnapshot>());
         m_currentMatchIndex = -1;
         m_isSearching.store(true);
         m_cancelRequested.store(false);
@@ -91,6 +94,7 @@ void SearchManager::startSearch(const QString& query,
 
     // 连接 worker 的信号到 manager（使用 QueuedConnection 确保线程间安全）
     connect(worker, &SearchWorker::progress, this, &SearchManager::searchProgress, Qt::QueuedConnection);
+    connect(worker, &SearchWorker::resultsAvailable, this, &SearchManager::searchResultsAvailable, Qt::QueuedConnection);
 
     // 当 worker 完成/取消/报错时，让线程退出（quit），以便触发线程的 finished 信号并清理。
     connect(worker, &SearchWorker::finished, thread, &QThread::quit, Qt::QueuedConnection);
@@ -161,27 +165,69 @@ bool SearchManager::isSearching() const
 
 QVector<SearchResult> SearchManager::getAllResults() const
 {
-    QMutexLocker locker(&m_mutex);
-    return m_results;
+    SearchResultSnapshotPtr snapshot = resultSnapshot();
+
+    QVector<SearchResult> results;
+    results.reserve(snapshot->totalMatches());
+    for (const SearchResultSnapshot::Chunk& chunk : snapshot->chunks) {
+        results.append(*chunk);
+    }
+    return results;
 }
 
 QVector<SearchResult> SearchManager::getPageResults(int pageIndex) const
 {
-    QMutexLocker locker(&m_mutex);
+    SearchResultSnapshotPtr snapshot = resultSnapshot();
 
     QVector<SearchResult> pageResults;
-    for (const SearchResult& result : m_results) {
-        if (result.pageIndex == pageIndex) {
-            pageResults.append(result);
-        }
+    for (int chunk : snapshot->pageChunkIndices(pageIndex)) {
+        pageResults.append(*snapshot->chunks[chunk]);
     }
     return pageResults;
 }
 
 int SearchManager::totalMatches() const
 {
+    return resultSnapshot()->totalMatches();
+}
+
+SearchResultSnapshotPtr SearchManager::resultSnapshot() const
+{
+    return std::atomic_load(&m_snapshot);
+}
+
+void SearchManager::publishSnapshot(SearchResultSnapshotPtr snapshot)
+{
+    std::atomic_store(&m_snapshot, std::move(snapshot));
+}
+
+void SearchManager::pinCurrentMatchPage(int pageIndex)
+{
+    if (!m_textCacheManager) {
+        return;
+    }
+
+    m_textCacheManager->setPinnedPages(TextCacheManager::PinSearch,
+                                       pageIndex >= 0 ? QSet<int>{pageIndex} : QSet<int>());
+}
+
+void SearchManager::appendPageResults(int pageIndex, const QVector<SearchResult>& pageResults)
+{
+    if (pageResults.isEmpty()) {
+        return;
+    }
+
+    // 写者之间由 m_mutex 串行化；读者只看到完整的新旧快照之一
     QMutexLocker locker(&m_mutex);
-    return m_results.size();
+
+    // 已有的结果块与旧快照共享，只追加一块
+    auto snapshot = std::make_shared<SearchResultSnapshot>(*resultSnapshot());
+    snapshot->pageChunks[pageIndex].append(snapshot->chunks.size());
+    snapshot->chunkStarts.append(snapshot->total);
+    snapshot->chunks.append(std::make_shared<const QVector<SearchResult>>(pageResults));
+    snapshot->total += pageResults.size();
+
+    publishSnapshot(std::move(snapshot));
 }
 
 int SearchManager::currentMatchIndex() const
@@ -193,8 +239,10 @@ int SearchManager::currentMatchIndex() const
 void SearchManager::setCurrentMatchIndex(int index)
 {
     QMutexLocker locker(&m_mutex);
-    if (index >= -1 && index < m_results.size()) {
+    SearchResultSnapshotPtr snapshot = resultSnapshot();
+    if (index >= -1 && index < snapshot->totalMatches()) {
         m_currentMatchIndex = index;
+        pinCurrentMatchPage(index >= 0 ? snapshot->at(index).pageIndex : -1);
     }
 }
 
@@ -202,36 +250,55 @@ SearchResult SearchManager::nextMatch()
 {
     QMutexLocker locker(&m_mutex);
 
-    if (m_results.isEmpty()) {
+    SearchResultSnapshotPtr snapshot = resultSnapshot();
+    if (snapshot->totalMatches() == 0) {
         return SearchResult();
     }
 
-    m_currentMatchIndex = (m_currentMatchIndex + 1) % m_results.size();
-    return m_results[m_currentMatchIndex];
+    m_currentMatchIndex = (m_currentMatchIndex + 1) % snapshot->totalMatches();
+    pinCurrentMatchPage(snapshot->at(m_currentMatchIndex).pageIndex);
+    return snapshot->at(m_currentMatchIndex);
 }
 
 SearchResult SearchManager::previousMatch()
 {
     QMutexLocker locker(&m_mutex);
 
-    if (m_results.isEmpty()) {
+    SearchResultSnapshotPtr snapshot = resultSnapshot();
+    if (snapshot->totalMatches() == 0) {
         return SearchResult();
     }
 
     m_currentMatchIndex--;
-    if (m_currentMatchIndex < 0) {
-        m_currentMatchIndex = m_results.size() - 1;
+    if (m_currentMatchIndex < 0 || m_currentMatchIndex >= snapshot->totalMatches()) {
+        m_currentMatchIndex = snapshot->totalMatches() - 1;
+    }
+
+    pinCurrentMatchPage(snapshot->at(m_currentMatchIndex).pageIndex);
+    return snapshot->at(m_currentMatchIndex);
+}
+
+SearchResult SearchManager::matchAt(int index)
+{
+    QMutexLocker locker(&m_mutex);
+
+    SearchResultSnapshotPtr snapshot = resultSnapshot();
+    if (index < 0 || index >= snapshot->totalMatches()) {
+        return SearchResult();
     }
 
-    return m_results[m_currentMatchIndex];
+    m_currentMatchIndex = index;
+    pinCurrentMatchPage(snapshot->at(m_currentMatchIndex).pageIndex);
+    return snapshot->at(m_currentMatchIndex);
 }
 
 void SearchManager::clearResults()
 {
     QMutexLocker locker(&m_mutex);
-    m_results.clear();
+    publishSnapshot(std::make_shared<const SearchResultSnapshot>());
     m_currentMatchIndex = -1;
     m_currentQuery.clear();
+    pinCurrentMatchPage(-1);
 }
 
 void SearchManager::addToHistory(const QString& query)
@@ -271,6 +338,39 @@ void SearchManager::clearHistory()
     m_searchHistory.clear();
 }
 
+// ----------------- 中文分词边界 -----------------
+
+static inline bool isCJKChar(char32_t u)
+{
+    return (u >= 0x4E00 && u <= 0x9FFF) ||    // CJK Unified Ideographs
+           (u >= 0x3400 && u <= 0x4DBF) ||    // CJK Extension A
+           (u >= 0xF900 && u <= 0xFAFF) ||    // CJK Compatibility Ideographs
+           (u >= 0x3040 && u <= 0x30FF) ||    // Japanese Hiragana/Katakana
+           (u >= 0xAC00 && u <= 0xD7AF);      // Korean Hangul
+}
+
+/**
+ * @brief 用分词索引判断字符序号处（charOrdinal - 1 与 charOrdinal 之间）是否为词边界
+ * @param lineFirst 所在行首字符序号
+ * @param lineEnd 所在行尾后一个字符序号
+ * @return 能由分词索引判定时返回 true 并写入 *isEdge，否则由调用方按字母数字规则判断
+ */
+static bool wordIndexEdge(const PageTextData& textData, int charOrdinal,
+                          int lineFirst, int lineEnd, bool* isEdge)
+{
+    if (textData.wordBreaks.isEmpty() || charOrdinal <= lineFirst || charOrdinal >= lineEnd) {
+        return false;
+    }
+    if (!isCJKChar(textData.codepoint(charOrdinal - 1)) &&
+        !isCJKChar(textData.codepoint(charOrdinal))) {
+        return false;
+    }
+
+    *isEdge = std::binary_search(textData.wordBreaks.cbegin(),
+                                 textData.wordBreaks.cend(), charOrdinal);
+    return true;
+}
+
 // ----------------- 从缓存的文本数据中搜索 -----------------
 
 QVector<SearchResult> SearchManager::searchPage(int pageIndex,
@@ -283,44 +383,91 @@ QVector<SearchResult> SearchManager::searchPage(int pageIndex,
         return results;
     }
 
-    // 从缓存获取文本数据
-    PageTextData textData = m_textCacheManager->getPageTextData(pageIndex);
+    // 从缓存获取文本数据（尚未提取时插队提取）
+    PageTextData textData = m_textCacheManager->ensurePageTextData(pageIndex);
 
     if (textData.isEmpty()) {
         qDebug() << "searchPage: No text data cached for page" << pageIndex;
         return results;
     }
 
+    results = searchTextData(textData, query, options);
+
+    // 预加载只提取了文本：有匹配的页补齐字符边界框后重新计算高亮矩形
+    if (!results.isEmpty() && !textData.hasCharBoxes()) {
+        PageTextData fullData = m_textCacheManager->ensurePageGeometry(pageIndex);
+        if (fullData.hasCharBoxes()) {
+            results = searchTextData(fullData, query, options);
+        }
+    }
+
+    return results;
+}
+
+QVector<SearchResult> SearchManager::searchTextData(const PageTextData& textData,
+                                                    const QString& query,
+                                                    const SearchOptions& options)
+{
+    if (options.foldInsensitive && !textData.foldedText.isEmpty()) {
+        return searchFoldedText(textData, query, options);
+    }
+
+    QVector<SearchResult> results;
+    const int pageIndex = textData.pageIndex;
+
     // 在缓存的文本数据中搜索
     QString searchQuery = query;
     if (!options.caseSensitive) {
         searchQuery = searchQuery.toLower();
     }
 
+    // 行内含辅助平面字符时的 UTF-16 下标 -> 行内字符索引
+    QVector<int> utf16ToChar;
+
     // 遍历所有文本块
-    for (const TextBlock& block : textData.blocks) {
-        for (const TextLine& line : block.lines) {
-            // 构建当前行的文本
-            QString lineText;
-            QVector<TextChar> lineChars;
+    for (int b = 0; b < textData.blockCount(); ++b) {
+        for (int l = 0; l < textData.lineCount(b); ++l) {
+            const int lineOrdinal = textData.lineOrdinal(b, l);
+            const int lineFirst = textData.lineCharStarts[lineOrdinal];
+            const int lineEnd = lineFirst + textData.lineCharCount(lineOrdinal);
 
-            for (const TextChar& ch : line.chars) {
-                QString charStr = QString(ch.character);
-                if (!options.caseSensitive) {
-                    charStr = charStr.toLower();
+            // 构建当前行的文本
+            QString lineText = textData.lineText(lineOrdinal, &utf16ToChar);
+            if (!options.caseSensitive) {
+                for (QChar& ch : lineText) {
+                    ch = ch.toLower();
                 }
-                lineText.append(charStr);
-                lineChars.append(ch);
             }
 
+            auto charIndexAt = [&utf16ToChar](int utf16Pos) {
+                return utf16ToChar.isEmpty() ? utf16Pos : utf16ToChar[utf16Pos];
+            };
+
             // 在行文本中查找匹配
             int pos = 0;
             while ((pos = lineText.indexOf(searchQuery, pos)) != -1) {
-                // 如果要求全词匹配，检查边界
+                int endPos = pos + searchQuery.length();
+                if (endPos > lineText.size()) {
+                    break;
+                }
+
+                const int charStart = charIndexAt(pos);
+                const int charEnd = charIndexAt(endPos - 1) + 1;
+
+                // 如果要求全词匹配，检查边界（中文按分词索引，其余按字母数字）
                 if (options.wholeWords) {
-                    bool validStart = (pos == 0 || !lineText[pos - 1].isLetterOrNumber());
-                    bool validEnd = (pos + searchQuery.length() >= lineText.length() ||
-                                     !lineText[pos + searchQuery.length()].isLetterOrNumber());
+                    bool validStart;
+                    if (!wordIndexEdge(textData, lineFirst + charStart, lineFirst, lineEnd,
+                                       &validStart)) {
+                        validStart = (pos == 0 || !lineText[pos - 1].isLetterOrNumber());
+                    }
+
+                    bool validEnd;
+                    if (!wordIndexEdge(textData, lineFirst + charEnd, lineFirst, lineEnd,
+                                       &validEnd)) {
+                        validEnd = (endPos >= lineText.length() ||
+                                    !lineText[endPos].isLetterOrNumber());
+                    }
 
                     if (!validStart || !validEnd) {
                         pos++;
@@ -330,30 +477,21 @@ QVector<SearchResult> SearchManager::searchPage(int pageIndex,
 
                 SearchResult result(pageIndex);
 
-                // 计算匹配文本的边界框
-                int endPos = pos + searchQuery.length();
-                if (endPos > lineChars.size()) {
-                    break;
-                }
-
                 // 合并匹配字符的边界框
-                QRectF matchRect;
-                for (int i = pos; i < endPos; ++i) {
-                    if (matchRect.isNull()) {
-                        matchRect = lineChars[i].bbox;
-                    } else {
-                        matchRect = matchRect.united(lineChars[i].bbox);
-                    }
-                }
+                result.quads.append(textData.charRangeRect(lineFirst + charStart,
+                                                           charEnd - charStart));
 
-                result.quads.append(matchRect);
-                result.context = getContextFromTextData(textData, block, line, pos, 30);
+                // 只记录位置，上下文在显示时再生成
+                result.blockIndex = b;
+                result.lineIndex = l;
+                result.charStart = charStart;
+                result.length = charEnd - charStart;
 
                 results.append(result);
 
                 pos++;  // 继续查找下一个匹配
 
-                if (results.size() >= options.maxResults) {
+                if (options.maxResults > 0 && results.size() >= options.maxResults) {
                     // 直接返回，不再继续
                     return results;
                 }
@@ -364,37 +502,166 @@ QVector<SearchResult> SearchManager::searchPage(int pageIndex,
     return results;
 }
 
-QString SearchManager::getContextFromTextData(const PageTextData& textData,
-                                              const TextBlock& currentBlock,
-                                              const TextLine& currentLine,
-                                              int matchPos,
-                                              int contextLength)
+QVector<SearchResult> SearchManager::searchFoldedText(const PageTextData& textData,
+                                                      const QString& query,
+                                                      const SearchOptions& options)
 {
-    Q_UNUSED(textData);
-    Q_UNUSED(currentBlock);
+    QVector<SearchResult> results;
+    const int pageIndex = textData.pageIndex;
 
-    // 构建当前行的完整文本
-    QString lineText;
-    for (const TextChar& ch : currentLine.chars) {
-        lineText.append(ch.character);
+    // 只折叠查询串，页面的折叠文本在提取时已生成
+    const QString foldedQuery = TextFolding::foldString(query);
+    if (foldedQuery.isEmpty()) {
+        return results;
     }
 
-    int start = qMax(0, matchPos - contextLength);
-    int end = qMin(lineText.length(), matchPos + contextLength);
+    const QString& foldedText = textData.foldedText;
+
+    int pos = 0;
+    while ((pos = foldedText.indexOf(foldedQuery, pos)) != -1) {
+        int endPos = pos + foldedQuery.length();
+
+        // 通过映射表还原到原字符
+        int firstChar = TextFolding::foldedToCharOrdinal(textData, pos);
+        int lastChar = TextFolding::foldedToCharOrdinal(textData, endPos - 1);
+
+        int b = -1, l = -1, c = -1;
+        if (firstChar < 0 || lastChar < firstChar ||
+            !textData.locateChar(firstChar, &b, &l, &c)) {
+            pos++;
+            continue;
+        }
+
+        int length = lastChar - firstChar + 1;
+        if (c + length > textData.charCount(b, l)) {
+            pos++;
+            continue;
+        }
+
+        // 如果要求全词匹配，检查边界（中文按分词索引，其余按折叠文本的字母数字）
+        if (options.wholeWords) {
+            const int lineFirst = firstChar - c;
+            const int lineEnd = lineFirst + textData.charCount(b, l);
+
+            bool validStart;
+            if (!wordIndexEdge(textData, firstChar, lineFirst, lineEnd, &validStart)) {
+                validStart = (pos == 0 || !foldedText[pos - 1].isLetterOrNumber());
+            }
+
+            bool validEnd;
+            if (!wordIndexEdge(textData, lastChar + 1, lineFirst, lineEnd, &validEnd)) {
+                validEnd = (endPos >= foldedText.length() ||
+                            !foldedText[endPos].isLetterOrNumber());
+            }
 
-    QString context = lineText.mid(start, end - start);
+            if (!validStart || !validEnd) {
+                pos++;
+                continue;
+            }
+        }
+
+        // 合并匹配字符的边界框
+        QRectF matchRect = textData.charRangeRect(firstChar, length);
+
+        SearchResult result(pageIndex);
+        result.quads.append(matchRect);
+        result.blockIndex = b;
+        result.lineIndex = l;
+        result.charStart = c;
+        result.length = length;
+        results.append(result);
+
+        pos++;  // 继续查找下一个匹配
+
+        if (options.maxResults > 0 && results.size() >= options.maxResults) {
+            return results;
+        }
+    }
+
+    return results;
+}
+
+QString SearchManager::buildContext(const PageTextData& textData,
+                                    const SearchResult& result,
+                                    int contextLength)
+{
+    if (result.blockIndex < 0 || result.blockIndex >= textData.blockCount()) {
+        return QString();
+    }
+
+    if (result.lineIndex < 0 || result.lineIndex >= textData.lineCount(result.blockIndex)) {
+        return QString();
+    }
+
+    // 只取匹配附近的字符，不构建整行
+    const int lineOrdinal = textData.lineOrdinal(result.blockIndex, result.lineIndex);
+    const int lineFirst = textData.lineCharStarts[lineOrdinal];
+    const int lineCount = textData.lineCharCount(lineOrdinal);
+    int start = qMax(0, result.charStart - contextLength);
+    int end = qMin(lineCount, result.charStart + contextLength);
+
+    QString context;
+    context.reserve(end - start + 6);
 
     // 添加省略号
     if (start > 0) {
-        context = "..." + context;
+        context.append(QStringLiteral("..."));
     }
-    if (end < lineText.length()) {
-        context = context + "...";
+    if (end > start) {
+        context.append(QString::fromUcs4(textData.codepoints.constData() + lineFirst + start,
+                                         end - start));
+    }
+    if (end < lineCount) {
+        context.append(QStringLiteral("..."));
     }
 
     return context;
 }
 
+QString SearchManager::resultContext(const SearchResult& result)
+{
+    if (!result.context.isEmpty()) {
+        return result.context;
+    }
+
+    if (!m_textCacheManager || result.pageIndex < 0) {
+        return QString();
+    }
+
+    PageTextData textData = m_textCacheManager->ensurePageTextData(result.pageIndex);
+    return buildContext(textData, result);
+}
+
+QVector<SearchResult> SearchManager::resultsPage(int offset, int count)
+{
+    SearchResultSnapshotPtr snapshot = resultSnapshot();
+
+    QVector<SearchResult> page;
+    if (offset < 0 || offset >= snapshot->totalMatches() || count <= 0) {
+        return page;
+    }
+
+    int end = qMin(snapshot->totalMatches(), offset + count);
+    page.reserve(end - offset);
+
+    // 同页结果共用一次文本数据获取
+    int cachedPage = -1;
+    PageTextData textData;
+    for (int i = offset; i < end; ++i) {
+        SearchResult result = snapshot->at(i);
+        if (result.context.isEmpty()) {
+            if (result.pageIndex != cachedPage) {
+                textData = m_textCacheManager->ensurePageTextData(result.pageIndex);
+                cachedPage = result.pageIndex;
+            }
+            result.context = buildContext(textData, result);
+        }
+        page.append(result);
+    }
+
+    return page;
+}
+
 // ----------------- SearchWorker 实现 -----------------
 
 SearchWorker::SearchWorker(SearchManager* manager,
@@ -451,14 +718,10 @@ void SearchWorker::process()
     }
 
     if (!pageResults.isEmpty()) {
-        // 将结果追加到 manager（在追加时使用 manager 的 mutex 保护）
-        {
-            QMutexLocker locker(&m_manager->m_mutex);
-            for (const SearchResult& r : pageResults) {
-                m_manager->m_results.append(r);
-            }
-            totalMatches = pageResults.size();
-        }
+        // 按页追加到 manager 并发布新快照
+        m_manager->appendPageResults(pageIndex, pageResults);
+        totalMatches = pageResults.size();
+        emit resultsAvailable(m_manager->totalMatches());
     }
 
     // 发送进度（这里仅用于单页显示）
@@ -9,7 +9,10 @@
 #include <QThread>
 #include <QPointer>
 #include <QStringList>
+#include <QHash>
+#include <algorithm>
 #include <atomic>
+#include <memory>
 
 #include "datastructure.h"
 
@@ -21,12 +24,55 @@ class PerThreadMuPDFRenderer;
 class TextCacheManager;
 class SearchManager;
 struct PageTextData;
-struct TextBlock;
-struct TextLine;
-struct TextChar;
 
 
 
+// ========== 搜索结果快照 ==========
+
+/**
+ * @brief 搜索结果只读快照
+ *
+ * 每次追加的一页结果存为一个不可变的块，块按追加顺序连接成全局顺序
+ * （上一个/下一个导航），chunkStarts 为各块起始的全局索引（前缀计数）。
+ * 快照发布后不再修改，读者（绘制路径）持有 shared_ptr 即可无锁访问，
+ * 写者（搜索线程）每次追加都生成新快照并原子替换：新快照与旧快照共享
+ * 已有的块，只复制块索引和变化的那一页的桶，不复制结果本身。
+ */
+struct SearchResultSnapshot
+{
+    using Chunk = std::shared_ptr<const QVector<SearchResult>>;
+
+    QVector<Chunk> chunks;                  ///< 结果块（一次追加一块，导航顺序）
+    QVector<int> chunkStarts;               ///< 各块第一个结果的全局索引
+    QHash<int, QVector<int>> pageChunks;    ///< 页码 -> 该页的块序号
+    int total = 0;
+
+    int totalMatches() const { return total; }
+
+    /**
+     * @brief 按全局索引获取结果（索引必须在 [0, totalMatches()) 内）
+     */
+    const SearchResult& at(int globalIndex) const
+    {
+        const int chunk = int(std::upper_bound(chunkStarts.cbegin(), chunkStarts.cend(), globalIndex)
+                              - chunkStarts.cbegin()) - 1;
+        return chunks[chunk]->at(globalIndex - chunkStarts[chunk]);
+    }
+
+    /**
+     * @brief 获取指定页的块序号（不存在时返回空列表，不拷贝）
+     * 块 c 中第 i 个结果的全局索引为 chunkStarts[c] + i
+     */
+    const QVector<int>& pageChunkIndices(int pageIndex) const
+    {
+        static const QVector<int> emptyList;
+        auto it = pageChunks.constFind(pageIndex);
+        return it == pageChunks.constEnd() ? emptyList : it.value();
+    }
+};
+
+using SearchResultSnapshotPtr = std::shared_ptr<const SearchResultSnapshot>;
+
 // ========== 搜索工作线程 ==========
 
 class SearchWorker : public QObject
@@ -45,6 +91,7 @@ public slots:
 
 signals:
     void progress(int currentPage, int totalPages, int matchCount);
+    void resultsAvailable(int totalMatches);
     void finished(const QString& query, int totalMatches);
     void cancelled();
     void error(const QString& errorMsg);
@@ -81,11 +128,29 @@ public:
     QVector<SearchResult> getPageResults(int pageIndex) const;
     int totalMatches() const;
 
+    /**
+     * @brief 获取当前结果快照（无锁，供绘制路径使用）
+     */
+    SearchResultSnapshotPtr resultSnapshot() const;
+
+    /**
+     * @brief 分页获取结果（附带按需生成的上下文）
+     * @param offset 起始全局索引
+     * @param count 数量
+     */
+    QVector<SearchResult> resultsPage(int offset, int count);
+
+    /**
+     * @brief 获取单个结果的上下文（按需生成，不修改快照）
+     */
+    QString resultContext(const SearchResult& result);
+
     // 当前匹配导航
     int currentMatchIndex() const;
     void setCurrentMatchIndex(int index);
     SearchResult nextMatch();
     SearchResult previousMatch();
+    SearchResult matchAt(int index);
 
     // 结果管理
     void clearResults();
@@ -95,8 +160,25 @@ public:
     QStringList getHistory(int maxCount = 10) const;
     void clearHistory();
 
+    /**
+     * @brief 在单页文本数据中搜索（无状态，可在任意线程调用）
+     *
+     * 单文档搜索与多文档搜索共用此匹配逻辑
+     */
+    static QVector<SearchResult> searchTextData(const PageTextData& textData,
+                                                const QString& query,
+                                                const SearchOptions& options);
+
+    /**
+     * @brief 根据结果记录的位置生成上下文（只读取匹配附近的字符）
+     */
+    static QString buildContext(const PageTextData& textData,
+                                const SearchResult& result,
+                                int contextLength = 30);
+
 signals:
     void searchProgress(int currentPage, int totalPages, int matchCount);
+    void searchResultsAvailable(int totalMatches);  // 有新结果可分页读取
     void searchCompleted(const QString& query, int totalMatches);
     void searchCancelled();
     void searchError(const QString& error);
@@ -109,18 +191,25 @@ private:
                                      const QString& query,
                                      const SearchOptions& options);
 
-    // 辅助方法：从文本数据中提取上下文
-    QString getContextFromTextData(const PageTextData& textData,
-                                   const TextBlock& currentBlock,
-                                   const TextLine& currentLine,
-                                   int matchPos,
-                                   int contextLength);
+    // 在折叠影子文本中搜索（忽略变音/全半角/大小写）
+    static QVector<SearchResult> searchFoldedText(const PageTextData& textData,
+                                                  const QString& query,
+                                                  const SearchOptions& options);
+
+    // 追加一页的结果并发布新快照
+    void appendPageResults(int pageIndex, const QVector<SearchResult>& pageResults);
+
+    // 原子发布快照
+    void publishSnapshot(SearchResultSnapshotPtr snapshot);
+
+    // 把当前结果所在页固定在文本缓存中（pageIndex < 0 时解除）
+    void pinCurrentMatchPage(int pageIndex);
 
     PerThreadMuPDFRenderer* m_renderer;
     TextCacheManager* m_textCacheManager;
 
-    // 搜索结果
-    QVector<SearchResult> m_results;
+    // 搜索结果（只通过 std::atomic_load/atomic_store 访问）
+    SearchResultSnapshotPtr m_snapshot;
     int m_currentMatchIndex;
 
     // 当前搜索
@@ -128,7 +217,7 @@ private:
     SearchOptions m_currentOptions;
 
     // 搜索状态
-    mutable QMutex m_mutex; // 保护 m_results, m_currentMatchIndex, m_searchHistory 等共享数据
+    mutable QMutex m_mutex; // 串行化快照写入，保护 m_currentMatchIndex, m_searchHistory 等共享数据
     std::atomic_bool m_isSearching;
     std::atomic_bool m_cancelRequested;
     QPointer<QThread> m_workerThread;
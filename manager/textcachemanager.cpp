@@ -1,5 +1,7 @@
 #include "textcachemanager.h"
 #include "perthreadmupdfrenderer.h"
+#include "chinesetokenizer.h"
+#include "appconfig.h"
 #include <QDebug>
 #include <QMutexLocker>
 #include <QCoreApplication>
@@ -7,131 +9,108 @@
 #include <QMetaObject>
 #include <QThread>
 #include <QVector>
-#include <memory>
+#include <QDeadlineTimer>
+#include <QElapsedTimer>
+#include <climits>
 
 // ========================================
-// PageExtractTask - 批处理文本提取任务
+// PageExtractWorker - 文本提取工作线程
 // ========================================
-class PageExtractTask : public QRunnable
+class PageExtractWorker : public QRunnable
 {
 public:
-    PageExtractTask(TextCacheManager* manager,
-                    const QString& pdfPath,
-                    const QVector<int>& pageIndices)
+    PageExtractWorker(TextCacheManager* manager, const QString& pdfPath, int generation)
         : m_manager(manager)
         , m_pdfPath(pdfPath)
-        , m_pageIndices(pageIndices)
-        , m_renderer(nullptr)
+        , m_generation(generation)
     {
         setAutoDelete(true);
     }
 
     void run() override
     {
-        if (!m_manager || m_pageIndices.isEmpty()) {
-            qWarning() << "PageExtractTask: Invalid manager or empty page list";
-            return;
-        }
-
-        // 检查取消
-        if (m_manager->m_cancelRequested.loadAcquire()) {
-            qDebug() << "PageExtractTask: Cancelled before start, pages:" << m_pageIndices;
-            reportAllFailed();
-            return;
-        }
-
-        // 创建独立的渲染器实例（线程安全）
-        // 一个 task 共享一个 renderer 实例，避免重复打开文档
-        qDebug() << "PageExtractTask: Creating renderer for batch, pages:" << m_pageIndices.size()
-                 << "first:" << m_pageIndices.first() << "last:" << m_pageIndices.last();
+        // 每个工作线程持有独立的渲染器，逐页从优先队列取任务
+        PerThreadMuPDFRenderer renderer(m_pdfPath);
 
-        m_renderer = std::make_unique<PerThreadMuPDFRenderer>(m_pdfPath);
-
-        if (!m_renderer->isDocumentLoaded()) {
-            qWarning() << "PageExtractTask: Failed to load document, error:"
-                       << m_renderer->getLastError();
-            reportAllFailed();
+        if (!renderer.isDocumentLoaded()) {
+            qWarning() << "PageExtractWorker: Failed to load document, error:"
+                       << renderer.getLastError();
+            m_manager->workerExited(m_generation, 0, true);
             return;
         }
 
-        int totalPages = m_renderer->pageCount();
-        qDebug() << "PageExtractTask: Document loaded successfully, total pages:" << totalPages;
-
-        // 批量提取文本
         int successCount = 0;
         int failCount = 0;
+        int pageIndex = -1;
+        bool fullGeometry = false;
+        bool cacheText = true;
+        qint64 busyNs = 0;
+        QElapsedTimer pageTimer;
 
-        for (int pageIndex : m_pageIndices) {
-            // 每页处理前都检查取消
-            if (m_manager->m_cancelRequested.loadAcquire()) {
-                qDebug() << "PageExtractTask: Cancelled at page" << pageIndex;
-                reportDone(pageIndex, PageTextData(), false);
-                failCount++;
-                continue;
-            }
+        while ((pageIndex = m_manager->takeNextPage(m_generation, &fullGeometry, &cacheText)) >= 0) {
+            pageTimer.start();
 
-            // 验证页面索引
-            if (pageIndex < 0 || pageIndex >= totalPages) {
-                qWarning() << "PageExtractTask: Invalid page index" << pageIndex
-                           << "total pages:" << totalPages;
-                reportDone(pageIndex, PageTextData(), false);
-                failCount++;
-                continue;
-            }
-
-            // 提取文本
+            // 一次加载页面完成文本提取和页面分析；空白页也算成功，只有 MuPDF 出错才算失败
             PageTextData pageData;
-
-            m_renderer->extractText(pageIndex, pageData);
-
-            // 区分空白页和真正的错误
-            QString error = m_renderer->getLastError();
-            bool hasError = !error.isEmpty();
-            bool isBlankPage = pageData.blocks.isEmpty() && !hasError;
-            bool success = !hasError; // 只要没有错误就算成功（空白页也是成功）
-
-            if (hasError) {
-                qWarning() << "PageExtractTask: Failed to extract text from page" << pageIndex
+            PageAnalysis analysis;
+            QString error;
+            bool success = renderer.analyzePage(pageIndex, pageData, analysis,
+                                                fullGeometry ? TextExtractDetail::Full
+                                                             : TextExtractDetail::TextOnly,
+                                                &error);
+
+            if (!success) {
+                qWarning() << "PageExtractWorker: Failed to extract text from page" << pageIndex
                            << "Error:" << error;
                 failCount++;
-            } else if (isBlankPage) {
-                qDebug() << "PageExtractTask: Page" << pageIndex
-                         << "is blank (no text content)";
-                successCount++;
             } else {
                 successCount++;
+                if (!pageData.isEmpty()) {
+                    buildWordIndex(pageData);
+                }
+
+                // 写入磁盘文本层（空白页也保存，避免下次重新提取）
+                m_manager->m_textStore.appendPage(m_pdfPath, pageData, &analysis);
             }
 
-            reportDone(pageIndex, pageData, success);
+            const qint64 elapsedNs = pageTimer.nsecsElapsed();
+            busyNs += elapsedNs;
+
+            if (elapsedNs / 1000000 >= AppConfig::instance().textSlowPageLogMs()) {
+                qDebug() << "PageExtractWorker: Slow page" << pageIndex
+                         << "took" << elapsedNs / 1000000 << "ms"
+                         << "chars:" << pageData.totalCharCount();
+            }
+
+            m_manager->finishPage(m_generation, pageIndex, pageData, analysis, success, cacheText,
+                                  elapsedNs);
         }
 
-        qDebug() << "PageExtractTask: Batch completed"
+        qDebug() << "PageExtractWorker: Exiting"
                  << "success:" << successCount
                  << "failed:" << failCount
-                 << "pages:" << m_pageIndices.size();
+                 << "busy:" << busyNs / 1000000 << "ms";
+
+        m_manager->workerExited(m_generation, busyNs);
     }
 
 private:
-    void reportDone(int pageIndex, const PageTextData& data, bool ok)
+    // 在工作线程中为中文文本建立分词索引，搜索时无需再分词
+    void buildWordIndex(PageTextData& data)
     {
-        QMetaObject::invokeMethod(m_manager, "handleTaskDone",
-                                  Qt::QueuedConnection,
-                                  Q_ARG(int, pageIndex),
-                                  Q_ARG(PageTextData, data),
-                                  Q_ARG(bool, ok));
-    }
+        if (!AppConfig::instance().searchCJKWordIndex()) {
+            return;
+        }
 
-    void reportAllFailed()
-    {
-        for (int pageIndex : m_pageIndices) {
-            reportDone(pageIndex, PageTextData(), false);
+        ChineseTokenizer& tokenizer = ChineseTokenizer::instance();
+        if (tokenizer.ensureInitialized(AppConfig::instance().jiebaDictDir())) {
+            tokenizer.buildWordIndex(data);
         }
     }
 
     TextCacheManager* m_manager;
     QString m_pdfPath;
-    QVector<int> m_pageIndices;
-    std::unique_ptr<PerThreadMuPDFRenderer> m_renderer;
+    int m_generation;
 };
 
 // ========================================
@@ -140,13 +119,28 @@ private:
 TextCacheManager::TextCacheManager(PerThreadMuPDFRenderer* renderer, QObject* parent)
     : QObject(parent)
     , m_renderer(renderer)
-    , m_maxCacheSize(-1)
+    , m_cacheBytes(0)
+    , m_evictionCount(0)
+    , m_cacheGeneration(0)
+    , m_maxCacheBytes(AppConfig::instance().maxTextCacheBytes())
     , m_isPreloading(0)
     , m_cancelRequested(0)
     , m_preloadedPages(0)
+    , m_reportedProgress(-1)
+    , m_generation(0)
+    , m_analysisOnly(false)
+    , m_pageCount(0)
+    , m_focusPage(0)
+    , m_forwardCursor(0)
+    , m_backwardCursor(-1)
+    , m_activeWorkers(0)
+    , m_runningWorkers(0)
     , m_hitCount(0)
     , m_missCount(0)
 {
+    m_progressTimer.setInterval(AppConfig::instance().textProgressIntervalMs());
+    connect(&m_progressTimer, &QTimer::timeout,
+            this, &TextCacheManager::reportProgress);
 }
 
 TextCacheManager::~TextCacheManager()
@@ -156,7 +150,7 @@ TextCacheManager::~TextCacheManager()
     clear();
 }
 
-void TextCacheManager::startPreload()
+void TextCacheManager::startPreload(int focusPage, bool analysisOnly)
 {
     if (!m_renderer) {
         emit preloadError(QStringLiteral("No renderer assigned"));
@@ -177,77 +171,354 @@ void TextCacheManager::startPreload()
         return;
     }
 
-    // 如果已有预加载在运行，先取消
-    if (m_isPreloading.loadAcquire()) {
-        cancelPreload();
-        for (int i = 0; i < 30 && m_isPreloading.loadAcquire(); ++i) {
-            QThread::msleep(50);
-            QCoreApplication::processEvents();
-        }
-    }
-
     int pageCount = m_renderer->pageCount();
     if (pageCount <= 0) {
         emit preloadError(QStringLiteral("Invalid page count"));
         return;
     }
 
-    // 设置并发状态
-    m_isPreloading.storeRelease(1);
-    m_cancelRequested.storeRelease(0);
-    m_preloadedPages.storeRelease(0);
-    m_remainingTasks.storeRelease(pageCount);
+    // 映射磁盘文本层，已保存的页无需再提取
+    if (AppConfig::instance().textLayerStoreEnabled()) {
+        QString storeError;
+        if (!m_textStore.open(pdfPath, pageCount, &storeError)) {
+            qWarning() << "TextCacheManager: Text layer store unavailable:" << storeError;
+        }
+    }
+
+    // 收集需要处理的页面（跳过已缓存或已在磁盘文本层中的）
+    QVector<PageState> states(pageCount, PageIdle);
+    int pagesToProcess = 0;
+    for (int i = 0; i < pageCount; ++i) {
+        if (!contains(i)) {
+            states[i] = PageQueued;
+            ++pagesToProcess;
+        }
+    }
 
     // 配置线程池（使用一半的CPU核心）
     int threadCount = qMax(4, QThread::idealThreadCount() / 2);
     m_threadPool.setMaxThreadCount(threadCount);
+    int workerCount = qMin(threadCount, pagesToProcess);
 
-    // 计算每个批次的大小
-    // 批次大小 = ceil(页数 / 线程数)，确保页面均匀分布
-    int batchSize = qMax(1, (pageCount + threadCount - 1) / threadCount);
+    int generation = 0;
+    {
+        // 新一代队列：上一次预加载遗留的工作线程取不到任务后自行退出
+        QMutexLocker locker(&m_queueMutex);
+        generation = ++m_generation;
+        m_pdfPath = pdfPath;
+        m_pageStates = states;
+        m_urgentPages.clear();
+        m_geometryPages.clear();
+        m_notifyPages.clear();
+        m_analysisOnly = analysisOnly;
+        m_pageCount = pageCount;
+        m_focusPage = qBound(0, focusPage, pageCount - 1);
+        m_forwardCursor = m_focusPage;
+        m_backwardCursor = m_focusPage - 1;
+        m_activeWorkers = workerCount;
+        m_runningWorkers = workerCount;
+        m_pageFinished.wakeAll();
+
+        m_timings = PreloadTimings();
+        m_timings.workers = workerCount;
+        m_preloadTimer.start();
+
+        QMutexLocker cacheLocker(&m_mutex);
+        m_cacheGeneration = generation;
+    }
 
-    qDebug() << "TextCacheManager: Starting preload for" << pageCount << "pages"
-             << "with" << threadCount << "threads"
-             << "batch size:" << batchSize;
+    setPinnedPages(PinCurrent, QSet<int>{qBound(0, focusPage, pageCount - 1)});
 
-    // 收集需要处理的页面（跳过已缓存的）
-    QVector<int> pagesToProcess;
-    for (int i = 0; i < pageCount; ++i) {
+    {
         QMutexLocker locker(&m_mutex);
-        if (m_cache.contains(i)) {
-            // 已在缓存中，直接计数
-            m_preloadedPages.ref();
-            m_remainingTasks.fetchAndSubRelaxed(1);
-            emit preloadProgress(m_preloadedPages.loadAcquire(), pageCount);
+        if (m_analysis.size() != pageCount) {
+            m_analysis = QVector<PageAnalysis>(pageCount);
+        }
+    }
+
+    // 设置并发状态
+    m_cancelRequested.storeRelease(0);
+    m_preloadedPages.storeRelease(pageCount - pagesToProcess);
+    m_reportedProgress = -1;
+    reportProgress();
+
+    // Edge case: 所有页都已可用
+    if (workerCount == 0) {
+        m_isPreloading.storeRelease(0);
+        emit preloadCompleted();
+        return;
+    }
+
+    m_isPreloading.storeRelease(1);
+    m_progressTimer.start();
+
+    qDebug() << "TextCacheManager: Starting preload for" << pagesToProcess
+             << "of" << pageCount << "pages"
+             << "with" << workerCount << "workers"
+             << "focus page:" << m_focusPage
+             << (analysisOnly ? "(analysis only)" : "");
+
+    for (int i = 0; i < workerCount; ++i) {
+        m_threadPool.start(new PageExtractWorker(this, pdfPath, generation));
+    }
+}
+
+void TextCacheManager::setFocusPage(int pageIndex)
+{
+    setPinnedPages(PinCurrent, QSet<int>{pageIndex});
+
+    QMutexLocker locker(&m_queueMutex);
+
+    if (pageIndex < 0 || pageIndex >= m_pageCount || pageIndex == m_focusPage) {
+        return;
+    }
+
+    // 重置游标，之后的取页从新位置由近及远展开
+    m_focusPage = pageIndex;
+    m_forwardCursor = pageIndex;
+    m_backwardCursor = pageIndex - 1;
+}
+
+int TextCacheManager::takeNextPage(int generation, bool* fullGeometry, bool* cacheText)
+{
+    QMutexLocker locker(&m_queueMutex);
+
+    if (generation != m_generation) {
+        return -1;
+    }
+
+    int pageIndex = -1;
+    bool urgent = false;
+
+    // 1. 按需请求（取消预加载后仍然处理）
+    while (!m_urgentPages.isEmpty() && pageIndex < 0) {
+        int candidate = m_urgentPages.takeFirst();
+        if (m_pageStates.value(candidate, PageIdle) == PageQueued) {
+            pageIndex = candidate;
+            urgent = true;
+        }
+    }
+
+    // 2. 焦点页附近由近及远，窗口外先向后再向前
+    if (pageIndex < 0 && m_isPreloading.loadAcquire() && !m_cancelRequested.loadAcquire()) {
+        while (m_forwardCursor < m_pageCount && m_pageStates[m_forwardCursor] != PageQueued) {
+            ++m_forwardCursor;
+        }
+        while (m_backwardCursor >= 0 && m_pageStates[m_backwardCursor] != PageQueued) {
+            --m_backwardCursor;
+        }
+
+        const int window = AppConfig::instance().textPreloadPriorityPages();
+        const int forwardDistance = (m_forwardCursor < m_pageCount)
+                                        ? m_forwardCursor - m_focusPage : INT_MAX;
+        const int backwardDistance = (m_backwardCursor >= 0)
+                                         ? m_focusPage - m_backwardCursor : INT_MAX;
+
+        if (backwardDistance < forwardDistance && backwardDistance <= window) {
+            pageIndex = m_backwardCursor;
+        } else if (m_forwardCursor < m_pageCount) {
+            pageIndex = m_forwardCursor;
+        } else if (m_backwardCursor >= 0) {
+            pageIndex = m_backwardCursor;
+        }
+    }
+
+    if (pageIndex < 0) {
+        // 该线程不再取页：立即不计入活动线程，此后的按需请求会另起工作线程，
+        // 不会排在一个即将退出的线程上空等
+        --m_activeWorkers;
+    } else {
+        m_pageStates[pageIndex] = PageInFlight;
+        *fullGeometry = m_geometryPages.remove(pageIndex) ||
+                        !AppConfig::instance().textPreloadTextOnly();
+        *cacheText = urgent || !m_analysisOnly;
+    }
+    return pageIndex;
+}
+
+void TextCacheManager::finishPage(int generation, int pageIndex,
+                                  const PageTextData& data, const PageAnalysis& analysis,
+                                  bool ok, bool cacheText, qint64 elapsedNs)
+{
+    // 结果直接写入缓存：等待中的按需请求和主线程都无需经过事件循环。
+    // 写缓存（可能触发淘汰）不持有队列锁，其他工作线程取页不受影响
+    if (ok) {
+        QMutexLocker cacheLocker(&m_mutex);
+        if (generation != m_cacheGeneration) {
+            return;  // 过期结果
+        }
+
+        if (cacheText) {
+            insertLocked(pageIndex, data);
+        }
+        if (pageIndex < m_analysis.size()) {
+            m_analysis[pageIndex] = analysis;
+        }
+    }
+
+    bool notify = false;
+    {
+        QMutexLocker locker(&m_queueMutex);
+        if (generation != m_generation) {
+            return;  // 过期结果
+        }
+
+        if (m_isPreloading.loadAcquire()) {
+            ++m_timings.pages;
+            m_timings.workNs += elapsedNs;
+            if (elapsedNs > m_timings.slowestPageNs) {
+                m_timings.slowestPageNs = elapsedNs;
+                m_timings.slowestPage = pageIndex;
+            }
+
+            // 预加载结束后的按需提取不计入进度
+            if (ok) {
+                m_preloadedPages.ref();
+            }
+        }
+
+        if (ok && !data.hasCharBoxes() && m_geometryPages.contains(pageIndex)) {
+            // 只提取文本期间又被请求了几何信息：重新排到最前
+            m_pageStates[pageIndex] = PageQueued;
+            m_urgentPages.prepend(pageIndex);
         } else {
-            pagesToProcess.append(i);
+            m_pageStates[pageIndex] = ok ? PageIdle : PageFailed;
+            notify = m_notifyPages.remove(pageIndex);
         }
+        m_pageFinished.wakeAll();
     }
 
-    // 按批次提交任务
-    int tasksSubmitted = 0;
-    for (int i = 0; i < pagesToProcess.size(); i += batchSize) {
-        // 创建当前批次的页面列表
-        QVector<int> batch;
-        for (int j = 0; j < batchSize && (i + j) < pagesToProcess.size(); ++j) {
-            batch.append(pagesToProcess[i + j]);
+    // 跨线程信号，接收方在主线程排队处理
+    if (notify) {
+        emit pageGeometryReady(pageIndex);
+    }
+}
+
+void TextCacheManager::workerExited(int generation, qint64 busyNs, bool stillActive)
+{
+    {
+        QMutexLocker locker(&m_queueMutex);
+        if (generation != m_generation) {
+            return;
+        }
+
+        const bool preloading = m_isPreloading.loadAcquire() != 0;
+        if (preloading) {
+            if (m_timings.minWorkerBusyNs < 0 || busyNs < m_timings.minWorkerBusyNs) {
+                m_timings.minWorkerBusyNs = busyNs;
+            }
+            m_timings.maxWorkerBusyNs = qMax(m_timings.maxWorkerBusyNs, busyNs);
+        }
+
+        if (stillActive) {
+            --m_activeWorkers;
+        }
+        if (--m_runningWorkers > 0) {
+            return;
         }
 
-        if (!batch.isEmpty()) {
-            PageExtractTask* task = new PageExtractTask(this, pdfPath, batch);
-            m_threadPool.start(task);
-            ++tasksSubmitted;
+        if (preloading) {
+            m_timings.wallNs = m_preloadTimer.nsecsElapsed();
+            qDebug() << "TextCacheManager:" << m_timings.summary();
         }
     }
 
-    qDebug() << "TextCacheManager: Submitted" << tasksSubmitted << "tasks"
-             << "for" << pagesToProcess.size() << "pages";
+    QMetaObject::invokeMethod(this, "handleWorkersFinished",
+                              Qt::QueuedConnection,
+                              Q_ARG(int, generation));
+}
 
-    // Edge case: 所有页都已在缓存中
-    if (m_remainingTasks.loadAcquire() <= 0) {
-        m_isPreloading.storeRelease(0);
-        emit preloadCompleted();
+PageTextData TextCacheManager::ensurePageTextData(int pageIndex)
+{
+    PageTextData data = getPageTextData(pageIndex);
+    if (data.isValid() || !extractNow(pageIndex, false)) {
+        return data;
+    }
+
+    return getPageTextData(pageIndex);
+}
+
+PageTextData TextCacheManager::ensurePageGeometry(int pageIndex)
+{
+    PageTextData data = getPageTextData(pageIndex);
+    if ((data.isValid() && data.hasCharBoxes()) || !extractNow(pageIndex, true)) {
+        return data;
+    }
+
+    PageTextData full = getPageTextData(pageIndex);
+    return full.isValid() ? full : data;
+}
+
+PageTextData TextCacheManager::requestPageGeometry(int pageIndex)
+{
+    PageTextData data = getPageTextData(pageIndex);
+    if (data.isValid() && data.hasCharBoxes()) {
+        return data;
+    }
+
+    QMutexLocker locker(&m_queueMutex);
+    if (m_notifyPages.contains(pageIndex)) {
+        return data;    // 已在排队或提取中，拖拽选择时不重复排队
+    }
+    if (queueUrgentLocked(pageIndex, true)) {
+        m_notifyPages.insert(pageIndex);
+    }
+    return data;
+}
+
+bool TextCacheManager::extractNow(int pageIndex, bool fullGeometry)
+{
+    QMutexLocker locker(&m_queueMutex);
+
+    if (!queueUrgentLocked(pageIndex, fullGeometry)) {
+        return false;
+    }
+
+    QDeadlineTimer deadline(AppConfig::instance().textOnDemandWaitMs());
+    while (m_pageStates.value(pageIndex, PageIdle) == PageQueued ||
+           m_pageStates.value(pageIndex, PageIdle) == PageInFlight) {
+        if (!m_pageFinished.wait(&m_queueMutex, deadline)) {
+            qDebug() << "TextCacheManager: On-demand wait timed out for page" << pageIndex;
+            break;
+        }
+    }
+
+    return true;
+}
+
+bool TextCacheManager::queueUrgentLocked(int pageIndex, bool fullGeometry)
+{
+    if (pageIndex < 0 || pageIndex >= m_pageStates.size() || m_pdfPath.isEmpty()) {
+        return false;  // 尚未为当前文档开始预加载
+    }
+
+    if (m_pageStates[pageIndex] == PageFailed) {
+        return false;  // 提取失败的页不反复重试
+    }
+
+    if (fullGeometry) {
+        m_geometryPages.insert(pageIndex);
+    }
+
+    // 已提取过但被淘汰（磁盘文本层中也没有），或需要补齐几何信息：重新排队
+    if (m_pageStates[pageIndex] == PageIdle) {
+        m_pageStates[pageIndex] = PageQueued;
+    }
+
+    // 插队到最前
+    if (m_pageStates[pageIndex] == PageQueued) {
+        m_urgentPages.removeAll(pageIndex);
+        m_urgentPages.prepend(pageIndex);
+    }
+
+    // 预加载已结束（或被取消）时单独启动一个工作线程处理按需请求
+    if (m_activeWorkers == 0) {
+        ++m_activeWorkers;
+        ++m_runningWorkers;
+        m_threadPool.start(new PageExtractWorker(this, m_pdfPath, m_generation));
     }
+
+    return true;
 }
 
 void TextCacheManager::cancelPreload()
@@ -258,6 +529,10 @@ void TextCacheManager::cancelPreload()
 
     m_cancelRequested.storeRelease(1);
     qDebug() << "TextCacheManager: Cancel requested";
+
+    // 唤醒等待中的按需请求
+    QMutexLocker locker(&m_queueMutex);
+    m_pageFinished.wakeAll();
 }
 
 bool TextCacheManager::isPreloading() const
@@ -272,53 +547,186 @@ int TextCacheManager::computePreloadProgress() const
 
 PageTextData TextCacheManager::getPageTextData(int pageIndex)
 {
-    QMutexLocker locker(&m_mutex);
-    if (m_cache.contains(pageIndex)) {
-        ++m_hitCount;
-        return m_cache.value(pageIndex);
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_cache.find(pageIndex);
+        if (it != m_cache.end()) {
+            ++m_hitCount;
+            m_lru.splice(m_lru.begin(), m_lru, it->lruPos);
+            return it->data;
+        }
+        ++m_missCount;
     }
-    ++m_missCount;
+
+    // 内存中没有（未加载或已被淘汰）时从磁盘文本层读取
+    PageTextData data;
+    if (m_textStore.loadPage(pageIndex, data)) {
+        addPageTextData(pageIndex, data);
+        return data;
+    }
+
     return PageTextData();
 }
 
 void TextCacheManager::addPageTextData(int pageIndex, const PageTextData& data)
 {
     QMutexLocker locker(&m_mutex);
+    insertLocked(pageIndex, data);
+}
 
-    // 如果超过最大缓存大小，移除最旧的条目
-    if (m_maxCacheSize > 0 && m_cache.size() >= m_maxCacheSize) {
-        if (!m_cache.isEmpty()) {
-            auto it = m_cache.begin();
-            m_cache.erase(it);
+void TextCacheManager::insertLocked(int pageIndex, const PageTextData& data)
+{
+    auto it = m_cache.find(pageIndex);
+    if (it == m_cache.end()) {
+        m_lru.push_front(pageIndex);
+        it = m_cache.insert(pageIndex, CacheEntry());
+        it->lruPos = m_lru.begin();
+    } else {
+        m_cacheBytes -= it->bytes;
+        m_lru.splice(m_lru.begin(), m_lru, it->lruPos);
+    }
+
+    it->data = data;
+    it->bytes = data.memoryBytes();
+    m_cacheBytes += it->bytes;
+
+    evictLocked(pageIndex);
+}
+
+void TextCacheManager::evictLocked(int keepPage)
+{
+    if (m_maxCacheBytes < 0) {
+        return;
+    }
+
+    // 从最久未访问的一端淘汰，跳过固定页面；剩下的都是固定页面时允许暂时超出预算
+    auto pos = m_lru.end();
+    while (m_cacheBytes > m_maxCacheBytes && pos != m_lru.begin()) {
+        --pos;
+        const int pageIndex = *pos;
+        if (pageIndex == keepPage || m_pins.contains(pageIndex)) {
+            continue;
         }
+
+        auto victim = m_cache.find(pageIndex);
+        m_cacheBytes -= victim->bytes;
+        m_cache.erase(victim);
+        pos = m_lru.erase(pos);
+        ++m_evictionCount;
     }
+}
 
-    m_cache.insert(pageIndex, data);
+void TextCacheManager::setPinnedPages(PinReason reason, const QSet<int>& pages)
+{
+    QMutexLocker locker(&m_mutex);
+    setPinnedLocked(reason, pages);
+}
+
+void TextCacheManager::setPinnedLocked(PinReason reason, const QSet<int>& pages)
+{
+    for (auto it = m_pins.begin(); it != m_pins.end();) {
+        if (pages.contains(it.key())) {
+            it.value() |= reason;
+            ++it;
+        } else if ((it.value() &= ~reason) == 0) {
+            it = m_pins.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    for (int pageIndex : pages) {
+        if (pageIndex >= 0 && !m_pins.contains(pageIndex)) {
+            m_pins.insert(pageIndex, reason);
+        }
+    }
+
+    // 解除固定的页面可能使缓存超出预算
+    evictLocked(-1);
+}
+
+bool TextCacheManager::pageAnalysis(int pageIndex, PageAnalysis* out) const
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (pageIndex >= 0 && pageIndex < m_analysis.size() && m_analysis[pageIndex].isValid()) {
+            if (out) {
+                *out = m_analysis[pageIndex];
+            }
+            return true;
+        }
+    }
+
+    // 之前会话保存的页不会再次分析，从磁盘文本层读取
+    PageAnalysis analysis;
+    if (!m_textStore.loadAnalysis(pageIndex, analysis)) {
+        return false;
+    }
+    if (out) {
+        *out = analysis;
+    }
+    return true;
 }
 
 bool TextCacheManager::contains(int pageIndex) const
 {
-    QMutexLocker locker(&m_mutex);
-    return m_cache.contains(pageIndex);
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_cache.contains(pageIndex)) {
+            return true;
+        }
+    }
+    return m_textStore.contains(pageIndex);
 }
 
 void TextCacheManager::clear()
 {
-    QMutexLocker locker(&m_mutex);
+    // 作废当前队列：仍在运行的工作线程的结果不会再写入缓存
+    {
+        QMutexLocker locker(&m_queueMutex);
+        ++m_generation;
+        m_pdfPath.clear();
+        m_pageStates.clear();
+        m_urgentPages.clear();
+        m_geometryPages.clear();
+        m_notifyPages.clear();
+        m_pageCount = 0;
+        m_activeWorkers = 0;
+        m_runningWorkers = 0;
+        m_pageFinished.wakeAll();
+
+        QMutexLocker cacheLocker(&m_mutex);
+        m_cacheGeneration = m_generation;
+    }
+    bool wasPreloading = m_isPreloading.fetchAndStoreRelease(0) != 0;
+    m_progressTimer.stop();
 
-    if (m_isPreloading.loadAcquire()) {
-        qWarning() << "TextCacheManager::clear() called while preload active!";
+    {
+        QMutexLocker locker(&m_mutex);
+        m_cache.clear();
+        m_lru.clear();
+        m_pins.clear();
+        m_analysis.clear();
+        m_cacheBytes = 0;
+        m_evictionCount = 0;
+        m_hitCount = 0;
+        m_missCount = 0;
     }
 
-    m_cache.clear();
-    m_hitCount = 0;
-    m_missCount = 0;
+    // 关闭当前文档的文本层，下次预加载时按新文档重新打开
+    m_textStore.close();
+
+    if (wasPreloading) {
+        qDebug() << "TextCacheManager: Preload cancelled";
+        emit preloadCancelled();
+    }
 }
 
-void TextCacheManager::setMaxCacheSize(int maxPages)
+void TextCacheManager::setMaxCacheBytes(qint64 maxBytes)
 {
     QMutexLocker locker(&m_mutex);
-    m_maxCacheSize = maxPages;
+    m_maxCacheBytes = maxBytes;
+    evictLocked(-1);
 }
 
 int TextCacheManager::cacheSize() const
@@ -327,56 +735,92 @@ int TextCacheManager::cacheSize() const
     return m_cache.size();
 }
 
+qint64 TextCacheManager::cacheBytes() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_cacheBytes;
+}
+
 QString TextCacheManager::getStatistics() const
 {
+    QString preload;
+    {
+        QMutexLocker locker(&m_queueMutex);
+        if (m_timings.pages > 0 && m_timings.wallNs > 0) {
+            preload = QString(", Last preload: %1").arg(m_timings.summary());
+        }
+    }
+
     QMutexLocker locker(&m_mutex);
     qint64 total = m_hitCount + m_missCount;
     double hitRate = (total > 0) ? (m_hitCount * 100.0 / total) : 0.0;
 
-    return QString("TextCache: %1 pages, Hit Rate: %2%, Hits: %3, Misses: %4")
+    return QString("TextCache: %1 pages (%2 MB, %3 pinned, %4 evicted), Stored: %5 pages, "
+                   "Hit Rate: %6%, Hits: %7, Misses: %8%9")
         .arg(m_cache.size())
+        .arg(m_cacheBytes / (1024.0 * 1024.0), 0, 'f', 1)
+        .arg(m_pins.size())
+        .arg(m_evictionCount)
+        .arg(m_textStore.storedPageCount())
         .arg(hitRate, 0, 'f', 1)
         .arg(m_hitCount)
-        .arg(m_missCount);
+        .arg(m_missCount)
+        .arg(preload);
 }
 
-void TextCacheManager::handleTaskDone(int pageIndex, PageTextData pageData, bool ok)
+double TextCacheManager::PreloadTimings::efficiency() const
 {
-    // 无论成功与否，都要递减剩余任务计数
-    int remaining = m_remainingTasks.fetchAndSubRelaxed(1) - 1;
-    Q_UNUSED(remaining);
+    if (wallNs <= 0 || workers <= 0) {
+        return 0.0;
+    }
+    return double(workNs) / (double(wallNs) * workers);
+}
 
-    if (ok) {
-        // 成功提取，写入缓存
-        {
-            QMutexLocker locker(&m_mutex);
-            if (m_maxCacheSize > 0 && m_cache.size() >= m_maxCacheSize) {
-                if (!m_cache.isEmpty()) {
-                    auto it = m_cache.begin();
-                    m_cache.erase(it);
-                }
-            }
-            m_cache.insert(pageIndex, pageData);
-        }
+QString TextCacheManager::PreloadTimings::summary() const
+{
+    const double avgMs = (pages > 0) ? workNs / 1e6 / pages : 0.0;
+
+    return QString("%1 pages in %2 ms with %3 workers (work %4 ms, avg %5 ms/page, "
+                   "efficiency %6%, worker busy %7-%8 ms, slowest page %9: %10 ms)")
+        .arg(pages)
+        .arg(wallNs / 1000000)
+        .arg(workers)
+        .arg(workNs / 1000000)
+        .arg(avgMs, 0, 'f', 2)
+        .arg(efficiency() * 100.0, 0, 'f', 1)
+        .arg(qMax<qint64>(0, minWorkerBusyNs) / 1000000)
+        .arg(maxWorkerBusyNs / 1000000)
+        .arg(slowestPage + 1)
+        .arg(slowestPageNs / 1000000);
+}
 
-        m_preloadedPages.ref();
+void TextCacheManager::reportProgress()
+{
+    // 被淘汰后重新提取的页可能重复计数
+    int loaded = qMin(m_preloadedPages.loadAcquire(), m_pageCount);
+    if (loaded == m_reportedProgress) {
+        return;
     }
 
-    // 发送进度信号
-    int loaded = m_preloadedPages.loadAcquire();
-    int total = loaded + qMax(0, m_remainingTasks.loadAcquire());
-    emit preloadProgress(loaded, total);
+    m_reportedProgress = loaded;
+    emit preloadProgress(loaded, m_pageCount);
+}
 
-    // 检查是否所有任务都完成
-    if (m_remainingTasks.loadAcquire() <= 0) {
-        if (m_cancelRequested.loadAcquire()) {
-            m_isPreloading.storeRelease(0);
-            qDebug() << "TextCacheManager: Preload cancelled";
-            emit preloadCancelled();
-        } else {
-            m_isPreloading.storeRelease(0);
-            qDebug() << "TextCacheManager: Preload completed";
-            emit preloadCompleted();
-        }
+void TextCacheManager::handleWorkersFinished(int generation)
+{
+    // 按需提取的工作线程退出时预加载可能早已结束
+    if (generation != m_generation || !m_isPreloading.fetchAndStoreRelease(0)) {
+        return;
+    }
+
+    m_progressTimer.stop();
+    reportProgress();
+
+    if (m_cancelRequested.loadAcquire()) {
+        qDebug() << "TextCacheManager: Preload cancelled";
+        emit preloadCancelled();
+    } else {
+        qDebug() << "TextCacheManager: Preload completed";
+        emit preloadCompleted();
     }
 }
@@ -4,20 +4,59 @@
 #include <QObject>
 #include <QHash>
 #include <QMutex>
+#include <QWaitCondition>
+#include <QList>
+#include <QSet>
 #include <QString>
 #include <QAtomicInt>
 #include <QThreadPool>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <list>
 
 #include "datastructure.h"
+#include "textlayerstore.h"
 
 class PerThreadMuPDFRenderer;
-class PageExtractTask;
+class PageExtractWorker;
 
 /**
  * @brief 文本缓存管理器
  *
  * 负责管理页面文本数据的缓存和异步预加载
  * 不直接接触 MuPDF API，所有渲染工作委托给 PerThreadMuPDFRenderer
+ *
+ * 提取结果同时写入磁盘文本层（TextLayerStore），重新打开文档时
+ * 已保存的页按需从映射文件读取，预加载只提取缺失的页
+ *
+ * 提取顺序由优先队列决定：
+ * 1. 按需请求（选择文本、搜索当前页）最先处理
+ * 2. 然后是当前页及其前后 TEXT_PRELOAD_PRIORITY_PAGES 页（由近及远）
+ * 3. 最后按阅读方向先向后、再向前处理其余页
+ * 翻页时调用 setFocusPage() 重新排定顺序
+ *
+ * 内存缓存按字节预算做 LRU 淘汰，视口内、有选择或当前搜索结果所在的页面
+ * 被固定不淘汰；被淘汰的页面再次访问时从磁盘文本层读回，文本层不可用时
+ * 通过 ensurePageTextData() 重新提取
+ *
+ * 预加载工作线程对每页执行一次 PerThreadMuPDFRenderer::analyzePage()：一次
+ * 加载页面同时得到文本、尺寸、链接和文本层/扫描页标记，分析结果随文本
+ * 一起写入磁盘文本层，供 LinkManager、OCR 等复用（pageAnalysis()）
+ *
+ * 后台预加载默认只提取文本（TextExtractDetail::TextOnly，不含字符边界框），
+ * 需要逐字符几何信息时按页补齐：后台线程用 ensurePageGeometry() 等待，
+ * 主线程（选择、命中测试）用 requestPageGeometry() 排队后立即返回，
+ * 补齐后发出 pageGeometryReady()
+ *
+ * 扫描版文档以 analysisOnly 方式预加载：仍逐页分析（供 OCR 按页判断、
+ * LinkManager 取链接），但预加载的页不进入内存缓存，只有按需请求的页才缓存
+ *
+ * 工作线程每次只取一页，先做完的线程继续取下一页，不会因为某段
+ * 图片或表格密集的页面而空等；每页耗时汇总到 PreloadTimings 中
+ *
+ * 提取结果由工作线程直接写入缓存，不逐页投递到主线程；进度由主线程
+ * 定时器按 TEXT_PROGRESS_INTERVAL_MS 节流发出，整个预加载只有结束时
+ * 一次跨线程调用
  */
 class TextCacheManager : public QObject
 {
@@ -27,52 +66,192 @@ public:
     explicit TextCacheManager(PerThreadMuPDFRenderer* renderer, QObject* parent = nullptr);
     ~TextCacheManager();
 
-    // 预加载控制
-    void startPreload();
+    // 页面固定原因（可组合），固定的页面不会被淘汰
+    enum PinReason : quint8 {
+        PinCurrent   = 0x01,    // 当前页
+        PinVisible   = 0x02,    // 在视口中
+        PinSelection = 0x04,    // 有活动的文本选择
+        PinSearch    = 0x08     // 当前搜索结果所在页
+    };
+
+    // 预加载控制（analysisOnly：只为页面分析遍历文档，预加载的页不进入内存缓存）
+    void startPreload(int focusPage = 0, bool analysisOnly = false);
     void cancelPreload();
     bool isPreloading() const;
     int computePreloadProgress() const;
 
     // 缓存访问
     PageTextData getPageTextData(int pageIndex);
+
+    /**
+     * @brief 获取页面文本，尚未提取时插队提取并等待
+     *
+     * 供选择文本、搜索等需要立即拿到文本的场景使用（可在任意线程调用）。
+     * 已被淘汰且磁盘文本层中没有的页面会重新排队提取。
+     * 尚未开始预加载或等待超时时返回 getPageTextData() 的结果。
+     */
+    PageTextData ensurePageTextData(int pageIndex);
+
+    /**
+     * @brief 获取带字符边界框的页面文本，只有文本时插队重新完整提取并等待
+     *
+     * 供文本选择、命中测试、搜索结果高亮使用。等待超时或提取失败时
+     * 返回已有的（可能只有文本的）数据。
+     */
+    PageTextData ensurePageGeometry(int pageIndex);
+
+    /**
+     * @brief 获取页面文本，没有字符边界框时插队完整提取但不等待
+     *
+     * 供主线程的文本选择、命中测试使用：立即返回已有数据（可能只有文本，
+     * 字符位置按行边界框估算，也可能为空），提取完成后发出 pageGeometryReady()
+     */
+    PageTextData requestPageGeometry(int pageIndex);
+
     void addPageTextData(int pageIndex, const PageTextData& data);
     bool contains(int pageIndex) const;
 
+    /**
+     * @brief 获取页面分析结果（尺寸、链接、是否有文本层/是否为扫描页）
+     * 本次预加载没有分析过的页从磁盘文本层读取
+     * @return 该页还没有分析结果时返回 false
+     */
+    bool pageAnalysis(int pageIndex, PageAnalysis* out) const;
+
     // 缓存管理
     void clear();
-    void setMaxCacheSize(int maxPages);
+    void setMaxCacheBytes(qint64 maxBytes);
     int cacheSize() const;
+    qint64 cacheBytes() const;
+
+    /**
+     * @brief 替换某个原因下固定的页面集合
+     */
+    void setPinnedPages(PinReason reason, const QSet<int>& pages);
 
     // 统计信息
     QString getStatistics() const;
 
+public slots:
+    /**
+     * @brief 更新阅读位置，预加载队列按新位置重新排序
+     */
+    void setFocusPage(int pageIndex);
+
 signals:
     void preloadProgress(int current, int total);
     void preloadCompleted();
     void preloadCancelled();
     void preloadError(const QString& error);
 
+    /**
+     * @brief requestPageGeometry() 请求的页面已提取完成（可能在工作线程中发出）
+     */
+    void pageGeometryReady(int pageIndex);
+
 private slots:
-    // 由 PageExtractTask 通过 QMetaObject::invokeMethod 调用
-    void handleTaskDone(int pageIndex, PageTextData pageData, bool ok);
+    // 节流发出进度信号（m_progressTimer 触发）
+    void reportProgress();
+
+    // 由最后退出的 PageExtractWorker 通过 QMetaObject::invokeMethod 调用
+    void handleWorkersFinished(int generation);
 
 private:
-    friend class PageExtractTask;
+    friend class PageExtractWorker;
+
+    // 页面在预加载队列中的状态
+    enum PageState : quint8 {
+        PageIdle = 0,       // 不需要提取（已缓存/已完成/未排队）
+        PageQueued,         // 等待提取
+        PageInFlight,       // 正在提取
+        PageFailed          // 提取失败
+    };
+
+    // 预加载计时统计（用于确认各工作线程负载是否均衡）
+    struct PreloadTimings {
+        int workers = 0;
+        int pages = 0;
+        qint64 wallNs = 0;              // 预加载总耗时
+        qint64 workNs = 0;              // 各页提取耗时之和
+        qint64 slowestPageNs = 0;
+        int slowestPage = -1;
+        qint64 minWorkerBusyNs = -1;    // 最空闲的工作线程的累计工作时间
+        qint64 maxWorkerBusyNs = 0;     // 最繁忙的工作线程的累计工作时间
+
+        // 并行效率：workNs / (wallNs * workers)，1.0 表示完全均衡
+        double efficiency() const;
+        QString summary() const;
+    };
+
+    // 把页面插到队列最前并等待提取完成（需要时启动工作线程）
+    // 页面不属于当前文档或提取失败过时返回 false
+    bool extractNow(int pageIndex, bool fullGeometry);
+
+    // 把页面插到队列最前（需要时启动工作线程），需持有 m_queueMutex
+    bool queueUrgentLocked(int pageIndex, bool fullGeometry);
+
+    // 以下由工作线程调用
+    int takeNextPage(int generation, bool* fullGeometry, bool* cacheText);
+    void finishPage(int generation, int pageIndex, const PageTextData& data,
+                    const PageAnalysis& analysis, bool ok, bool cacheText, qint64 elapsedNs);
+    // stillActive：没有经过 takeNextPage() 返回 -1（例如打开文档失败）就退出
+    void workerExited(int generation, qint64 busyNs, bool stillActive = false);
+
+    // 以下需持有 m_mutex
+    void insertLocked(int pageIndex, const PageTextData& data);
+    void evictLocked(int keepPage);
+    void setPinnedLocked(PinReason reason, const QSet<int>& pages);
+
+    struct CacheEntry {
+        PageTextData data;
+        qint64 bytes = 0;
+        std::list<int>::iterator lruPos;    // 在 m_lru 中的位置
+    };
 
     PerThreadMuPDFRenderer* m_renderer;
 
-    // 缓存（页索引 -> PageTextData）
-    QHash<int, PageTextData> m_cache;
+    // 缓存（页索引 -> 文本数据，受 m_mutex 保护）
+    // LRU：访问时把页移到 m_lru 头部，淘汰从尾部开始（固定页面留在原位跳过）
+    QHash<int, CacheEntry> m_cache;
+    std::list<int> m_lru;               // 最近访问的在前
+    QHash<int, quint8> m_pins;          // 页索引 -> PinReason 组合
+    QVector<PageAnalysis> m_analysis;   // 页面分析结果（不参与淘汰）
+    qint64 m_cacheBytes;
+    qint64 m_evictionCount;
+    int m_cacheGeneration;              // 缓存所属的队列代数，工作线程在队列锁外写入时据此丢弃过期结果
     mutable QMutex m_mutex;
 
-    // 缓存限制（-1 表示无限制）
-    int m_maxCacheSize;
+    // 磁盘文本层（自带锁，可在提取线程中写入）
+    TextLayerStore m_textStore;
+
+    // 缓存内存上限（字节，-1 表示无限制）
+    qint64 m_maxCacheBytes;
 
     // 预加载状态（原子）
     QAtomicInt m_isPreloading;
     QAtomicInt m_cancelRequested;
-    QAtomicInt m_preloadedPages;
-    QAtomicInt m_remainingTasks;
+    QAtomicInt m_preloadedPages;       // 由工作线程累加
+    QTimer m_progressTimer;
+    int m_reportedProgress;             // 上次发出的进度
+
+    // 提取队列（受 m_queueMutex 保护）
+    mutable QMutex m_queueMutex;
+    QWaitCondition m_pageFinished;
+    QString m_pdfPath;                  // 当前队列所属文档（用于重新提取被淘汰的页）
+    QVector<PageState> m_pageStates;
+    QList<int> m_urgentPages;           // 按需请求，优先于预加载
+    QSet<int> m_geometryPages;          // 下次提取需要字符边界框的页
+    QSet<int> m_notifyPages;            // 提取完成后需要发出 pageGeometryReady() 的页
+    int m_generation;                   // 每次 startPreload 递增，过期工作线程据此退出
+    bool m_analysisOnly;                // 预加载只为页面分析（按需请求的页仍然缓存）
+    int m_pageCount;
+    int m_focusPage;
+    int m_forwardCursor;                // 下一个候选页（>= 焦点页）
+    int m_backwardCursor;               // 下一个候选页（< 焦点页）
+    int m_activeWorkers;                // 还会取页的工作线程（takeNextPage() 返回 -1 时减一）
+    int m_runningWorkers;               // 尚未退出的工作线程（全部退出时结束预加载）
+    QElapsedTimer m_preloadTimer;
+    PreloadTimings m_timings;           // 当前（或上一次）预加载的统计
 
     // 线程池
     QThreadPool m_threadPool;
@@ -0,0 +1,724 @@
+#include "textlayerstore.h"
+#include "datastructure.h"
+#include "textfolding.h"
+#include "appconfig.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QFile>
+#include <QLockFile>
+#include <QMutexLocker>
+#include <cstring>
+
+namespace {
+
+struct FileHeader {
+    quint32 magic;
+    quint32 version;
+    qint32 pageCount;
+    quint32 reserved;
+};
+
+struct RecordHeader {
+    quint32 magic;
+    qint32 pageIndex;
+    quint32 payloadSize;
+    quint32 charCount;
+    quint32 lineCount;
+    quint32 blockCount;
+    quint32 wordBreakCount;
+    quint32 flags;
+    quint32 analysisSize;       // 载荷末尾页面分析结果的字节数（0 表示没有）
+    quint32 reserved;
+    double bounds[4];
+};
+
+// RecordHeader::flags
+constexpr quint32 RECORD_TEXT_ONLY = 0x1;   // 没有字符边界框（TextOnly 提取）
+
+// 页面分析结果：AnalysisHeader 之后是 linkCount 个 (LinkHeader + URI 的 UTF-8 字节)
+struct AnalysisHeader {
+    quint32 flags;
+    quint32 linkCount;
+    double size[2];
+};
+
+struct LinkHeader {
+    double rect[4];
+    qint32 targetPage;
+    quint32 uriSize;
+};
+
+// AnalysisHeader::flags
+constexpr quint32 ANALYSIS_TEXT_LAYER = 0x1;
+constexpr quint32 ANALYSIS_IMAGE_ONLY = 0x2;
+
+constexpr quint32 MAX_ANALYSIS_SIZE = 16 * 1024 * 1024;
+
+static_assert(sizeof(PackedRect) == 8, "PackedRect must stay 8 bytes on disk");
+static_assert(sizeof(char32_t) == 4, "codepoints must stay 4 bytes on disk");
+static_assert(sizeof(LinkHeader) == 40, "LinkHeader must stay 40 bytes on disk");
+
+// 载荷中文本部分的字节数（不含分析结果）
+qint64 payloadSizeOf(quint32 chars, quint32 lines, quint32 blocks, quint32 wordBreaks, quint32 flags)
+{
+    const quint32 charBoxes = (flags & RECORD_TEXT_ONLY) ? 0 : chars;
+    return qint64(chars) * sizeof(char32_t) + qint64(charBoxes) * sizeof(PackedRect)
+           + qint64(lines + 1) * sizeof(int) + qint64(lines) * sizeof(PackedRect)
+           + qint64(blocks + 1) * sizeof(int) + qint64(blocks) * sizeof(PackedRect)
+           + qint64(wordBreaks) * sizeof(int);
+}
+
+// 记录头中的计数不会溢出，且载荷长度与各计数一致
+bool consistentRecord(const RecordHeader& record)
+{
+    constexpr quint32 maxCount = 0x0FFFFFFF;
+    if (record.charCount > maxCount || record.lineCount > maxCount ||
+        record.blockCount > maxCount || record.wordBreakCount > maxCount ||
+        record.analysisSize > MAX_ANALYSIS_SIZE) {
+        return false;
+    }
+    return record.payloadSize == payloadSizeOf(record.charCount, record.lineCount,
+                                               record.blockCount, record.wordBreakCount,
+                                               record.flags) + record.analysisSize;
+}
+
+QByteArray serializeAnalysis(const PageAnalysis& analysis)
+{
+    AnalysisHeader header;
+    header.flags = (analysis.hasTextLayer ? ANALYSIS_TEXT_LAYER : 0) |
+                   (analysis.imageOnly ? ANALYSIS_IMAGE_ONLY : 0);
+    header.linkCount = analysis.links.size();
+    header.size[0] = analysis.size.width();
+    header.size[1] = analysis.size.height();
+
+    QByteArray out;
+    out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (const PDFLink& link : analysis.links) {
+        const QByteArray uri = link.uri.toUtf8();
+
+        LinkHeader linkHeader;
+        linkHeader.rect[0] = link.rect.x();
+        linkHeader.rect[1] = link.rect.y();
+        linkHeader.rect[2] = link.rect.width();
+        linkHeader.rect[3] = link.rect.height();
+        linkHeader.targetPage = link.targetPage;
+        linkHeader.uriSize = uri.size();
+
+        out.append(reinterpret_cast<const char*>(&linkHeader), sizeof(linkHeader));
+        out.append(uri);
+    }
+    return out;
+}
+
+// 逐项检查长度，越界时返回 false
+bool parseAnalysis(const uchar* in, quint32 size, int pageIndex, PageAnalysis& out)
+{
+    AnalysisHeader header;
+    if (size < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, in, sizeof(header));
+
+    const uchar* end = in + size;
+    in += sizeof(header);
+    if (header.linkCount > quint32(end - in) / sizeof(LinkHeader)) {
+        return false;
+    }
+
+    out = PageAnalysis();
+    out.pageIndex = pageIndex;
+    out.size = QSizeF(header.size[0], header.size[1]);
+    out.hasTextLayer = header.flags & ANALYSIS_TEXT_LAYER;
+    out.imageOnly = header.flags & ANALYSIS_IMAGE_ONLY;
+    out.links.reserve(header.linkCount);
+
+    for (quint32 i = 0; i < header.linkCount; ++i) {
+        LinkHeader linkHeader;
+        if (quint32(end - in) < sizeof(linkHeader)) {
+            return false;
+        }
+        std::memcpy(&linkHeader, in, sizeof(linkHeader));
+        in += sizeof(linkHeader);
+
+        if (linkHeader.uriSize > quint32(end - in)) {
+            return false;
+        }
+
+        PDFLink link;
+        link.rect = QRectF(linkHeader.rect[0], linkHeader.rect[1],
+                           linkHeader.rect[2], linkHeader.rect[3]);
+        link.targetPage = linkHeader.targetPage;
+        link.uri = QString::fromUtf8(reinterpret_cast<const char*>(in), linkHeader.uriSize);
+        in += linkHeader.uriSize;
+
+        out.links.append(link);
+    }
+    return true;
+}
+
+template <typename T>
+void appendArray(QByteArray& out, const QVector<T>& data)
+{
+    out.append(reinterpret_cast<const char*>(data.constData()),
+               data.size() * static_cast<int>(sizeof(T)));
+}
+
+template <typename T>
+const uchar* readArray(const uchar* in, QVector<T>& data, quint32 count)
+{
+    data.resize(count);
+    if (count > 0) {
+        std::memcpy(data.data(), in, count * sizeof(T));
+    }
+    return in + count * sizeof(T);
+}
+
+// 偏移表：单调不减且位于 [0, limit]；anchored 时首项为 0、末项为 limit
+bool validOffsets(const QVector<int>& offsets, quint32 limit, bool anchored)
+{
+    if (anchored && (offsets.isEmpty() || offsets.first() != 0 || quint32(offsets.last()) != limit)) {
+        return false;
+    }
+
+    int previous = 0;
+    for (int value : offsets) {
+        if (value < previous || quint32(value) > limit) {
+            return false;
+        }
+        previous = value;
+    }
+    return true;
+}
+
+} // namespace
+
+struct TextLayerStore::SharedFile {
+    explicit SharedFile(const QString& filePath)
+        : file(filePath)
+        , lock(lockFilePath(filePath))
+    {
+        lock.setStaleLockTime(LOCK_STALE_MS);
+    }
+
+    ~SharedFile()
+    {
+        if (map) {
+            file.unmap(map);
+        }
+        file.close();
+    }
+
+    QMutex mutex;
+    QFile file;
+    QLockFile lock;                 // 进程间写入锁，析构时释放
+    bool writable = false;
+    int pageCount = 0;
+
+    uchar* map = nullptr;           // 映射区域（打开时的文件长度，只有持锁实例映射）
+    qint64 mappedSize = 0;
+
+    QHash<int, qint64> offsets;     // 页索引 -> 记录头偏移
+};
+
+TextLayerStore::TextLayerStore()
+{
+}
+
+TextLayerStore::~TextLayerStore()
+{
+    close();
+}
+
+QString TextLayerStore::fingerprint(const QString& pdfPath)
+{
+    QFileInfo info(pdfPath);
+    QFile file(pdfPath);
+    if (!info.exists() || !file.open(QIODevice::ReadOnly)) {
+        return QString();
+    }
+
+    // 大小 + 修改时间 + 首尾各 64KB 内容
+    constexpr qint64 chunk = 64 * 1024;
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArray::number(info.size()));
+    hash.addData(QByteArray::number(info.lastModified().toMSecsSinceEpoch()));
+    hash.addData(file.read(chunk));
+    if (info.size() > chunk) {
+        file.seek(qMax(chunk, info.size() - chunk));
+        hash.addData(file.read(chunk));
+    }
+
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+QString TextLayerStore::lockFilePath(const QString& filePath)
+{
+    return filePath + ".lock";
+}
+
+void TextLayerStore::enforceDirectoryBudget(const QString& dirPath, const QString& nameFilter,
+                                            qint64 maxBytes, const QString& keepPath)
+{
+    if (maxBytes < 0) {
+        return;
+    }
+
+    // 最旧的在前
+    const QFileInfoList files = QDir(dirPath).entryInfoList(
+        QStringList{nameFilter}, QDir::Files, QDir::Time | QDir::Reversed);
+
+    qint64 totalBytes = 0;
+    for (const QFileInfo& info : files) {
+        totalBytes += info.size();
+    }
+
+    const QString keep = QFileInfo(keepPath).absoluteFilePath();
+    for (const QFileInfo& info : files) {
+        if (totalBytes <= maxBytes) {
+            break;
+        }
+
+        const QString path = info.absoluteFilePath();
+        if (path == keep) {
+            continue;
+        }
+
+        // 正在被其他实例使用的文件拿不到锁，跳过
+        QLockFile lock(lockFilePath(path));
+        lock.setStaleLockTime(LOCK_STALE_MS);
+        if (!lock.tryLock(0)) {
+            continue;
+        }
+
+        if (QFile::remove(path)) {
+            totalBytes -= info.size();
+            qDebug() << "TextLayerStore: Evicted" << path << "to stay within" << maxBytes << "bytes";
+        }
+    }
+}
+
+std::shared_ptr<TextLayerStore::SharedFile> TextLayerStore::acquire(const QString& filePath,
+                                                                    int pageCount,
+                                                                    QString* errorMsg)
+{
+    // 进程内同一文件只打开一次
+    static QMutex registryMutex;
+    static QHash<QString, std::weak_ptr<SharedFile>> registry;
+
+    QMutexLocker locker(&registryMutex);
+
+    std::shared_ptr<SharedFile> existing = registry.value(filePath).lock();
+    if (existing) {
+        if (existing->pageCount == pageCount) {
+            return existing;
+        }
+        locker.unlock();    // existing 可能是最后一个引用，释放时要取注册表锁
+        if (errorMsg) *errorMsg = QString("%1 is open with a different page count").arg(filePath);
+        return nullptr;
+    }
+
+    // 最后一个引用在注册表锁内释放，关闭文件与重新打开不会交错
+    std::shared_ptr<SharedFile> shared(new SharedFile(filePath), [](SharedFile* file) {
+        QMutexLocker registryLocker(&registryMutex);
+        delete file;
+    });
+
+    if (!openFile(shared.get(), pageCount, errorMsg)) {
+        locker.unlock();
+        return nullptr;
+    }
+
+    for (auto it = registry.begin(); it != registry.end();) {
+        it = it->expired() ? registry.erase(it) : std::next(it);
+    }
+    registry.insert(filePath, shared);
+    return shared;
+}
+
+bool TextLayerStore::openFile(SharedFile* shared, int pageCount, QString* errorMsg)
+{
+    QFile& file = shared->file;
+
+    shared->writable = shared->lock.tryLock(0);
+    const QIODevice::OpenMode mode = shared->writable ? QIODevice::ReadWrite : QIODevice::ReadOnly;
+    if (!file.open(mode | QIODevice::Unbuffered)) {
+        if (errorMsg) *errorMsg = file.errorString();
+        return false;
+    }
+
+    shared->pageCount = pageCount;
+
+    // 文件头无效（新文件、版本或页数不符）时重建
+    FileHeader header;
+    bool valid = file.size() >= qint64(sizeof(FileHeader)) &&
+                 file.read(reinterpret_cast<char*>(&header), sizeof(header)) == sizeof(header) &&
+                 header.magic == FILE_MAGIC &&
+                 header.version == FORMAT_VERSION &&
+                 header.pageCount == pageCount;
+
+    if (!valid) {
+        if (!shared->writable) {
+            if (errorMsg) *errorMsg = QString("%1 is locked by another instance").arg(file.fileName());
+            return false;
+        }
+
+        header.magic = FILE_MAGIC;
+        header.version = FORMAT_VERSION;
+        header.pageCount = pageCount;
+        header.reserved = 0;
+
+        file.resize(0);
+        file.seek(0);
+        if (file.write(reinterpret_cast<const char*>(&header), sizeof(header)) != sizeof(header)) {
+            if (errorMsg) *errorMsg = file.errorString();
+            return false;
+        }
+    }
+
+    qint64 validSize = 0;
+    scanRecords(shared, &validSize);
+
+    if (!shared->writable) {
+        qDebug() << "TextLayerStore: Opened" << file.fileName() << "read-only with"
+                 << shared->offsets.size() << "of" << pageCount << "pages";
+        return true;
+    }
+
+    if (validSize < file.size()) {
+        qWarning() << "TextLayerStore: Dropping truncated tail of" << file.fileName();
+        file.resize(validSize);
+    }
+
+    // 记录最近使用时间，目录超出上限时优先删除久未打开的文档
+    file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+    enforceDirectoryBudget(QFileInfo(file.fileName()).absolutePath(), "*.jptx",
+                           AppConfig::instance().textLayerStoreMaxBytes(), file.fileName());
+
+    shared->mappedSize = file.size();
+    shared->map = file.map(0, shared->mappedSize);
+    if (!shared->map) {
+        shared->mappedSize = 0;  // 映射失败时退回普通读取
+    }
+
+    qDebug() << "TextLayerStore: Opened" << file.fileName()
+             << "with" << shared->offsets.size() << "of" << pageCount << "pages";
+    return true;
+}
+
+bool TextLayerStore::open(const QString& pdfPath, int pageCount, QString* errorMsg)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_shared && m_pdfPath == pdfPath && m_shared->pageCount == pageCount) {
+            return true;
+        }
+    }
+
+    close();
+
+    const QString key = fingerprint(pdfPath);
+    if (key.isEmpty()) {
+        if (errorMsg) *errorMsg = QString("Cannot fingerprint %1").arg(pdfPath);
+        return false;
+    }
+
+    const QString dirPath = AppConfig::instance().textLayerStoreDir();
+    if (!QDir().mkpath(dirPath)) {
+        if (errorMsg) *errorMsg = QString("Cannot create %1").arg(dirPath);
+        return false;
+    }
+
+    std::shared_ptr<SharedFile> shared = acquire(dirPath + "/" + key + ".jptx", pageCount, errorMsg);
+    if (!shared) {
+        return false;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_shared = shared;
+    m_pdfPath = pdfPath;
+    return true;
+}
+
+void TextLayerStore::scanRecords(SharedFile* shared, qint64* validSize)
+{
+    QFile& file = shared->file;
+    shared->offsets.clear();
+
+    const qint64 fileSize = file.size();
+    qint64 offset = sizeof(FileHeader);
+
+    while (offset + qint64(sizeof(RecordHeader)) <= fileSize) {
+        RecordHeader record;
+        file.seek(offset);
+        if (file.read(reinterpret_cast<char*>(&record), sizeof(record)) != sizeof(record) ||
+            record.magic != RECORD_MAGIC || !consistentRecord(record)) {
+            break;
+        }
+
+        qint64 end = offset + qint64(sizeof(RecordHeader)) + record.payloadSize;
+        if (end > fileSize) {
+            break;
+        }
+
+        if (record.pageIndex >= 0 && record.pageIndex < shared->pageCount) {
+            shared->offsets.insert(record.pageIndex, offset);  // 同页多条记录时后写入的生效
+        }
+        offset = end;
+    }
+
+    *validSize = offset;
+}
+
+void TextLayerStore::close()
+{
+    std::shared_ptr<SharedFile> released;
+    {
+        QMutexLocker locker(&m_mutex);
+        released.swap(m_shared);
+        m_pdfPath.clear();
+    }
+    // released 在这里析构；最后一个引用时关闭文件并释放锁
+}
+
+std::shared_ptr<TextLayerStore::SharedFile> TextLayerStore::sharedFile() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_shared;
+}
+
+bool TextLayerStore::isOpen() const
+{
+    return sharedFile() != nullptr;
+}
+
+bool TextLayerStore::isWritable() const
+{
+    std::shared_ptr<SharedFile> shared = sharedFile();
+    return shared && shared->writable;
+}
+
+bool TextLayerStore::contains(int pageIndex) const
+{
+    std::shared_ptr<SharedFile> shared = sharedFile();
+    if (!shared) {
+        return false;
+    }
+
+    QMutexLocker locker(&shared->mutex);
+    return shared->offsets.contains(pageIndex);
+}
+
+int TextLayerStore::storedPageCount() const
+{
+    std::shared_ptr<SharedFile> shared = sharedFile();
+    if (!shared) {
+        return 0;
+    }
+
+    QMutexLocker locker(&shared->mutex);
+    return shared->offsets.size();
+}
+
+bool TextLayerStore::loadPage(int pageIndex, PageTextData& outData) const
+{
+    return loadRecord(pageIndex, &outData, nullptr);
+}
+
+bool TextLayerStore::loadAnalysis(int pageIndex, PageAnalysis& outAnalysis) const
+{
+    return loadRecord(pageIndex, nullptr, &outAnalysis);
+}
+
+bool TextLayerStore::loadRecord(int pageIndex, PageTextData* outData,
+                                PageAnalysis* outAnalysis) const
+{
+    std::shared_ptr<SharedFile> shared = sharedFile();
+    if (!shared) {
+        return false;
+    }
+
+    QMutexLocker locker(&shared->mutex);
+
+    auto it = shared->offsets.constFind(pageIndex);
+    if (it == shared->offsets.constEnd()) {
+        return false;
+    }
+
+    // 记录头来自文件，长度和计数都先校验再使用
+    auto recordValid = [pageIndex](const RecordHeader& record) {
+        return record.magic == RECORD_MAGIC && record.pageIndex == pageIndex &&
+               consistentRecord(record);
+    };
+
+    const qint64 offset = it.value();
+    const qint64 payloadOffset = offset + qint64(sizeof(RecordHeader));
+    RecordHeader record;
+    QByteArray buffer;
+    const uchar* text = nullptr;
+    const uchar* analysisBytes = nullptr;
+
+    if (shared->map && payloadOffset <= shared->mappedSize) {
+        // 映射区域内：直接从映射内存读取
+        std::memcpy(&record, shared->map + offset, sizeof(record));
+        if (!recordValid(record) || payloadOffset + record.payloadSize > shared->mappedSize) {
+            return false;
+        }
+        text = shared->map + payloadOffset;
+        analysisBytes = text + (record.payloadSize - record.analysisSize);
+    } else {
+        // 本次打开后追加的记录（或只读打开）用普通读取；只要分析结果时跳过文本部分
+        if (!shared->file.seek(offset) ||
+            shared->file.read(reinterpret_cast<char*>(&record), sizeof(record)) != sizeof(record) ||
+            !recordValid(record)) {
+            return false;
+        }
+        const qint64 skip = outData ? 0 : qint64(record.payloadSize - record.analysisSize);
+        if (!shared->file.seek(payloadOffset + skip)) {
+            return false;
+        }
+        buffer = shared->file.read(record.payloadSize - skip);
+        if (buffer.size() != qint64(record.payloadSize) - skip) {
+            return false;
+        }
+        text = reinterpret_cast<const uchar*>(buffer.constData());
+        analysisBytes = text + (record.payloadSize - record.analysisSize - skip);
+    }
+
+    PageAnalysis analysis;
+    if (outAnalysis && !parseAnalysis(analysisBytes, record.analysisSize, pageIndex, analysis)) {
+        if (record.analysisSize > 0) {
+            qWarning() << "TextLayerStore: Corrupt analysis for page" << pageIndex;
+        }
+        return false;
+    }
+
+    if (!outData) {
+        *outAnalysis = std::move(analysis);
+        return true;
+    }
+
+    PageTextData data;
+    data.pageIndex = record.pageIndex;
+    data.bounds = QRectF(record.bounds[0], record.bounds[1], record.bounds[2], record.bounds[3]);
+
+    const uchar* in = text;
+    in = readArray(in, data.codepoints, record.charCount);
+    in = readArray(in, data.charBoxes,
+                   (record.flags & RECORD_TEXT_ONLY) ? 0u : record.charCount);
+    in = readArray(in, data.lineCharStarts, record.lineCount + 1);
+    in = readArray(in, data.lineBoxes, record.lineCount);
+    in = readArray(in, data.blockLineStarts, record.blockCount + 1);
+    in = readArray(in, data.blockBoxes, record.blockCount);
+    readArray(in, data.wordBreaks, record.wordBreakCount);
+
+    locker.unlock();
+
+    // 偏移表用于下标访问，损坏的记录按缺页处理
+    if (!validOffsets(data.lineCharStarts, record.charCount, true) ||
+        !validOffsets(data.blockLineStarts, record.lineCount, true) ||
+        !validOffsets(data.wordBreaks, record.charCount, false)) {
+        qWarning() << "TextLayerStore: Corrupt record for page" << pageIndex;
+        return false;
+    }
+
+    // 折叠影子文本不落盘，读取时重建
+    TextFolding::buildFoldedText(data);
+    *outData = std::move(data);
+    if (outAnalysis) {
+        *outAnalysis = std::move(analysis);
+    }
+    return true;
+}
+
+bool TextLayerStore::appendPage(const QString& pdfPath, const PageTextData& data,
+                                const PageAnalysis* analysis)
+{
+    if (!data.isValid()) {
+        return false;
+    }
+
+    // 提取失败时偏移表可能不完整，不写入
+    const quint32 chars = data.codepoints.size();
+    const quint32 lines = data.lineBoxes.size();
+    const quint32 blocks = data.blockBoxes.size();
+    const bool textOnly = data.charBoxes.isEmpty() && chars > 0;
+    if ((!textOnly && data.charBoxes.size() != int(chars)) ||
+        data.lineCharStarts.size() != int(lines + 1) ||
+        data.blockLineStarts.size() != int(blocks + 1)) {
+        return false;
+    }
+
+    RecordHeader record;
+    record.magic = RECORD_MAGIC;
+    record.pageIndex = data.pageIndex;
+    record.charCount = chars;
+    record.lineCount = lines;
+    record.blockCount = blocks;
+    record.wordBreakCount = data.wordBreaks.size();
+    record.flags = textOnly ? RECORD_TEXT_ONLY : 0;
+
+    const QByteArray analysisBytes = analysis ? serializeAnalysis(*analysis) : QByteArray();
+    if (quint32(analysisBytes.size()) > MAX_ANALYSIS_SIZE) {
+        return false;
+    }
+    record.analysisSize = analysisBytes.size();
+    record.reserved = 0;
+    record.payloadSize = payloadSizeOf(chars, lines, blocks, record.wordBreakCount, record.flags)
+                         + record.analysisSize;
+    record.bounds[0] = data.bounds.x();
+    record.bounds[1] = data.bounds.y();
+    record.bounds[2] = data.bounds.width();
+    record.bounds[3] = data.bounds.height();
+
+    // 在锁外序列化，只在写文件时加锁
+    QByteArray bytes;
+    bytes.reserve(sizeof(RecordHeader) + record.payloadSize);
+    bytes.append(reinterpret_cast<const char*>(&record), sizeof(record));
+    appendArray(bytes, data.codepoints);
+    appendArray(bytes, data.charBoxes);
+    appendArray(bytes, data.lineCharStarts);
+    appendArray(bytes, data.lineBoxes);
+    appendArray(bytes, data.blockLineStarts);
+    appendArray(bytes, data.blockBoxes);
+    appendArray(bytes, data.wordBreaks);
+    bytes.append(analysisBytes);
+
+    std::shared_ptr<SharedFile> shared;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_pdfPath != pdfPath) {
+            return false;
+        }
+        shared = m_shared;
+    }
+
+    if (!shared || !shared->writable) {
+        return false;
+    }
+
+    QMutexLocker locker(&shared->mutex);
+
+    if (data.pageIndex >= shared->pageCount) {
+        return false;
+    }
+
+    // 单个文件也不超过目录上限
+    const qint64 offset = shared->file.size();
+    const qint64 maxBytes = AppConfig::instance().textLayerStoreMaxBytes();
+    if (maxBytes >= 0 && offset + bytes.size() > maxBytes) {
+        return false;
+    }
+
+    if (!shared->file.seek(offset) || shared->file.write(bytes) != bytes.size()) {
+        qWarning() << "TextLayerStore: Failed to append page" << data.pageIndex
+                   << shared->file.errorString();
+        shared->file.resize(offset);
+        return false;
+    }
+
+    shared->offsets.insert(data.pageIndex, offset);
+    return true;
+}
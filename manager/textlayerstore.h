@@ -0,0 +1,129 @@
+#ifndef TEXTLAYERSTORE_H
+#define TEXTLAYERSTORE_H
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <limits>
+#include <memory>
+
+struct PageTextData;
+struct PageAnalysis;
+
+/**
+ * @brief 文本层持久化存储（每个文档一个磁盘文件）
+ *
+ * 文件按文档指纹（大小 + 修改时间 + 首尾内容摘要）命名，只追加写入：
+ *   文件头 | 页记录 | 页记录 | ...
+ * 每条页记录由固定长度的记录头和 PageTextData 各数组的原始字节组成，
+ * 打开时只扫描记录头建立索引并映射整个文件，读取页面时直接从映射内存复制。
+ * 末尾残缺的记录（例如写入时进程退出）在打开时被截掉。
+ * 只有文本的页（TextOnly 提取）不保存字符边界框；之后补齐几何信息时
+ * 追加一条完整记录，索引指向最新的一条。
+ * 记录末尾附带该页的 PageAnalysis（尺寸、链接、文本层标记），重新打开文档时
+ * 无需再次加载页面即可得到链接和 OCR 判断所需的信息。
+ *
+ * 多实例：
+ * - 进程内同一文件只打开一次（同一文档开在多个标签页时共享文件、索引和写入锁）
+ * - 进程间用锁文件互斥，拿到锁的实例才能写入、截断和映射文件；
+ *   拿不到锁时退回只读，只用普通读取访问打开时已有的记录
+ * - 读取时校验记录头和各偏移表，文件被其他进程改写时按缺页处理
+ * 目录总大小超过上限时，打开文件时按最近使用时间删除最旧且未被使用的文件。
+ *
+ * 线程安全：所有公共方法都可在任意线程调用。
+ */
+class TextLayerStore
+{
+public:
+    TextLayerStore();
+    ~TextLayerStore();
+
+    /**
+     * @brief 打开（或创建）文档对应的文本层文件
+     * 已打开同一文档时直接返回 true
+     */
+    bool open(const QString& pdfPath, int pageCount, QString* errorMsg = nullptr);
+    void close();
+    bool isOpen() const;
+
+    /**
+     * @brief 是否可写（其他进程持有该文件时为只读）
+     */
+    bool isWritable() const;
+
+    /**
+     * @brief 文件中是否已有该页
+     */
+    bool contains(int pageIndex) const;
+
+    /**
+     * @brief 已保存的页数
+     */
+    int storedPageCount() const;
+
+    /**
+     * @brief 读取一页（同时重建折叠影子文本）
+     */
+    bool loadPage(int pageIndex, PageTextData& outData) const;
+
+    /**
+     * @brief 只读取一页的分析结果（不复制文本）
+     * @return 没有该页或记录中没有分析结果时返回 false
+     */
+    bool loadAnalysis(int pageIndex, PageAnalysis& outAnalysis) const;
+
+    /**
+     * @brief 追加一页（由提取线程调用）
+     * @param pdfPath 页面所属文档，与当前打开的文档不符时忽略（过期任务）
+     * @param analysis 同一次加载得到的页面分析结果，为空时不保存
+     */
+    bool appendPage(const QString& pdfPath, const PageTextData& data,
+                    const PageAnalysis* analysis = nullptr);
+
+    /**
+     * @brief 计算文档指纹
+     */
+    static QString fingerprint(const QString& pdfPath);
+
+    /**
+     * @brief 按字节上限清理缓存目录
+     *
+     * 按修改时间从旧到新删除匹配 nameFilter 的文件，直到总大小不超过 maxBytes；
+     * keepPath 和被其他实例锁定的文件不删除。
+     */
+    static void enforceDirectoryBudget(const QString& dirPath, const QString& nameFilter,
+                                       qint64 maxBytes, const QString& keepPath);
+
+    /**
+     * @brief 缓存文件对应的进程间锁文件路径
+     */
+    static QString lockFilePath(const QString& filePath);
+
+    /**
+     * @brief 锁文件的过期时间：持有者进程退出即视为过期，不按时间判定（文件可能被长时间打开）
+     */
+    static constexpr int LOCK_STALE_MS = std::numeric_limits<int>::max();
+
+private:
+    struct SharedFile;
+
+    static std::shared_ptr<SharedFile> acquire(const QString& filePath, int pageCount,
+                                               QString* errorMsg);
+    static bool openFile(SharedFile* shared, int pageCount, QString* errorMsg);
+    static void scanRecords(SharedFile* shared, qint64* validSize);
+
+    std::shared_ptr<SharedFile> sharedFile() const;
+
+    // loadPage() / loadAnalysis() 的共同实现，outData / outAnalysis 为空时跳过对应部分
+    bool loadRecord(int pageIndex, PageTextData* outData, PageAnalysis* outAnalysis) const;
+
+    static constexpr quint32 FILE_MAGIC = 0x4A505458;     // "JPTX"
+    static constexpr quint32 RECORD_MAGIC = 0x50414745;   // "PAGE"
+    static constexpr quint32 FORMAT_VERSION = 2;
+
+    mutable QMutex m_mutex;                 // 保护 m_shared / m_pdfPath
+    std::shared_ptr<SharedFile> m_shared;
+    QString m_pdfPath;
+};
+
+#endif // TEXTLAYERSTORE_H
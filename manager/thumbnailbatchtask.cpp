@@ -1,28 +1,32 @@
 #include "thumbnailbatchtask.h"
 #include "perthreadmupdfrenderer.h"
 #include "thumbnailcache.h"
+#include "thumbnailstore.h"
 #include "thumbnailmanagerv2.h"
 #include <QElapsedTimer>
 #include <QDebug>
 
 ThumbnailBatchTask::ThumbnailBatchTask(const QString& docPath,
+                                       std::unique_ptr<PerThreadMuPDFRenderer>* renderer,
                                        ThumbnailCache* cache,
+                                       ThumbnailStore* store,
                                        ThumbnailManagerV2* manager,
                                        const QVector<int>& pageIndices,
                                        RenderPriority priority,
                                        int thumbnailWidth,
-                                       int rotation,
                                        double devicePixelRatio,
+                                       std::shared_ptr<QAtomicInt> abortFlag,
                                        FinishCallback cb)
-    : m_renderer(std::make_unique<PerThreadMuPDFRenderer>(docPath))
+    : m_docPath(docPath)
+    , m_renderer(renderer)
     , m_cache(cache)
+    , m_store(store)
     , m_manager(manager)
     , m_pageIndices(pageIndices)
     , m_priority(priority)
     , m_thumbnailWidth(thumbnailWidth)
-    , m_rotation(rotation)
     , m_devicePixelRatio(devicePixelRatio)
-    , m_aborted(0)
+    , m_aborted(std::move(abortFlag))
     , m_finishCallback(cb)
 {
     setAutoDelete(true);
@@ -34,17 +38,21 @@ ThumbnailBatchTask::~ThumbnailBatchTask()
 
 void ThumbnailBatchTask::run()
 {
+    QVector<int> failedPages;
+
     if (!m_renderer || !m_cache || !m_manager) {
         qWarning() << "ThumbnailBatchTask: Invalid renderer, cache or manager";
+        if (m_finishCallback) {
+            m_finishCallback(failedPages);
+        }
         return;
     }
 
     QElapsedTimer timer;
     timer.start();
 
-    int timeBudget = getTimeBudget();
-    int batchLimit = getBatchLimit();
     int rendered = 0;
+    int shortcuts = 0;  // 未经完整渲染得到的页（内嵌缩略图或直接解码）
 
     for (int pageIndex : m_pageIndices) {
         if (isAborted()) {
@@ -52,43 +60,39 @@ void ThumbnailBatchTask::run()
             break;
         }
 
-        if (!m_manager) {
-            qWarning() << "ThumbnailBatchTask: Manager destroyed during rendering";
-            break;
-        }
-
-        if (rendered >= batchLimit) {
-            qDebug() << "ThumbnailBatchTask: Batch limit reached";
-            break;
-        }
-
-        if (timer.elapsed() > timeBudget) {
-            qDebug() << "ThumbnailBatchTask: Time budget exceeded:" << timer.elapsed() << "ms";
-            break;
-        }
-
         // 检查是否已缓存
         if (m_cache->has(pageIndex)) {
             continue;
         }
 
-        // 计算缩放比例（使用高DPI渲染宽度）
-        QSizeF pageSize = m_renderer->pageSize(pageIndex);
-        if (pageSize.isEmpty()) {
-            qWarning() << "ThumbnailBatchTask: Invalid page size for page" << pageIndex;
-            continue;
-        }
-
-        double zoom = m_thumbnailWidth / pageSize.width();
-
-        // 渲染页面
-        RenderResult thumbnailRes = m_renderer->renderPage(pageIndex, zoom, m_rotation);
-
-        QImage thumbnail = thumbnailRes.image;
-
-        if (thumbnail.isNull()) {
-            qWarning() << "ThumbnailBatchTask: Failed to render page" << pageIndex;
-            continue;
+        // 缩略图文件中已有的页直接读取
+        QImage thumbnail;
+        if (!m_store || !m_store->loadPage(pageIndex, thumbnail)) {
+            // 槽位的渲染器在第一次需要渲染时创建
+            if (!*m_renderer) {
+                m_renderer->reset(new PerThreadMuPDFRenderer(m_docPath));
+            }
+            PerThreadMuPDFRenderer* renderer = m_renderer->get();
+
+            // 内嵌缩略图 → 单图像页降采样解码 → 完整渲染
+            ThumbnailSource source = ThumbnailSource::Render;
+            RenderResult thumbnailRes = renderer->renderThumbnail(pageIndex, m_thumbnailWidth,
+                                                                  0, &source);
+
+            thumbnail = thumbnailRes.image;
+            if (source != ThumbnailSource::Render) {
+                shortcuts++;
+            }
+
+            if (thumbnail.isNull()) {
+                qWarning() << "ThumbnailBatchTask: Failed to render page" << pageIndex;
+                failedPages.append(pageIndex);
+                continue;
+            }
+
+            if (m_store) {
+                m_store->appendPage(m_docPath, pageIndex, thumbnail);
+            }
         }
 
         // 设置设备像素比
@@ -98,65 +102,35 @@ void ThumbnailBatchTask::run()
         m_cache->set(pageIndex, thumbnail);
 
         // 通知UI
-        if (m_manager) {
-            QMetaObject::invokeMethod(m_manager, "thumbnailLoaded",
-                                      Qt::QueuedConnection,
-                                      Q_ARG(int, pageIndex),
-                                      Q_ARG(QImage, thumbnail));
-        }
+        QMetaObject::invokeMethod(m_manager, "thumbnailLoaded",
+                                  Qt::QueuedConnection,
+                                  Q_ARG(int, pageIndex),
+                                  Q_ARG(QImage, thumbnail));
 
         rendered++;
     }
 
-    if (m_finishCallback) {
-        m_finishCallback();
-    }
-
     qint64 elapsed = timer.elapsed();
     if (rendered > 0) {
         qDebug() << "ThumbnailBatchTask: Rendered" << rendered
                  << "pages in" << elapsed << "ms"
                  << "(" << (elapsed / rendered) << "ms/page)"
-                 << "at" << m_thumbnailWidth << "px (DPR:" << m_devicePixelRatio << ")";
+                 << "at" << m_thumbnailWidth << "px (DPR:" << m_devicePixelRatio << ")"
+                 << "priority" << static_cast<int>(m_priority)
+                 << "|" << shortcuts << "without full render";
+    }
+
+    if (m_finishCallback) {
+        m_finishCallback(failedPages);
     }
 }
 
 void ThumbnailBatchTask::abort()
 {
-    m_aborted.storeRelaxed(1);
+    m_aborted->storeRelaxed(1);
 }
 
 bool ThumbnailBatchTask::isAborted() const
 {
-    return m_aborted.loadRelaxed() != 0;
-}
-
-int ThumbnailBatchTask::getTimeBudget() const
-{
-    switch (m_priority) {
-    case RenderPriority::IMMEDIATE:
-        return 100;
-    case RenderPriority::HIGH:
-        return 500;
-    case RenderPriority::MEDIUM:
-        return 2000;
-    case RenderPriority::LOW:
-        return 5000;
-    }
-    return 1000;
-}
-
-int ThumbnailBatchTask::getBatchLimit() const
-{
-    switch (m_priority) {
-    case RenderPriority::IMMEDIATE:
-        return 10;
-    case RenderPriority::HIGH:
-        return 10;
-    case RenderPriority::MEDIUM:
-        return 20;
-    case RenderPriority::LOW:
-        return 50;
-    }
-    return 10;
+    return m_aborted->loadRelaxed() != 0;
 }
@@ -6,37 +6,39 @@
 #include <QAtomicInt>
 #include <QImage>
 #include <QPointer>
+#include <functional>
+#include <memory>
+
+#include "thumbnailscheduler.h"
 
 class PerThreadMuPDFRenderer;
 class ThumbnailCache;
+class ThumbnailStore;
 class ThumbnailManagerV2;
 
-/**
- * @brief 渲染优先级
- */
-enum class RenderPriority {
-    IMMEDIATE,    // 立即渲染（同步）
-    HIGH,         // 高优先级（可见区）
-    MEDIUM,       // 中优先级（预加载区）
-    LOW           // 低优先级（后台批次）
-};
-
 /**
  * @brief 缩略图批次渲染任务（支持高DPI）
+ *
+ * 缩略图文件中已有的页直接读取，新渲染的页追加到缩略图文件。
+ * 缩略图一律不旋转，旋转在界面绘制时处理。
+ * 渲染器属于管理器的工作槽位，同一槽位同时只运行一个任务，首次使用时在工作线程中打开文档。
+ * 取消标志由管理器持有，视口移走后置位，任务在两页之间退出，未完成的页由管理器放回调度器。
  */
 class ThumbnailBatchTask : public QRunnable
 {
 public:
-    using FinishCallback = std::function<void()>;
+    using FinishCallback = std::function<void(const QVector<int>& failedPages)>;
 
     ThumbnailBatchTask(const QString& docPath,
+                       std::unique_ptr<PerThreadMuPDFRenderer>* renderer,
                        ThumbnailCache* cache,
+                       ThumbnailStore* store,
                        ThumbnailManagerV2* manager,
                        const QVector<int>& pageIndices,
                        RenderPriority priority,
                        int thumbnailWidth,        // 实际渲染宽度（已乘以DPR）
-                       int rotation,
                        double devicePixelRatio,   // 设备像素比
+                       std::shared_ptr<QAtomicInt> abortFlag,
                        FinishCallback cb);
 
     ~ThumbnailBatchTask();
@@ -46,18 +48,16 @@ public:
     bool isAborted() const;
 
 private:
-    int getTimeBudget() const;
-    int getBatchLimit() const;
-
-    std::unique_ptr<PerThreadMuPDFRenderer> m_renderer;
+    QString m_docPath;
+    std::unique_ptr<PerThreadMuPDFRenderer>* m_renderer;
     ThumbnailCache* m_cache;
+    ThumbnailStore* m_store;
     ThumbnailManagerV2* m_manager;
     QVector<int> m_pageIndices;
     RenderPriority m_priority;
     int m_thumbnailWidth;        // 实际渲染宽度
-    int m_rotation;
     double m_devicePixelRatio;   // 设备像素比
-    QAtomicInt m_aborted;
+    std::shared_ptr<QAtomicInt> m_aborted;
 
     FinishCallback m_finishCallback;
 };
@@ -1,22 +1,25 @@
 #include "thumbnailmanagerv2.h"
 #include "thumbnailcache.h"
+#include "thumbnailstore.h"
 #include "perthreadmupdfrenderer.h"
+#include "appconfig.h"
 #include <QDebug>
-#include <QElapsedTimer>
 #include <QGuiApplication>
 #include <QScreen>
+#include <algorithm>
 
 ThumbnailManagerV2::ThumbnailManagerV2(PerThreadMuPDFRenderer* renderer, QObject* parent)
     : QObject(parent)
     , m_renderer(renderer)
-    , m_cache(std::make_unique<ThumbnailCache>())
+    , m_cache(std::make_unique<ThumbnailCache>(AppConfig::instance().maxThumbnailCacheBytes(),
+                                                AppConfig::instance().thumbnailCacheCompact()))
+    , m_store(std::make_unique<ThumbnailStore>())
     , m_threadPool(std::make_unique<QThreadPool>())
+    , m_generation(0)
     , m_thumbnailWidth(180)  // 提高默认宽度：120 → 180
-    , m_rotation(0)
-    , m_nextBatchIndex(0)
-    , m_runningTasks(0)
-    , m_isLoadingInProgress(false)
     , m_devicePixelRatio(1.0)
+    , m_scrolling(false)
+    , m_loading(false)
 {
     int threadCount = qMax(4, QThread::idealThreadCount() / 3);
     m_threadPool->setMaxThreadCount(threadCount);
@@ -46,11 +49,6 @@ void ThumbnailManagerV2::setThumbnailWidth(int width)
     }
 }
 
-void ThumbnailManagerV2::setRotation(int rotation)
-{
-    m_rotation = rotation;
-}
-
 QImage ThumbnailManagerV2::getThumbnail(int pageIndex) const
 {
     QImage image = m_cache->get(pageIndex);
@@ -80,123 +78,223 @@ void ThumbnailManagerV2::startLoading(const QSet<int>& initialVisible)
         return;
     }
 
+    cancelAllTasks();
+
     int pageCount = m_renderer->pageCount();
-    m_strategy.reset(StrategyFactory::createStrategy(pageCount, this));
-
-    QString strategyName;
-    switch (m_strategy->type()) {
-    case LoadStrategyType::SMALL_DOC:
-        strategyName = "Small Document (Full Sync)";
-        break;
-    case LoadStrategyType::MEDIUM_DOC:
-        strategyName = "Medium Document (Visible Sync + Background Async)";
-        break;
-    case LoadStrategyType::LARGE_DOC:
-        strategyName = "Large Document (On-Demand Sync Only)";
-        break;
+    m_docPath = m_renderer->documentPath();
+
+    m_scheduler.reset(pageCount, AppConfig::instance().thumbnailBackfillLimit());
+    for (int i = 0; i < pageCount; ++i) {
+        if (m_cache->has(i)) {
+            m_scheduler.markDone(i);
+        }
     }
 
-    qInfo() << "ThumbnailManagerV2: Starting load with strategy:" << strategyName
+    // 每个线程一个工作槽位，渲染器在槽位第一次渲染时创建
+    m_slots.clear();
+    m_slots.resize(m_threadPool->maxThreadCount());
+
+    if (AppConfig::instance().thumbnailStoreEnabled()) {
+        QString error;
+        // 缩略图文件只保存未旋转的缩略图
+        if (!m_store->open(m_docPath, pageCount, getRenderWidth(), &error)) {
+            qWarning() << "ThumbnailManagerV2: Thumbnail store unavailable:" << error;
+        }
+    }
+
+    qInfo() << "ThumbnailManagerV2: Starting viewport-driven load for" << pageCount << "pages"
             << "| Render width:" << getRenderWidth() << "px";
-    emit loadingStarted(pageCount, strategyName);
+    emit loadingStarted(pageCount);
+    emit loadingStatusChanged(tr("加载中..."));
 
-    QVector<int> initialPages = m_strategy->getInitialLoadPages(initialVisible);
+    m_loading = true;
+    updateViewport(initialVisible, initialVisible.size(), false);
+}
 
-    if (initialPages.isEmpty()) {
-        qDebug() << "startLoading Medium:" << initialVisible << initialPages;
+void ThumbnailManagerV2::updateViewport(const QSet<int>& visiblePages, int preloadPages, bool scrolling)
+{
+    if (m_scheduler.pageCount() == 0) {
         return;
     }
 
-    if (m_strategy->type() == LoadStrategyType::SMALL_DOC) {
-        m_isLoadingInProgress = true;
-        emit loadingStatusChanged(tr("加载中..."));
-        renderPagesSync(initialPages);
-        emit loadingStatusChanged(tr("加载完毕！"));
-        m_isLoadingInProgress = false;
-        emit allCompleted();
+    int first = 0;
+    int last = -1;
+    if (!visiblePages.isEmpty()) {
+        first = *std::min_element(visiblePages.begin(), visiblePages.end());
+        last = *std::max_element(visiblePages.begin(), visiblePages.end());
+    }
 
-    } else if (m_strategy->type() == LoadStrategyType::MEDIUM_DOC) {
-        m_isLoadingInProgress = true;
-        emit loadingStatusChanged(tr("加载可见区..."));
-        renderPagesSync(initialPages);
-        emit loadingStatusChanged(tr("后台加载中..."));
-        setupBackgroundBatches();
+    m_scrolling = scrolling;
+    m_scheduler.setViewport(first, last, preloadPages, scrolling);
 
-    } else {
-        m_isLoadingInProgress = false;
-        emit loadingStatusChanged(tr("加载中..."));
-        renderPagesSync(initialPages);
-        emit loadingStatusChanged(tr("滚动以触发分页加载"));
+    // 视口附近的缩略图不淘汰；之前被淘汰的页重新排队（通常从缩略图文件读回）
+    const int keepFirst = qMax(0, first - preloadPages);
+    const int keepLast = qMin(m_scheduler.pageCount() - 1, qMax(last, first - 1) + preloadPages);
+    m_cache->setProtectedRange(keepFirst, keepLast);
+    for (int pageIndex = keepFirst; pageIndex <= keepLast; ++pageIndex) {
+        if (m_scheduler.isDone(pageIndex) && !m_cache->has(pageIndex)) {
+            m_scheduler.requeue(pageIndex);
+        }
     }
-}
 
-void ThumbnailManagerV2::syncLoadPages(const QVector<int>& pages)
-{
-    if (!m_renderer || pages.isEmpty()) {
-        return;
-    }
+    // 取消过期任务：页面全部移出可见区和预加载区，或滚动时的后台补齐
+    for (WorkerSlot& slot : m_slots) {
+        if (!slot.busy || slot.abortFlag->loadRelaxed() != 0) {
+            continue;
+        }
 
-    if (m_isLoadingInProgress) {
-        return;
+        bool stale = scrolling && slot.priority == RenderPriority::LOW;
+        if (!stale && slot.priority != RenderPriority::LOW) {
+            stale = std::none_of(slot.pages.begin(), slot.pages.end(),
+                                 [this](int page) { return m_scheduler.isWanted(page); });
+        }
+
+        if (stale) {
+            slot.abortFlag->storeRelaxed(1);
+        }
     }
 
-    QVector<int> toLoad;
+    dispatch();
+}
+
+void ThumbnailManagerV2::requestPages(const QSet<int>& pages)
+{
     for (int pageIndex : pages) {
         if (!m_cache->has(pageIndex)) {
-            toLoad.append(pageIndex);
+            m_scheduler.requeue(pageIndex);
         }
     }
 
-    if (toLoad.isEmpty()) {
+    dispatch();
+}
+
+void ThumbnailManagerV2::dispatch()
+{
+    if (m_scheduler.pageCount() == 0) {
         return;
     }
 
-    qInfo() << "ThumbnailManagerV2: Sync loading" << toLoad.size()
-            << "pages (strategy:"
-            << (m_strategy ? static_cast<int>(m_strategy->type()) : -1) << ")";
+    const int taskPages = AppConfig::instance().thumbnailTaskPages();
+    const int backfillWorkers = AppConfig::instance().thumbnailBackfillWorkers();
 
-    renderPagesSync(toLoad);
-}
+    for (size_t i = 0; i < m_slots.size(); ++i) {
+        WorkerSlot& slot = m_slots[i];
+        if (slot.busy) {
+            continue;
+        }
 
-void ThumbnailManagerV2::handleSlowScroll(const QSet<int>& visiblePages)
-{
-    if (!m_renderer || visiblePages.isEmpty()) {
-        return;
+        RenderPriority priority = RenderPriority::LOW;
+        // 缓存已满时不再补齐，避免补齐的页互相淘汰
+        const bool allowBackfill = busyBackfillSlots() < backfillWorkers && !m_cache->isFull();
+        QVector<int> pages = m_scheduler.takeBatch(taskPages, allowBackfill, &priority);
+        if (pages.isEmpty()) {
+            break;
+        }
+
+        slot.busy = true;
+        slot.pages = pages;
+        slot.priority = priority;
+        slot.abortFlag = std::make_shared<QAtomicInt>(0);
+
+        const int slotIndex = static_cast<int>(i);
+        const quint64 generation = m_generation;
+        auto callback = [this, slotIndex, generation](const QVector<int>& failedPages) {
+            QMetaObject::invokeMethod(this, [this, slotIndex, generation, failedPages]() {
+                onTaskFinished(slotIndex, generation, failedPages);
+            }, Qt::QueuedConnection);
+        };
+
+        auto* task = new ThumbnailBatchTask(
+            m_docPath,
+            &slot.renderer,
+            m_cache.get(),
+            m_store.get(),
+            this,
+            pages,
+            priority,
+            getRenderWidth(),  // 使用高DPI渲染宽度
+            m_devicePixelRatio,  // 传递设备像素比
+            slot.abortFlag,
+            callback);
+
+        // 数值越大越先执行
+        m_threadPool->start(task, static_cast<int>(RenderPriority::LOW) - static_cast<int>(priority));
+        m_loading = true;
     }
 
-    if (!m_strategy || m_strategy->type() != LoadStrategyType::LARGE_DOC) {
-        return;
+    // 视口静止、没有运行中的任务、也没有可取的页 → 本轮加载完成
+    const bool idle = std::none_of(m_slots.begin(), m_slots.end(),
+                                   [](const WorkerSlot& slot) { return slot.busy; });
+    if (m_loading && idle && !m_scrolling && !m_scheduler.hasPendingWork(true)) {
+        m_loading = false;
+        qInfo() << "ThumbnailManagerV2: Loading finished," << m_scheduler.doneCount()
+                << "of" << m_scheduler.pageCount() << "pages ready";
+        emit loadingStatusChanged(tr("加载完毕！"));
+        emit allCompleted();
     }
+}
 
-    if (m_isLoadingInProgress) {
+void ThumbnailManagerV2::onTaskFinished(int slotIndex, quint64 generation, const QVector<int>& failedPages)
+{
+    // 清空或重新加载之后才送达的回调
+    if (generation != m_generation || slotIndex < 0 || slotIndex >= static_cast<int>(m_slots.size())) {
         return;
     }
 
-    QVector<int> toLoad;
-    for (int pageIndex : visiblePages) {
-        if (!m_cache->has(pageIndex)) {
-            toLoad.append(pageIndex);
+    WorkerSlot& slot = m_slots[slotIndex];
+    for (int pageIndex : slot.pages) {
+        if (failedPages.contains(pageIndex)) {
+            m_scheduler.markFailed(pageIndex);
+        } else if (m_cache->has(pageIndex)) {
+            m_scheduler.markDone(pageIndex);
+        } else {
+            m_scheduler.release(pageIndex);  // 任务被取消，重新排队
         }
     }
 
-    if (toLoad.isEmpty()) {
-        return;
-    }
+    slot.busy = false;
+    slot.pages.clear();
+    slot.abortFlag.reset();
+
+    emit loadProgress(m_scheduler.doneCount(), m_scheduler.pageCount());
 
-    renderPagesSync(toLoad);
+    dispatch();
 }
 
-void ThumbnailManagerV2::cancelAllTasks()
+int ThumbnailManagerV2::busyBackfillSlots() const
 {
-    QMutexLocker locker(&m_taskMutex);
+    return static_cast<int>(std::count_if(m_slots.begin(), m_slots.end(),
+                                          [](const WorkerSlot& slot) {
+                                              return slot.busy && slot.priority == RenderPriority::LOW;
+                                          }));
+}
 
-    m_nextBatchIndex = 0;
-    m_runningTasks = 0;
+void ThumbnailManagerV2::cancelAllTasks()
+{
+    for (WorkerSlot& slot : m_slots) {
+        if (slot.abortFlag) {
+            slot.abortFlag->storeRelaxed(1);
+        }
+    }
 
-    // 等待所有任务完成（自动删除）
+    // 等待正在运行的任务在两页之间退出
     if (m_threadPool) {
-        m_threadPool->clear();        // 清除还没开始的任务
-        m_threadPool->waitForDone();  // 等待所有正在运行的任务完成
+        m_threadPool->waitForDone();
+    }
+
+    // 丢弃尚未送达的任务回调，直接在这里结算
+    m_generation++;
+    for (WorkerSlot& slot : m_slots) {
+        for (int pageIndex : slot.pages) {
+            if (m_cache->has(pageIndex)) {
+                m_scheduler.markDone(pageIndex);
+            } else {
+                m_scheduler.release(pageIndex);
+            }
+        }
+        slot.busy = false;
+        slot.pages.clear();
+        slot.abortFlag.reset();
     }
 }
 
@@ -208,23 +306,23 @@ void ThumbnailManagerV2::clear()
         m_cache->clear();
     }
 
-    m_backgroundBatches.clear();
-    m_nextBatchIndex = 0;
-    m_runningTasks = 0;
-    m_isLoadingInProgress = false;
-}
+    if (m_store) {
+        m_store->close();
+    }
 
-QString ThumbnailManagerV2::getStatistics() const
-{
-    return m_cache->getStatistics();
+    m_slots.clear();
+    m_scheduler.reset(0, 0);
+    m_docPath.clear();
+    m_scrolling = false;
+    m_loading = false;
 }
 
-bool ThumbnailManagerV2::shouldRespondToScroll() const
+QString ThumbnailManagerV2::getStatistics() const
 {
-    return !m_isLoadingInProgress;
+    return m_cache->getStatistics() +
+           QString(", Stored: %1 pages").arg(m_store->storedPageCount());
 }
 
-
 void ThumbnailManagerV2::detectDevicePixelRatio()
 {
     // 获取主屏幕的设备像素比
@@ -248,138 +346,3 @@ int ThumbnailManagerV2::getRenderWidth() const
     // 按设备像素比渲染高分辨率图片
     return static_cast<int>(m_thumbnailWidth * m_devicePixelRatio);
 }
-
-void ThumbnailManagerV2::renderPagesSync(const QVector<int>& pages)
-{
-    if (!m_renderer || pages.isEmpty()) {
-        return;
-    }
-
-    QElapsedTimer timer;
-    timer.start();
-
-    int rendered = 0;
-    int total = pages.size();
-    int renderWidth = getRenderWidth();  // 使用高DPI渲染宽度
-
-    for (int pageIndex : pages) {
-        if (m_cache->has(pageIndex)) {
-            continue;
-        }
-
-        QSizeF pageSize = m_renderer->pageSize(pageIndex);
-        if (pageSize.isEmpty()) {
-            continue;
-        }
-
-        // 按高DPI宽度计算缩放比例
-        double zoom = renderWidth / pageSize.width();
-
-        RenderResult result = m_renderer->renderPage(
-            pageIndex, zoom, m_rotation);
-
-        if (result.success && !result.image.isNull()) {
-            // 设置图片的设备像素比
-            QImage image = result.image;
-            image.setDevicePixelRatio(m_devicePixelRatio);
-
-            m_cache->set(pageIndex, image);
-            emit thumbnailLoaded(pageIndex, image);
-            rendered++;
-
-            if (rendered % 10 == 0 || rendered == total) {
-                emit loadProgress(rendered, total);
-            }
-        }
-    }
-
-    qint64 elapsed = timer.elapsed();
-    qInfo() << "ThumbnailManagerV2: Sync rendered" << rendered
-            << "pages in" << elapsed << "ms"
-            << "(" << (rendered > 0 ? elapsed / rendered : 0) << "ms/page)"
-            << "at" << renderWidth << "px width";
-}
-
-void ThumbnailManagerV2::renderPagesAsync(const QVector<int>& pages, RenderPriority priority)
-{
-    if (!m_renderer || pages.isEmpty()) {
-        return;
-    }
-
-    QVector<int> toRender;
-    for (int pageIndex : pages) {
-        if (!m_cache->has(pageIndex)) {
-            toRender.append(pageIndex);
-        }
-    }
-
-    if (toRender.isEmpty()) {
-        return;
-    }
-
-    auto* task = new ThumbnailBatchTask(
-        m_renderer->documentPath(),
-        m_cache.get(),
-        this,
-        toRender,
-        priority,
-        getRenderWidth(),  // 使用高DPI渲染宽度
-        m_rotation,
-        m_devicePixelRatio,  // 传递设备像素比
-        nullptr);
-
-    m_threadPool->start(task, static_cast<int>(priority));
-}
-
-void ThumbnailManagerV2::setupBackgroundBatches()
-{
-    m_backgroundBatches = m_strategy->getBackgroundBatches();
-    m_nextBatchIndex = 0;
-    m_runningTasks = 0;
-
-    int maxConcurrency = m_threadPool->maxThreadCount();
-
-    // 启动前 maxConcurrency 个批次
-    for (int i = 0; i < maxConcurrency; i++) {
-        processNextBatch();
-    }
-}
-
-void ThumbnailManagerV2::processNextBatch()
-{
-    if (m_nextBatchIndex >= m_backgroundBatches.size()) {
-        // 没有更多批次了，如果也没有任务在跑 → 全部完成
-        if (m_runningTasks == 0) {
-            emit allCompleted();
-        }
-        return;
-    }
-
-    const QVector<int>& batch = m_backgroundBatches[m_nextBatchIndex];
-
-    m_runningTasks++;
-
-    auto callback = [this]() {
-        QMetaObject::invokeMethod(this, [this]() {
-            emit batchCompleted(m_nextBatchIndex, m_backgroundBatches.size());
-            m_runningTasks--;
-            processNextBatch(); // 启动下一个
-        });
-    };
-
-    m_nextBatchIndex++;
-
-    auto* task = new ThumbnailBatchTask(
-        m_renderer->documentPath(),
-        m_cache.get(),
-        this,
-        batch,
-        RenderPriority::LOW,
-        getRenderWidth(),
-        m_rotation,
-        m_devicePixelRatio,
-        callback
-        );
-
-    m_threadPool->start(task);
-}
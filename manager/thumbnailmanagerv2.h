@@ -3,28 +3,41 @@
 
 #include <QObject>
 #include <QThreadPool>
-#include <QMutex>
-#include <QTimer>
+#include <QSet>
 #include <memory>
+#include <vector>
 
 #include "thumbnailbatchtask.h"
-#include "thumbnailloadstrategy.h"
+#include "thumbnailscheduler.h"
 
 class PerThreadMuPDFRenderer;
 class ThumbnailCache;
+class ThumbnailStore;
 
 /**
  * @brief 智能缩略图管理器 V2 - 高DPI支持版
  *
- * 加载策略:
- * - 小文档(<50页): 全量同步加载
- * - 中文档(50-200页): 可见区同步 + 后台批次异步
- * - 大文档(>200页): 慢速滚动预加载 + 滚动停止同步加载
+ * 加载调度（与文档页数无关）:
+ * - ThumbnailScheduler 按视口决定顺序：可见区 → 预加载区（由近及远）→ 滚动停止后补齐
+ * - 所有渲染都在线程池中异步进行，每个工作槽位持有一个渲染器，同时最多运行槽位数个任务
+ * - 视口移动后，页面全部移出可见区和预加载区的任务被取消，未完成的页重新排队
+ * - 后台补齐只占用部分槽位，滚动时暂停
  *
  * 高DPI支持:
  * - 自动检测屏幕设备像素比（1x, 2x, 3x等）
  * - 按设备像素比渲染高分辨率缩略图
  * - 在高DPI屏幕上显示清晰图像
+ *
+ * 内存:
+ * - ThumbnailCache 按字节预算淘汰视口以外最久未用的缩略图，滚回时重新排队
+ * - 缓存写满后暂停后台补齐
+ *
+ * 旋转:
+ * - 缩略图一律按未旋转的页面渲染和保存，视图旋转时由 ThumbnailWidget 在绘制时旋转
+ *
+ * 持久化:
+ * - 渲染好的缩略图写入按文档指纹命名的缩略图文件（ThumbnailStore）
+ * - 再次打开时先从文件读取，只渲染缺失的页
  */
 class ThumbnailManagerV2 : public QObject
 {
@@ -36,7 +49,6 @@ public:
 
     // ========== 配置 ==========
     void setThumbnailWidth(int width);
-    void setRotation(int rotation);
 
     // ========== 获取缩略图 ==========
     QImage getThumbnail(int pageIndex) const;
@@ -45,25 +57,26 @@ public:
     // ========== 加载控制 ==========
 
     /**
-     * @brief 启动缩略图加载（根据策略自动选择）
+     * @brief 启动缩略图加载
      * @param initialVisible 初始可见页面
      */
     void startLoading(const QSet<int>& initialVisible);
 
     /**
-     * @brief 同步加载指定页面（主要用于大文档滚动停止后）
-     * @param pages 需要加载的页面索引
+     * @brief 更新视口，取消过期任务并按新视口调度
+     * @param visiblePages 当前可见的页面索引
+     * @param preloadPages 可见区前后各预加载的页数
+     * @param scrolling 是否正在滚动（滚动中暂停后台补齐）
      */
-    void syncLoadPages(const QVector<int>& pages);
+    void updateViewport(const QSet<int>& visiblePages, int preloadPages, bool scrolling);
 
     /**
-     * @brief 处理慢速滚动（大文档专用）
-     * @param visiblePages 当前可见的页面索引
+     * @brief 重新请求指定页面（例如缓存中的缩略图已被丢弃）
      */
-    void handleSlowScroll(const QSet<int>& visiblePages);
+    void requestPages(const QSet<int>& pages);
 
     /**
-     * @brief 取消所有后台任务（仅中文档使用）
+     * @brief 取消所有后台任务并等待正在运行的任务结束
      */
     void cancelAllTasks();
 
@@ -72,62 +85,56 @@ public:
     QString getStatistics() const;
     int cachedCount() const;
 
-    /**
-     * @brief 是否应该响应滚动事件
-     */
-    bool shouldRespondToScroll() const;
-
-    ThumbnailLoadStrategy* thumbnailLoadStrategy() const {return m_strategy.get();}
-
 signals:
     void thumbnailLoaded(int pageIndex, const QImage& thumbnail);
     void loadProgress(int loaded, int total);
-    void batchCompleted(int batchIndex, int totalBatches);
     void allCompleted();
 
-    void loadingStarted(int totalPages, const QString& strategy);
+    void loadingStarted(int totalPages);
     void loadingStatusChanged(const QString& status);
 
-private slots:
-    void processNextBatch();
-
 private:
+    /**
+     * @brief 工作槽位：一个渲染器 + 当前任务
+     */
+    struct WorkerSlot {
+        std::unique_ptr<PerThreadMuPDFRenderer> renderer;
+        std::shared_ptr<QAtomicInt> abortFlag;
+        QVector<int> pages;
+        RenderPriority priority = RenderPriority::LOW;
+        bool busy = false;
+    };
+
     // 检测设备像素比
     void detectDevicePixelRatio();
 
     // 获取实际渲染宽度（显示宽度 × 设备像素比）
     int getRenderWidth() const;
 
-    // 同步渲染
-    void renderPagesSync(const QVector<int>& pages);
+    // 把空闲槽位填满
+    void dispatch();
 
-    // 异步渲染
-    void renderPagesAsync(const QVector<int>& pages, RenderPriority priority);
+    // 任务结束（主线程）
+    void onTaskFinished(int slotIndex, quint64 generation, const QVector<int>& failedPages);
 
-    // 设置中文档后台批次
-    void setupBackgroundBatches();
-
-    void trackTask(ThumbnailBatchTask* task);
+    int busyBackfillSlots() const;
 
 private:
     PerThreadMuPDFRenderer* m_renderer;
     std::unique_ptr<ThumbnailCache> m_cache;
+    std::unique_ptr<ThumbnailStore> m_store;
     std::unique_ptr<QThreadPool> m_threadPool;
-    std::unique_ptr<ThumbnailLoadStrategy> m_strategy;
+
+    ThumbnailScheduler m_scheduler;
+    std::vector<WorkerSlot> m_slots;
+    quint64 m_generation;       // 每次开始加载/清空时递增，丢弃过期任务的回调
+    QString m_docPath;
 
     int m_thumbnailWidth;      // 显示宽度（逻辑像素）
-    int m_rotation;
     double m_devicePixelRatio; // 设备像素比（1.0, 2.0, 3.0等）
 
-    // 批次管理（仅中文档使用）
-    QVector<QVector<int>> m_backgroundBatches;
-    int m_nextBatchIndex = 0;
-    int m_runningTasks = 0;
-
-    // 任务跟踪（仅中文档使用）
-    QMutex m_taskMutex;
-
-    bool m_isLoadingInProgress;
+    bool m_scrolling;          // 视口是否正在滚动
+    bool m_loading;            // 已开始加载且尚未报告完成
 };
 
 #endif // THUMBNAILMANAGER_V2_H
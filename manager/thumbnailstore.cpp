@@ -0,0 +1,428 @@
+#include "thumbnailstore.h"
+#include "textlayerstore.h"
+#include "thumbnailcache.h"
+#include "appconfig.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QLockFile>
+#include <QMutexLocker>
+#include <QVector>
+#include <cstring>
+
+namespace {
+
+struct FileHeader {
+    quint32 magic;
+    quint32 version;
+    qint32 pageCount;
+    qint32 renderWidth;
+};
+
+// SlotEntry::encoding（两种都是按行紧凑排列后 qCompress 压缩）
+constexpr quint32 ENCODING_GRAY8 = 1;
+constexpr quint32 ENCODING_RGB888 = 2;
+
+int bytesPerPixel(quint32 encoding)
+{
+    return encoding == ENCODING_GRAY8 ? 1 : 3;
+}
+
+} // namespace
+
+struct ThumbnailStore::SharedFile {
+    explicit SharedFile(const QString& filePath)
+        : file(filePath)
+        , lock(TextLayerStore::lockFilePath(filePath))
+    {
+        lock.setStaleLockTime(TextLayerStore::LOCK_STALE_MS);
+    }
+
+    ~SharedFile()
+    {
+        if (map) {
+            file.unmap(map);
+        }
+        file.close();
+    }
+
+    QMutex mutex;
+    QFile file;
+    QLockFile lock;                 // 进程间写入锁，析构时释放
+    bool writable = false;
+    int pageCount = 0;
+
+    uchar* map = nullptr;           // 映射区域（打开时的文件长度，只有持锁实例映射）
+    qint64 mappedSize = 0;
+
+    QVector<SlotEntry> slots;       // 槽位表（内存副本）
+    int storedCount = 0;
+};
+
+ThumbnailStore::ThumbnailStore()
+    : m_renderWidth(0)
+{
+}
+
+ThumbnailStore::~ThumbnailStore()
+{
+    close();
+}
+
+qint64 ThumbnailStore::slotTableOffset()
+{
+    return sizeof(FileHeader);
+}
+
+std::shared_ptr<ThumbnailStore::SharedFile> ThumbnailStore::acquire(const QString& filePath,
+                                                                    int pageCount,
+                                                                    int renderWidth,
+                                                                    QString* errorMsg)
+{
+    // 进程内同一文件只打开一次（文件名已包含渲染宽度）
+    static QMutex registryMutex;
+    static QHash<QString, std::weak_ptr<SharedFile>> registry;
+
+    QMutexLocker locker(&registryMutex);
+
+    std::shared_ptr<SharedFile> existing = registry.value(filePath).lock();
+    if (existing) {
+        if (existing->pageCount == pageCount) {
+            return existing;
+        }
+        locker.unlock();    // existing 可能是最后一个引用，释放时要取注册表锁
+        if (errorMsg) *errorMsg = QString("%1 is open with a different page count").arg(filePath);
+        return nullptr;
+    }
+
+    // 最后一个引用在注册表锁内释放，关闭文件与重新打开不会交错
+    std::shared_ptr<SharedFile> shared(new SharedFile(filePath), [](SharedFile* file) {
+        QMutexLocker registryLocker(&registryMutex);
+        delete file;
+    });
+
+    if (!openFile(shared.get(), pageCount, renderWidth, errorMsg)) {
+        locker.unlock();
+        return nullptr;
+    }
+
+    for (auto it = registry.begin(); it != registry.end();) {
+        it = it->expired() ? registry.erase(it) : std::next(it);
+    }
+    registry.insert(filePath, shared);
+    return shared;
+}
+
+bool ThumbnailStore::openFile(SharedFile* shared, int pageCount, int renderWidth,
+                              QString* errorMsg)
+{
+    QFile& file = shared->file;
+
+    shared->writable = shared->lock.tryLock(0);
+    const QIODevice::OpenMode mode = shared->writable ? QIODevice::ReadWrite : QIODevice::ReadOnly;
+    if (!file.open(mode | QIODevice::Unbuffered)) {
+        if (errorMsg) *errorMsg = file.errorString();
+        return false;
+    }
+
+    shared->pageCount = pageCount;
+
+    const qint64 tableBytes = qint64(pageCount) * sizeof(SlotEntry);
+    const qint64 dataStart = slotTableOffset() + tableBytes;
+
+    // 文件头无效（新文件、版本、页数或渲染宽度不符）时重建
+    FileHeader header;
+    bool valid = file.size() >= dataStart &&
+                 file.read(reinterpret_cast<char*>(&header), sizeof(header)) == sizeof(header) &&
+                 header.magic == FILE_MAGIC &&
+                 header.version == FORMAT_VERSION &&
+                 header.pageCount == pageCount &&
+                 header.renderWidth == renderWidth;
+
+    shared->slots.fill(SlotEntry{0, 0, 0, 0, 0}, pageCount);
+
+    if (!valid) {
+        if (!shared->writable) {
+            if (errorMsg) *errorMsg = QString("%1 is locked by another instance").arg(file.fileName());
+            return false;
+        }
+
+        header.magic = FILE_MAGIC;
+        header.version = FORMAT_VERSION;
+        header.pageCount = pageCount;
+        header.renderWidth = renderWidth;
+
+        file.resize(0);
+        file.seek(0);
+        if (file.write(reinterpret_cast<const char*>(&header), sizeof(header)) != sizeof(header) ||
+            file.write(reinterpret_cast<const char*>(shared->slots.constData()), tableBytes) != tableBytes) {
+            if (errorMsg) *errorMsg = file.errorString();
+            return false;
+        }
+    } else {
+        file.seek(slotTableOffset());
+        if (file.read(reinterpret_cast<char*>(shared->slots.data()), tableBytes) != tableBytes) {
+            shared->slots.fill(SlotEntry{0, 0, 0, 0, 0}, pageCount);
+        }
+    }
+
+    // 丢弃越界或无效的槽位（图像未写完、文件被截断）
+    const qint64 fileSize = file.size();
+    shared->storedCount = 0;
+    for (SlotEntry& entry : shared->slots) {
+        if (entry.offset == 0) {
+            continue;
+        }
+        if (entry.offset < dataStart || entry.bytes == 0 || entry.width <= 0 || entry.height <= 0 ||
+            (entry.encoding != ENCODING_GRAY8 && entry.encoding != ENCODING_RGB888) ||
+            entry.offset + entry.bytes > fileSize) {
+            entry = SlotEntry{0, 0, 0, 0, 0};
+            continue;
+        }
+        ++shared->storedCount;
+    }
+
+    if (!shared->writable) {
+        qDebug() << "ThumbnailStore: Opened" << file.fileName() << "read-only with"
+                 << shared->storedCount << "of" << pageCount << "pages";
+        return true;
+    }
+
+    // 记录最近使用时间，目录超出上限时优先删除久未打开的文档
+    file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+    TextLayerStore::enforceDirectoryBudget(QFileInfo(file.fileName()).absolutePath(), "*.jpth",
+                                           AppConfig::instance().thumbnailStoreMaxBytes(),
+                                           file.fileName());
+
+    shared->mappedSize = fileSize;
+    shared->map = file.map(0, shared->mappedSize);
+    if (!shared->map) {
+        shared->mappedSize = 0;  // 映射失败时退回普通读取
+    }
+
+    qDebug() << "ThumbnailStore: Opened" << file.fileName()
+             << "with" << shared->storedCount << "of" << pageCount << "pages"
+             << "at" << renderWidth << "px";
+    return true;
+}
+
+bool ThumbnailStore::open(const QString& pdfPath, int pageCount, int renderWidth,
+                          QString* errorMsg)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_shared && m_pdfPath == pdfPath && m_shared->pageCount == pageCount &&
+            m_renderWidth == renderWidth) {
+            return true;
+        }
+    }
+
+    close();
+
+    const QString key = TextLayerStore::fingerprint(pdfPath);
+    if (key.isEmpty()) {
+        if (errorMsg) *errorMsg = QString("Cannot fingerprint %1").arg(pdfPath);
+        return false;
+    }
+
+    const QString dirPath = AppConfig::instance().thumbnailStoreDir();
+    if (!QDir().mkpath(dirPath)) {
+        if (errorMsg) *errorMsg = QString("Cannot create %1").arg(dirPath);
+        return false;
+    }
+
+    const QString filePath = QString("%1/%2_%3.jpth").arg(dirPath, key).arg(renderWidth);
+    std::shared_ptr<SharedFile> shared = acquire(filePath, pageCount, renderWidth, errorMsg);
+    if (!shared) {
+        return false;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_shared = shared;
+    m_pdfPath = pdfPath;
+    m_renderWidth = renderWidth;
+    return true;
+}
+
+void ThumbnailStore::close()
+{
+    std::shared_ptr<SharedFile> released;
+    {
+        QMutexLocker locker(&m_mutex);
+        released.swap(m_shared);
+        m_pdfPath.clear();
+        m_renderWidth = 0;
+    }
+    // released 在这里析构；最后一个引用时关闭文件并释放锁
+}
+
+std::shared_ptr<ThumbnailStore::SharedFile> ThumbnailStore::sharedFile() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_shared;
+}
+
+bool ThumbnailStore::isOpen() const
+{
+    return sharedFile() != nullptr;
+}
+
+bool ThumbnailStore::isWritable() const
+{
+    std::shared_ptr<SharedFile> shared = sharedFile();
+    return shared && shared->writable;
+}
+
+bool ThumbnailStore::contains(int pageIndex) const
+{
+    std::shared_ptr<SharedFile> shared = sharedFile();
+    if (!shared) {
+        return false;
+    }
+
+    QMutexLocker locker(&shared->mutex);
+    return pageIndex >= 0 && pageIndex < shared->slots.size() &&
+           shared->slots[pageIndex].offset != 0;
+}
+
+int ThumbnailStore::storedPageCount() const
+{
+    std::shared_ptr<SharedFile> shared = sharedFile();
+    if (!shared) {
+        return 0;
+    }
+
+    QMutexLocker locker(&shared->mutex);
+    return shared->storedCount;
+}
+
+bool ThumbnailStore::loadPage(int pageIndex, QImage& outImage) const
+{
+    std::shared_ptr<SharedFile> shared = sharedFile();
+    if (!shared) {
+        return false;
+    }
+
+    QMutexLocker locker(&shared->mutex);
+
+    if (pageIndex < 0 || pageIndex >= shared->slots.size() || shared->slots[pageIndex].offset == 0) {
+        return false;
+    }
+
+    const SlotEntry entry = shared->slots[pageIndex];
+    QByteArray packed;
+
+    if (shared->map && entry.offset + entry.bytes <= shared->mappedSize) {
+        // 映射区域内：直接从映射内存解压（映射在 shared 析构前一直有效）
+        packed = QByteArray::fromRawData(reinterpret_cast<const char*>(shared->map + entry.offset),
+                                         entry.bytes);
+    } else {
+        // 本次打开后追加的图像（或只读打开）用普通读取
+        if (!shared->file.seek(entry.offset)) {
+            return false;
+        }
+        packed = shared->file.read(entry.bytes);
+        if (packed.size() != qint64(entry.bytes)) {
+            return false;
+        }
+    }
+
+    locker.unlock();
+
+    // 数据可能被其他进程改写，解压后的长度与尺寸不符时按缺页处理
+    const QByteArray rows = qUncompress(packed);
+    const int rowBytes = entry.width * bytesPerPixel(entry.encoding);
+    if (rows.size() != qint64(rowBytes) * entry.height) {
+        qWarning() << "ThumbnailStore: Corrupt image for page" << pageIndex;
+        return false;
+    }
+
+    QImage image(entry.width, entry.height,
+                 entry.encoding == ENCODING_GRAY8 ? QImage::Format_Grayscale8
+                                                  : QImage::Format_RGB888);
+    if (image.isNull()) {
+        return false;
+    }
+
+    for (int y = 0; y < entry.height; ++y) {
+        std::memcpy(image.scanLine(y), rows.constData() + qint64(y) * rowBytes, rowBytes);
+    }
+
+    outImage = image;
+    return true;
+}
+
+bool ThumbnailStore::appendPage(const QString& pdfPath, int pageIndex, const QImage& image)
+{
+    if (image.isNull()) {
+        return false;
+    }
+
+    std::shared_ptr<SharedFile> shared;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_pdfPath != pdfPath) {
+            return false;
+        }
+        shared = m_shared;
+    }
+
+    if (!shared || !shared->writable) {
+        return false;
+    }
+
+    // 在锁外编码：灰度页面只存一个通道，按行紧凑排列后压缩
+    const quint32 encoding = ThumbnailCache::isGrayscale(image) ? ENCODING_GRAY8 : ENCODING_RGB888;
+    const QImage::Format format = (encoding == ENCODING_GRAY8) ? QImage::Format_Grayscale8
+                                                               : QImage::Format_RGB888;
+    const QImage converted = (image.format() == format) ? image : image.convertToFormat(format);
+    const int rowBytes = converted.width() * bytesPerPixel(encoding);
+
+    QByteArray rows;
+    rows.resize(qint64(rowBytes) * converted.height());
+    for (int y = 0; y < converted.height(); ++y) {
+        std::memcpy(rows.data() + qint64(y) * rowBytes, converted.constScanLine(y), rowBytes);
+    }
+    const QByteArray packed = qCompress(rows, 1);
+
+    QMutexLocker locker(&shared->mutex);
+
+    if (pageIndex < 0 || pageIndex >= shared->slots.size()) {
+        return false;
+    }
+
+    if (shared->slots[pageIndex].offset != 0) {
+        return true;
+    }
+
+    SlotEntry entry;
+    entry.offset = shared->file.size();
+    entry.bytes = packed.size();
+    entry.width = converted.width();
+    entry.height = converted.height();
+    entry.encoding = encoding;
+
+    // 单个文件也不超过目录上限
+    const qint64 maxBytes = AppConfig::instance().thumbnailStoreMaxBytes();
+    if (maxBytes >= 0 && entry.offset + entry.bytes > maxBytes) {
+        return false;
+    }
+
+    // 先写图像再写槽位：中途失败时槽位仍为空
+    const qint64 slotOffset = slotTableOffset() + qint64(pageIndex) * sizeof(SlotEntry);
+    QFile& file = shared->file;
+    if (!file.seek(entry.offset) || file.write(packed) != packed.size() ||
+        !file.seek(slotOffset) ||
+        file.write(reinterpret_cast<const char*>(&entry), sizeof(entry)) != qint64(sizeof(entry))) {
+        qWarning() << "ThumbnailStore: Failed to append page" << pageIndex << file.errorString();
+        file.resize(entry.offset);
+        return false;
+    }
+
+    shared->slots[pageIndex] = entry;
+    ++shared->storedCount;
+    return true;
+}
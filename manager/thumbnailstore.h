@@ -0,0 +1,98 @@
+#ifndef THUMBNAILSTORE_H
+#define THUMBNAILSTORE_H
+
+#include <QImage>
+#include <QMutex>
+#include <QString>
+#include <memory>
+
+/**
+ * @brief 缩略图持久化图集（每个文档、每种渲染宽度一个磁盘文件）
+ *
+ * 文件按文档指纹（与文本层相同）和渲染宽度命名，布局为：
+ *   文件头 | 槽位表（每页一项，固定长度） | 图像 | 图像 | ...
+ * 所有缩略图按同一宽度、不旋转渲染（显示时再旋转）。
+ * 图像按行紧凑排列后压缩：灰度页面（扫描件常见）存 8 位灰度，彩色页面存 RGB888，
+ * 槽位表记录每页数据的偏移、长度、尺寸和编码。
+ * 新渲染的缩略图先追加图像、再写槽位，写入中途退出只会留下无人引用的尾部。
+ * 不同缩放比例的屏幕使用各自的文件，不会互相覆盖。
+ *
+ * 多实例（与 TextLayerStore 相同）：
+ * - 进程内同一文件只打开一次，多个标签页共享文件、槽位表和写入锁
+ * - 进程间用锁文件互斥，拿到锁的实例才能写入、重建和映射文件；
+ *   拿不到锁时退回只读，只用普通读取访问打开时已有的图像
+ * 目录总大小超过上限时，打开文件时按最近使用时间删除最旧且未被使用的文件。
+ *
+ * 线程安全：所有公共方法都可在任意线程调用。
+ */
+class ThumbnailStore
+{
+public:
+    ThumbnailStore();
+    ~ThumbnailStore();
+
+    /**
+     * @brief 打开（或创建）文档对应的缩略图文件
+     * 已按相同参数打开同一文档时直接返回 true
+     */
+    bool open(const QString& pdfPath, int pageCount, int renderWidth,
+              QString* errorMsg = nullptr);
+    void close();
+    bool isOpen() const;
+
+    /**
+     * @brief 是否可写（其他进程持有该文件时为只读）
+     */
+    bool isWritable() const;
+
+    /**
+     * @brief 文件中是否已有该页
+     */
+    bool contains(int pageIndex) const;
+
+    /**
+     * @brief 已保存的页数
+     */
+    int storedPageCount() const;
+
+    /**
+     * @brief 读取一页
+     */
+    bool loadPage(int pageIndex, QImage& outImage) const;
+
+    /**
+     * @brief 追加一页（可由渲染线程调用，已保存的页直接返回 true）
+     * @param pdfPath 页面所属文档，与当前打开的文档不符时忽略（过期任务）
+     */
+    bool appendPage(const QString& pdfPath, int pageIndex, const QImage& image);
+
+private:
+    struct SlotEntry {
+        qint64 offset;      // 压缩数据偏移，0 表示未写入
+        quint32 bytes;      // 压缩数据长度
+        qint32 width;
+        qint32 height;
+        quint32 encoding;
+    };
+    static_assert(sizeof(SlotEntry) == 24, "slot entries must stay 24 bytes on disk");
+
+    struct SharedFile;
+
+    static std::shared_ptr<SharedFile> acquire(const QString& filePath, int pageCount,
+                                               int renderWidth, QString* errorMsg);
+    static bool openFile(SharedFile* shared, int pageCount, int renderWidth, QString* errorMsg);
+
+    std::shared_ptr<SharedFile> sharedFile() const;
+
+    static qint64 slotTableOffset();
+
+    static constexpr quint32 FILE_MAGIC = 0x4A505448;     // "JPTH"
+    static constexpr quint32 FORMAT_VERSION = 3;
+
+    mutable QMutex m_mutex;                 // 保护 m_shared / m_pdfPath / m_renderWidth
+    std::shared_ptr<SharedFile> m_shared;
+    QString m_pdfPath;
+    int m_renderWidth;
+};
+
+#endif // THUMBNAILSTORE_H
@@ -0,0 +1,111 @@
+#include "searchresultmodel.h"
+#include "searchmanager.h"
+#include "appconfig.h"
+
+SearchResultModel::SearchResultModel(QObject* parent)
+    : QAbstractListModel(parent)
+    , m_searchManager(nullptr)
+    , m_pageSize(AppConfig::instance().searchResultPageSize())
+    , m_active(false)
+{
+}
+
+void SearchResultModel::setSearchManager(SearchManager* manager)
+{
+    if (m_searchManager == manager) {
+        return;
+    }
+
+    if (m_searchManager) {
+        disconnect(m_searchManager, nullptr, this, nullptr);
+    }
+
+    m_searchManager = manager;
+
+    if (m_searchManager) {
+        connect(m_searchManager, &SearchManager::searchResultsAvailable,
+                this, &SearchResultModel::onResultsAvailable);
+    }
+
+    reset();
+}
+
+void SearchResultModel::reset()
+{
+    beginResetModel();
+    m_loaded.clear();
+    endResetModel();
+}
+
+int SearchResultModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    return m_loaded.size();
+}
+
+QVariant SearchResultModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_loaded.size()) {
+        return QVariant();
+    }
+
+    const SearchResult& result = m_loaded.at(index.row());
+
+    switch (role) {
+    case Qt::DisplayRole:
+        return tr("第 %1 页: %2").arg(result.pageIndex + 1).arg(result.context);
+    case PageIndexRole:
+        return result.pageIndex;
+    case MatchIndexRole:
+        return index.row();
+    default:
+        return QVariant();
+    }
+}
+
+void SearchResultModel::setActive(bool active)
+{
+    if (m_active == active) {
+        return;
+    }
+
+    m_active = active;
+    if (m_active && m_searchManager) {
+        onResultsAvailable(m_searchManager->totalMatches());
+    }
+}
+
+bool SearchResultModel::canFetchMore(const QModelIndex& parent) const
+{
+    if (parent.isValid() || !m_searchManager || !m_active) {
+        return false;
+    }
+    return m_loaded.size() < m_searchManager->totalMatches();
+}
+
+void SearchResultModel::fetchMore(const QModelIndex& parent)
+{
+    if (parent.isValid() || !m_searchManager) {
+        return;
+    }
+
+    // 按页拉取，上下文在此时才生成
+    QVector<SearchResult> page = m_searchManager->resultsPage(m_loaded.size(), m_pageSize);
+    if (page.isEmpty()) {
+        return;
+    }
+
+    beginInsertRows(QModelIndex(), m_loaded.size(), m_loaded.size() + page.size() - 1);
+    m_loaded += page;
+    endInsertRows();
+}
+
+void SearchResultModel::onResultsAvailable(int totalMatches)
+{
+    // 列表展开且首屏未填满时主动加载，其余由视图滚动触发 fetchMore
+    if (m_active && m_loaded.size() < m_pageSize && m_loaded.size() < totalMatches) {
+        fetchMore(QModelIndex());
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef SEARCHRESULTMODEL_H
+#define SEARCHRESULTMODEL_H
+
+#include <QAbstractListModel>
+#include <QPointer>
+#include <QVector>
+#include "datastructure.h"
+
+class SearchManager;
+
+/**
+ * @brief 搜索结果列表模型（分页加载）
+ *
+ * - 结果本身只保存位置，上下文在行被加载时才生成
+ * - 通过 canFetchMore/fetchMore 按页从 SearchManager 拉取，
+ *   结果数不设上限时列表也只会物化用户滚动到的部分
+ * - 列表收起时（setActive(false)）不拉取，展开时才加载首屏
+ */
+class SearchResultModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Roles {
+        PageIndexRole = Qt::UserRole + 1,
+        MatchIndexRole
+    };
+
+    explicit SearchResultModel(QObject* parent = nullptr);
+
+    void setSearchManager(SearchManager* manager);
+
+    /**
+     * @brief 清空已加载的行（开始新搜索时调用）
+     */
+    void reset();
+
+    /**
+     * @brief 设置列表是否展开，展开时加载首屏，收起时不再拉取
+     */
+    void setActive(bool active);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+
+private slots:
+    void onResultsAvailable(int totalMatches);
+
+private:
+    QPointer<SearchManager> m_searchManager;
+    QVector<SearchResult> m_loaded;     // 已加载的结果（含上下文）
+    int m_pageSize;
+    bool m_active;                      // 列表是否展开
+};
+
+#endif // SEARCHRESULTMODEL_H
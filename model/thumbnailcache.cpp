@@ -1,8 +1,14 @@
 #include "thumbnailcache.h"
-#include <QReadLocker>
-#include <QWriteLocker>
+#include <QMutexLocker>
+#include <cstring>
 
-ThumbnailCache::ThumbnailCache()
+ThumbnailCache::ThumbnailCache(qint64 maxBytes, bool compact)
+    : m_maxBytes(maxBytes)
+    , m_compact(compact)
+    , m_cacheBytes(0)
+    , m_evictionCount(0)
+    , m_protectedFirst(0)
+    , m_protectedLast(-1)
 {
 }
 
@@ -12,8 +18,19 @@ ThumbnailCache::~ThumbnailCache()
 
 QImage ThumbnailCache::get(int pageIndex) const
 {
-    QReadLocker locker(&m_lock);
-    return m_cache.value(pageIndex, QImage());
+    CacheEntry entry;
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_cache.constFind(pageIndex);
+        if (it == m_cache.constEnd()) {
+            return QImage();
+        }
+        m_lru.splice(m_lru.begin(), m_lru, it->lruPos);
+        entry = it.value();     // 隐式共享，不复制像素
+    }
+
+    // 在锁外解码
+    return decode(entry);
 }
 
 void ThumbnailCache::set(int pageIndex, const QImage& thumbnail)
@@ -22,36 +39,173 @@ void ThumbnailCache::set(int pageIndex, const QImage& thumbnail)
         return;
     }
 
-    QWriteLocker locker(&m_lock);
-    m_cache[pageIndex] = thumbnail;
+    // 在锁外编码（调用方通常是渲染线程）
+    CacheEntry entry = encode(thumbnail, m_compact);
+
+    QMutexLocker locker(&m_mutex);
+    auto it = m_cache.find(pageIndex);
+    if (it != m_cache.end()) {
+        m_cacheBytes -= it->bytes;
+        entry.lruPos = it->lruPos;
+        m_lru.splice(m_lru.begin(), m_lru, entry.lruPos);
+    } else {
+        m_lru.push_front(pageIndex);
+        entry.lruPos = m_lru.begin();
+    }
+
+    m_cacheBytes += entry.bytes;
+    m_cache.insert(pageIndex, entry);
+
+    evictLocked(pageIndex);
 }
 
 bool ThumbnailCache::has(int pageIndex) const
 {
-    QReadLocker locker(&m_lock);
+    QMutexLocker locker(&m_mutex);
     return m_cache.contains(pageIndex);
 }
 
+void ThumbnailCache::setProtectedRange(int first, int last)
+{
+    QMutexLocker locker(&m_mutex);
+    m_protectedFirst = first;
+    m_protectedLast = last;
+}
+
+bool ThumbnailCache::isFull() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_maxBytes >= 0 && m_cacheBytes >= m_maxBytes;
+}
+
 void ThumbnailCache::clear()
 {
-    QWriteLocker locker(&m_lock);
+    QMutexLocker locker(&m_mutex);
     m_cache.clear();
+    m_lru.clear();
+    m_cacheBytes = 0;
+    m_protectedFirst = 0;
+    m_protectedLast = -1;
 }
 
 QString ThumbnailCache::getStatistics() const
 {
-    int cachedCount = count();
-
-    // 估算内存占用（平均 50KB/页）
-    qint64 memoryKB = cachedCount * 50;
+    QMutexLocker locker(&m_mutex);
 
-    return QString("Thumbnail Cache: %1 pages (%.2 MB)")
-        .arg(cachedCount)
-        .arg(memoryKB / 1024.0, 0, 'f', 2);
+    return QString("Thumbnail Cache: %1 pages (%2 MB), %3 evicted")
+        .arg(m_cache.size())
+        .arg(m_cacheBytes / (1024.0 * 1024.0), 0, 'f', 2)
+        .arg(m_evictionCount);
 }
 
 int ThumbnailCache::count() const
 {
-    QReadLocker locker(&m_lock);
+    QMutexLocker locker(&m_mutex);
     return m_cache.size();
 }
+
+void ThumbnailCache::evictLocked(int keepPage)
+{
+    if (m_maxBytes < 0) {
+        return;
+    }
+
+    // 从最久未访问的一端淘汰，跳过保护区；剩下的都在保护区内时允许暂时超出预算
+    auto pos = m_lru.end();
+    while (m_cacheBytes > m_maxBytes && pos != m_lru.begin()) {
+        --pos;
+        const int pageIndex = *pos;
+        if (pageIndex == keepPage ||
+            (pageIndex >= m_protectedFirst && pageIndex <= m_protectedLast)) {
+            continue;
+        }
+
+        auto victim = m_cache.find(pageIndex);
+        m_cacheBytes -= victim->bytes;
+        m_cache.erase(victim);
+        pos = m_lru.erase(pos);
+        ++m_evictionCount;
+    }
+}
+
+// ========== 编码 ==========
+
+bool ThumbnailCache::isGrayscale(const QImage& image)
+{
+    if (image.format() == QImage::Format_Grayscale8) {
+        return true;
+    }
+    if (image.format() != QImage::Format_RGB888) {
+        return image.allGray();
+    }
+
+    // 抗锯齿边缘允许 ±2 的通道差
+    for (int y = 0; y < image.height(); ++y) {
+        const uchar* p = image.constScanLine(y);
+        for (int x = 0; x < image.width(); ++x, p += 3) {
+            if (qAbs(p[0] - p[1]) > 2 || qAbs(p[1] - p[2]) > 2) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+ThumbnailCache::CacheEntry ThumbnailCache::encode(const QImage& thumbnail, bool compact)
+{
+    CacheEntry entry;
+    entry.size = thumbnail.size();
+
+    if (!compact) {
+        entry.encoding = Encoding::Raw;
+        entry.image = thumbnail;
+        entry.bytes = thumbnail.sizeInBytes();
+        return entry;
+    }
+
+    if (isGrayscale(thumbnail)) {
+        entry.encoding = Encoding::Gray8;
+        entry.image = thumbnail.convertToFormat(QImage::Format_Grayscale8);
+        entry.bytes = entry.image.sizeInBytes();
+        return entry;
+    }
+
+    // 彩色页面：去掉行尾对齐后压缩
+    const QImage rgb = (thumbnail.format() == QImage::Format_RGB888)
+                           ? thumbnail : thumbnail.convertToFormat(QImage::Format_RGB888);
+    const int rowBytes = rgb.width() * 3;
+
+    QByteArray rows;
+    rows.resize(qint64(rowBytes) * rgb.height());
+    for (int y = 0; y < rgb.height(); ++y) {
+        std::memcpy(rows.data() + qint64(y) * rowBytes, rgb.constScanLine(y), rowBytes);
+    }
+
+    entry.encoding = Encoding::Deflate;
+    entry.packed = qCompress(rows, 1);
+    entry.bytes = entry.packed.size();
+    return entry;
+}
+
+QImage ThumbnailCache::decode(const CacheEntry& entry)
+{
+    if (entry.encoding != Encoding::Deflate) {
+        return entry.image;
+    }
+
+    const QByteArray rows = qUncompress(entry.packed);
+    const int rowBytes = entry.size.width() * 3;
+    if (rows.size() != qint64(rowBytes) * entry.size.height()) {
+        return QImage();
+    }
+
+    QImage image(entry.size, QImage::Format_RGB888);
+    if (image.isNull()) {
+        return QImage();
+    }
+
+    for (int y = 0; y < entry.size.height(); ++y) {
+        std::memcpy(image.scanLine(y), rows.constData() + qint64(y) * rowBytes, rowBytes);
+    }
+    return image;
+}
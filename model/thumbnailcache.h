@@ -3,12 +3,29 @@
 
 #include <QImage>
 #include <QHash>
-#include <QReadWriteLock>
+#include <QMutex>
+#include <QByteArray>
+#include <list>
 
+/**
+ * @brief 缩略图内存缓存
+ *
+ * 按字节预算做 LRU 淘汰，保护区（可见区及预加载区）内的页面不淘汰；
+ * 被淘汰的页面再次滚入视口时由 ThumbnailManagerV2 重新请求（通常从缩略图文件读回）。
+ *
+ * 紧凑模式下按内容选择存储格式：
+ * - 灰度页面（扫描件常见）存为 8 位灰度图，体积为 RGB888 的 1/3
+ * - 彩色页面存为压缩后的 RGB888 行，读取时解压
+ * 编码在写入线程（渲染线程）完成，解码只在对应行滚入视口、界面取图时发生。
+ */
 class ThumbnailCache
 {
 public:
-    ThumbnailCache();
+    /**
+     * @param maxBytes 内存上限（字节，-1 表示不限制）
+     * @param compact 是否使用紧凑编码
+     */
+    explicit ThumbnailCache(qint64 maxBytes = -1, bool compact = false);
     ~ThumbnailCache();
 
     // 缩略图缓存（移除高清/低清区分，统一使用单一缓存）
@@ -16,14 +33,58 @@ public:
     void set(int pageIndex, const QImage& thumbnail);
     bool has(int pageIndex) const;
 
+    /**
+     * @brief 设置保护区 [first, last]，区内页面不被淘汰
+     */
+    void setProtectedRange(int first, int last);
+
+    /**
+     * @brief 是否已达到内存上限（用于暂停后台补齐）
+     */
+    bool isFull() const;
+
     // 管理
     void clear();
     QString getStatistics() const;
     int count() const;
 
+    /**
+     * @brief 是否为灰度图（允许抗锯齿边缘的少量通道差，缩略图文件也据此选择编码）
+     */
+    static bool isGrayscale(const QImage& image);
+
 private:
-    QHash<int, QImage> m_cache;
-    mutable QReadWriteLock m_lock;
+    enum class Encoding : quint8 {
+        Raw,            // 原图
+        Gray8,          // 8 位灰度
+        Deflate         // 压缩的 RGB888 行
+    };
+
+    struct CacheEntry {
+        Encoding encoding = Encoding::Raw;
+        QImage image;           // Raw / Gray8
+        QByteArray packed;      // Deflate
+        QSize size;
+        qint64 bytes = 0;
+        std::list<int>::iterator lruPos;    // 在 m_lru 中的位置
+    };
+
+    static CacheEntry encode(const QImage& thumbnail, bool compact);
+    static QImage decode(const CacheEntry& entry);
+
+    // 以下需持有 m_mutex
+    void evictLocked(int keepPage);
+
+    // LRU：访问时把页移到 m_lru 头部，淘汰从尾部开始（保护区内的页留在原位跳过）
+    QHash<int, CacheEntry> m_cache;
+    mutable std::list<int> m_lru;       // 最近访问的在前
+    qint64 m_maxBytes;
+    bool m_compact;
+    qint64 m_cacheBytes;
+    qint64 m_evictionCount;
+    int m_protectedFirst;
+    int m_protectedLast;
+    mutable QMutex m_mutex;
 };
 
 #endif // THUMBNAILCACHE_H
@@ -0,0 +1,189 @@
+#include "thumbnailscheduler.h"
+#include <QtGlobal>
+
+ThumbnailScheduler::ThumbnailScheduler()
+    : m_doneCount(0)
+    , m_inFlightCount(0)
+    , m_backfillLimit(0)
+    , m_first(0)
+    , m_last(-1)
+    , m_preloadPages(0)
+    , m_scrolling(false)
+    , m_forward(true)
+{
+}
+
+void ThumbnailScheduler::reset(int pageCount, int backfillLimit)
+{
+    m_states.fill(PageState::Pending, qMax(0, pageCount));
+    m_doneCount = 0;
+    m_inFlightCount = 0;
+    m_backfillLimit = backfillLimit;
+    m_first = 0;
+    m_last = -1;
+    m_preloadPages = 0;
+    m_scrolling = false;
+    m_forward = true;
+}
+
+void ThumbnailScheduler::setViewport(int first, int last, int preloadPages, bool scrolling)
+{
+    if (first != m_first) {
+        m_forward = first > m_first;
+    }
+
+    m_first = first;
+    m_last = last;
+    m_preloadPages = qMax(0, preloadPages);
+    m_scrolling = scrolling;
+}
+
+bool ThumbnailScheduler::isWanted(int pageIndex) const
+{
+    if (pageIndex >= m_first && pageIndex <= m_last) {
+        return true;
+    }
+    const int distance = (pageIndex > m_last) ? pageIndex - m_last : m_first - pageIndex;
+    return distance <= m_preloadPages;
+}
+
+bool ThumbnailScheduler::isPending(int pageIndex) const
+{
+    return pageIndex >= 0 && pageIndex < m_states.size() &&
+           m_states[pageIndex] == PageState::Pending;
+}
+
+bool ThumbnailScheduler::isDone(int pageIndex) const
+{
+    return pageIndex >= 0 && pageIndex < m_states.size() &&
+           m_states[pageIndex] == PageState::Done;
+}
+
+void ThumbnailScheduler::collectOutward(int fromDistance, int toDistance, int maxPages,
+                                        QVector<int>* batch) const
+{
+    // 可见区两侧交替向外，滚动方向一侧先取
+    for (int d = fromDistance; d <= toDistance && batch->size() < maxPages; ++d) {
+        const int ahead = m_forward ? m_last + d : m_first - d;
+        const int behind = m_forward ? m_first - d : m_last + d;
+
+        if (isPending(ahead)) {
+            batch->append(ahead);
+        }
+        if (batch->size() < maxPages && isPending(behind)) {
+            batch->append(behind);
+        }
+
+        // 两侧都已越界
+        if ((m_last + d >= m_states.size()) && (m_first - d < 0)) {
+            break;
+        }
+    }
+}
+
+QVector<int> ThumbnailScheduler::collect(int maxPages, bool allowBackfill,
+                                         RenderPriority* priority) const
+{
+    QVector<int> batch;
+    if (maxPages <= 0 || m_states.isEmpty()) {
+        return batch;
+    }
+
+    // 1. 可见区
+    const int visibleEnd = qMin(m_last, int(m_states.size()) - 1);
+    for (int i = qMax(0, m_first); i <= visibleEnd && batch.size() < maxPages; ++i) {
+        if (isPending(i)) {
+            batch.append(i);
+        }
+    }
+    if (!batch.isEmpty()) {
+        *priority = RenderPriority::HIGH;
+        return batch;
+    }
+
+    // 2. 预加载区
+    collectOutward(1, m_preloadPages, maxPages, &batch);
+    if (!batch.isEmpty()) {
+        *priority = RenderPriority::MEDIUM;
+        return batch;
+    }
+
+    // 3. 滚动停止后向外补齐
+    const int budget = m_backfillLimit - m_doneCount - m_inFlightCount;
+    if (allowBackfill && !m_scrolling && budget > 0) {
+        collectOutward(m_preloadPages + 1, int(m_states.size()), qMin(maxPages, budget), &batch);
+        *priority = RenderPriority::LOW;
+    }
+
+    return batch;
+}
+
+QVector<int> ThumbnailScheduler::takeBatch(int maxPages, bool allowBackfill,
+                                           RenderPriority* priority)
+{
+    QVector<int> batch = collect(maxPages, allowBackfill, priority);
+    for (int pageIndex : batch) {
+        m_states[pageIndex] = PageState::InFlight;
+    }
+    m_inFlightCount += batch.size();
+    return batch;
+}
+
+bool ThumbnailScheduler::hasPendingWork(bool allowBackfill) const
+{
+    RenderPriority priority;
+    return !collect(1, allowBackfill, &priority).isEmpty();
+}
+
+void ThumbnailScheduler::markDone(int pageIndex)
+{
+    if (pageIndex < 0 || pageIndex >= m_states.size() ||
+        m_states[pageIndex] == PageState::Done) {
+        return;
+    }
+
+    if (m_states[pageIndex] == PageState::InFlight) {
+        m_inFlightCount--;
+    }
+    m_states[pageIndex] = PageState::Done;
+    m_doneCount++;
+}
+
+void ThumbnailScheduler::markFailed(int pageIndex)
+{
+    if (pageIndex < 0 || pageIndex >= m_states.size()) {
+        return;
+    }
+
+    if (m_states[pageIndex] == PageState::InFlight) {
+        m_inFlightCount--;
+    } else if (m_states[pageIndex] == PageState::Done) {
+        m_doneCount--;
+    }
+    m_states[pageIndex] = PageState::Failed;
+}
+
+void ThumbnailScheduler::release(int pageIndex)
+{
+    if (pageIndex < 0 || pageIndex >= m_states.size()) {
+        return;
+    }
+
+    if (m_states[pageIndex] == PageState::InFlight) {
+        m_inFlightCount--;
+    } else if (m_states[pageIndex] == PageState::Done) {
+        m_doneCount--;
+    }
+    m_states[pageIndex] = PageState::Pending;
+}
+
+void ThumbnailScheduler::requeue(int pageIndex)
+{
+    if (pageIndex < 0 || pageIndex >= m_states.size()) {
+        return;
+    }
+
+    if (m_states[pageIndex] == PageState::Done || m_states[pageIndex] == PageState::Failed) {
+        release(pageIndex);
+    }
+}
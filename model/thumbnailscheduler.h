@@ -0,0 +1,103 @@
+#ifndef THUMBNAILSCHEDULER_H
+#define THUMBNAILSCHEDULER_H
+
+#include <QVector>
+
+/**
+ * @brief 渲染优先级
+ */
+enum class RenderPriority {
+    HIGH,         // 高优先级（可见区）
+    MEDIUM,       // 中优先级（预加载区）
+    LOW           // 低优先级（空闲时后台补齐）
+};
+
+/**
+ * @brief 缩略图调度器（按视口决定渲染顺序，与文档页数无关）
+ *
+ * 取任务顺序：
+ * 1. 可见区内未渲染的页
+ * 2. 预加载区：从可见区向外逐页扩展，滚动方向一侧优先
+ * 3. 滚动停止后继续向外补齐，直到已渲染页数达到补齐上限
+ *
+ * 每页记录一个状态，已取出但未完成的页不会被重复取出；
+ * 任务被取消时未完成的页调用 release() 放回，按新的视口重新排序。
+ * 只在主线程使用，不加锁。
+ */
+class ThumbnailScheduler
+{
+public:
+    ThumbnailScheduler();
+
+    void reset(int pageCount, int backfillLimit);
+    int pageCount() const { return m_states.size(); }
+
+    /**
+     * @brief 更新视口
+     * @param first 第一个可见页（没有可见页时 last < first）
+     * @param last 最后一个可见页
+     * @param preloadPages 可见区前后各预加载的页数
+     * @param scrolling 是否正在滚动（滚动中不做后台补齐）
+     */
+    void setViewport(int first, int last, int preloadPages, bool scrolling);
+
+    /**
+     * @brief 页面是否位于可见区或预加载区
+     */
+    bool isWanted(int pageIndex) const;
+
+    /**
+     * @brief 取出下一批待渲染的页（同一批页面优先级相同）
+     * @param maxPages 最多取出的页数
+     * @param allowBackfill 是否允许取出后台补齐的页
+     * @param priority 输出：该批次的优先级
+     * @return 页面索引，没有待渲染的页时为空
+     */
+    QVector<int> takeBatch(int maxPages, bool allowBackfill, RenderPriority* priority);
+
+    void markDone(int pageIndex);
+    void markFailed(int pageIndex);
+
+    /**
+     * @brief 把页面放回待渲染状态（任务取消，或缓存中的缩略图被丢弃）
+     */
+    void release(int pageIndex);
+
+    /**
+     * @brief 已完成或失败的页重新排队，待渲染和渲染中的页不受影响
+     */
+    void requeue(int pageIndex);
+
+    bool isDone(int pageIndex) const;
+    int doneCount() const { return m_doneCount; }
+
+    /**
+     * @brief 按当前视口是否还有可取出的页
+     */
+    bool hasPendingWork(bool allowBackfill) const;
+
+private:
+    enum class PageState : quint8 {
+        Pending,
+        InFlight,
+        Done,
+        Failed
+    };
+
+    bool isPending(int pageIndex) const;
+    QVector<int> collect(int maxPages, bool allowBackfill, RenderPriority* priority) const;
+    void collectOutward(int fromDistance, int toDistance, int maxPages, QVector<int>* batch) const;
+
+    QVector<PageState> m_states;
+    int m_doneCount;
+    int m_inFlightCount;
+    int m_backfillLimit;
+
+    int m_first;
+    int m_last;
+    int m_preloadPages;
+    bool m_scrolling;
+    bool m_forward;         // 最近一次滚动方向是否向后
+};
+
+#endif // THUMBNAILSCHEDULER_H
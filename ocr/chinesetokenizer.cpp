@@ -1,7 +1,9 @@
 #include "chinesetokenizer.h"
+#include "datastructure.h"
 #include "rapidocr-cpp/utils.h"
 #include <QFileInfo>
 #include <QDebug>
+#include <QMutexLocker>
 #include <cmath>
 
 ChineseTokenizer& ChineseTokenizer::instance()
@@ -12,6 +14,7 @@ ChineseTokenizer& ChineseTokenizer::instance()
 
 ChineseTokenizer::ChineseTokenizer()
     : m_initialized(false)
+    , m_initAttempted(false)
 {
 }
 
@@ -21,7 +24,31 @@ ChineseTokenizer::~ChineseTokenizer()
 
 bool ChineseTokenizer::initialize(const QString& dictDir)
 {
-    if (m_initialized) {
+    QMutexLocker locker(&m_initMutex);
+    return initializeLocked(dictDir);
+}
+
+bool ChineseTokenizer::ensureInitialized(const QString& dictDir)
+{
+    if (isInitialized()) {
+        return true;
+    }
+
+    QMutexLocker locker(&m_initMutex);
+    if (m_initialized.load(std::memory_order_acquire)) {
+        return true;
+    }
+    if (m_initAttempted) {
+        return false;
+    }
+    return initializeLocked(dictDir);
+}
+
+bool ChineseTokenizer::initializeLocked(const QString& dictDir)
+{
+    m_initAttempted = true;
+
+    if (m_initialized.load(std::memory_order_acquire)) {
         qInfo() << "ChineseTokenizer already initialized";
         return true;
     }
@@ -58,7 +85,7 @@ bool ChineseTokenizer::initialize(const QString& dictDir)
             stopWordsPath.toStdString()
             );
 
-        m_initialized = true;
+        m_initialized.store(true, std::memory_order_release);
         qInfo() << "ChineseTokenizer initialized successfully";
         return true;
 
@@ -263,6 +290,56 @@ QVector<TokenWithPosition> ChineseTokenizer::tokenizeWithPosition(
     return result;
 }
 
+static inline bool isCJKChar(char32_t u)
+{
+    return (u >= 0x4E00 && u <= 0x9FFF) ||    // CJK Unified Ideographs
+           (u >= 0x3400 && u <= 0x4DBF) ||    // CJK Extension A
+           (u >= 0xF900 && u <= 0xFAFF) ||    // CJK Compatibility Ideographs
+           (u >= 0x3040 && u <= 0x30FF) ||    // Japanese Hiragana/Katakana
+           (u >= 0xAC00 && u <= 0xD7AF);      // Korean Hangul
+}
+
+void ChineseTokenizer::buildWordIndex(PageTextData& data) const
+{
+    data.wordBreaks.clear();
+
+    if (!isInitialized()) {
+        return;
+    }
+
+    std::vector<cppjieba::Word> words;
+
+    for (int line = 0; line < data.totalLineCount(); ++line) {
+        const int lineFirst = data.lineCharStarts[line];
+        const int lineEnd = data.lineCharStarts[line + 1];
+
+        // 纯西文行保持原有的字母数字边界规则，不分词
+        bool hasCJK = false;
+        for (int i = lineFirst; i < lineEnd && !hasCJK; ++i) {
+            hasCJK = isCJKChar(data.codepoints[i]);
+        }
+        if (!hasCJK) {
+            continue;
+        }
+
+        try {
+            words.clear();
+            m_jieba->Cut(data.lineText(line).toStdString(), words, false);
+        } catch (const std::exception& e) {
+            qWarning() << "ChineseTokenizer: buildWordIndex error:" << e.what();
+            continue;
+        }
+
+        // unicode_offset 按码点计数，与页面字符序号一致
+        for (const cppjieba::Word& word : words) {
+            data.wordBreaks.append(lineFirst + static_cast<int>(word.unicode_offset));
+        }
+        data.wordBreaks.append(lineEnd);
+    }
+
+    data.wordBreaks.squeeze();
+}
+
 QRect ChineseTokenizer::boundingRectFromBox(
     const std::vector<cv::Point2f>& box)
 {
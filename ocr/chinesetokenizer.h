@@ -5,10 +5,15 @@
 #include <QStringList>
 #include <QPoint>
 #include <QRect>
+#include <QVector>
+#include <QMutex>
+#include <atomic>
 #include <memory>
 #include "cppjieba/Jieba.hpp"
 #include "ocrengine.h"
 
+struct PageTextData;
+
 /**
  * @brief 分词结果 - 带位置信息的词
  */
@@ -39,10 +44,16 @@ public:
      */
     bool initialize(const QString& dictDir);
 
+    /**
+     * @brief 确保分词器已初始化（可在工作线程调用）
+     * 失败只尝试一次，之后直接返回 false，避免每页重复加载词典
+     */
+    bool ensureInitialized(const QString& dictDir);
+
     /**
      * @brief 检查是否已初始化
      */
-    bool isInitialized() const { return m_initialized; }
+    bool isInitialized() const { return m_initialized.load(std::memory_order_acquire); }
 
     /**
      * @brief 对文本进行分词
@@ -66,6 +77,14 @@ public:
      */
     QVector<TokenWithPosition> tokenizeWithPosition(const OCRResult& ocr);
 
+    /**
+     * @brief 为页面文本建立分词索引（填充 PageTextData::wordBreaks）
+     *
+     * 只对含中日韩字符的行分词，记录每个词的起点字符序号和行尾。
+     * 在预加载工作线程中调用，搜索时只需二分查找，不再逐次分词。
+     */
+    void buildWordIndex(PageTextData& data) const;
+
     /**
      * @brief 从四边形框计算边界矩形
      */
@@ -117,9 +136,13 @@ private:
         int lineIndex
         );
 
+    bool initializeLocked(const QString& dictDir);
+
 private:
     std::unique_ptr<cppjieba::Jieba> m_jieba;
-    bool m_initialized;
+    std::atomic<bool> m_initialized;
+    bool m_initAttempted;
+    QMutex m_initMutex;
     QString m_lastError;
     QString m_dictDir;
 };
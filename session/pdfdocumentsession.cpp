@@ -1,6 +1,7 @@
 #include "pdfdocumentsession.h"
 #include "perthreadmupdfrenderer.h"
 #include "pagecachemanager.h"
+#include "papereffectenhancer.h"
 #include "textcachemanager.h"
 #include "pdfviewhandler.h"
 #include "pdfcontenthandler.h"
@@ -14,6 +15,8 @@
 
 PDFDocumentSession::PDFDocumentSession(QObject* parent)
     : QObject(parent)
+    , m_paperEffectEnabled(false)
+    , m_paperLayerGeneration(0)
 {
     m_renderer = std::make_unique<PerThreadMuPDFRenderer>();
 
@@ -34,12 +37,17 @@ PDFDocumentSession::PDFDocumentSession(QObject* parent)
 
     m_state = std::make_unique<PDFDocumentState>(this);
 
+    m_paperEffect = std::make_unique<PaperEffectEnhancer>();
+    m_paperEffectPool.setMaxThreadCount(1);
+
     setupConnections();
 }
 
 PDFDocumentSession::~PDFDocumentSession()
 {
     disconnect(m_interactionHandler.get(), nullptr, this, nullptr);
+    m_paperEffectPool.clear();
+    m_paperEffectPool.waitForDone();
     closeDocument();
     qInfo() << "PDFDocumentSession: Destroyed";
 }
@@ -80,6 +88,11 @@ void PDFDocumentSession::closeDocument()
         m_textCache->cancelPreload();
     }
 
+    // 作废正在生成的纸质效果图层
+    ++m_paperLayerGeneration;
+    m_pendingLayers.clear();
+    m_paperEffectPool.clear();
+
     if (m_pageCache) {
         m_pageCache->clear();
     }
@@ -300,10 +313,12 @@ QString PDFDocumentSession::getThumbnailStatistics() const
 void PDFDocumentSession::startSearch(const QString& query,
                                      bool caseSensitive,
                                      bool wholeWords,
-                                     int startPage)
+                                     int startPage,
+                                     bool foldInsensitive)
 {
     if (m_interactionHandler) {
-        m_interactionHandler->startSearch(query, caseSensitive, wholeWords, startPage);
+        m_interactionHandler->startSearch(query, caseSensitive, wholeWords, startPage,
+                                          foldInsensitive);
     }
 }
 
@@ -324,6 +339,11 @@ SearchResult PDFDocumentSession::findPrevious()
     return m_interactionHandler ? m_interactionHandler->findPrevious() : SearchResult();
 }
 
+SearchResult PDFDocumentSession::findAt(int index)
+{
+    return m_interactionHandler ? m_interactionHandler->findAt(index) : SearchResult();
+}
+
 void PDFDocumentSession::startTextSelection(int pageIndex, const QPointF& pagePos, double zoom)
 {
     if (m_interactionHandler) {
@@ -584,16 +604,31 @@ void PDFDocumentSession::setupConnections()
         // 文档事件直接转发（非状态变化）
         connect(m_contentHandler.get(), &PDFContentHandler::documentLoaded,
                 this, [this](const QString& filePath, int pageCount){
-                    // 更新State
-                    bool isTextPDF = m_contentHandler->isTextPDF(5);
-                    m_state->setDocumentLoaded(true, filePath, pageCount, isTextPDF);
+                    // 更新State（类型检测在后台进行，结果出来前按扫描版处理）
+                    m_state->setDocumentLoaded(true, filePath, pageCount, false);
                     m_state->setCurrentPage(0); // 重置到第一页
 
                     qInfo() << "PDFDocumentSession: Document loaded -"
+                            << QFileInfo(filePath).fileName();
+
+                    emit documentLoaded(filePath, pageCount);
+
+                    m_contentHandler->detectDocumentTypeAsync(
+                        AppConfig::instance().pdfTypeDetectSamplePages());
+                });
+        connect(m_contentHandler.get(), &PDFContentHandler::documentTypeDetected,
+                this, [this](const QString& filePath, bool isTextPDF) {
+                    if (!m_state->isDocumentLoaded() || m_state->documentPath() != filePath) {
+                        return;
+                    }
+
+                    m_state->setTextPDF(isTextPDF);
+
+                    qInfo() << "PDFDocumentSession: Document type detected -"
                             << QFileInfo(filePath).fileName()
                             << "Type:" << (isTextPDF ? "Text PDF" : "Scanned PDF");
 
-                    emit documentLoaded(filePath, pageCount);
+                    emit documentTypeChanged(isTextPDF);
                 });
         connect(m_contentHandler.get(), &PDFContentHandler::documentError,
                 this, &PDFDocumentSession::documentError);
@@ -664,6 +699,10 @@ void PDFDocumentSession::setupConnections()
                 this, &PDFDocumentSession::textPreloadCompleted);
         connect(m_textCache.get(), &TextCacheManager::preloadCancelled,
                 this, &PDFDocumentSession::textPreloadCancelled);
+
+        // 翻页后文本预加载优先处理新位置附近的页
+        connect(this, &PDFDocumentSession::currentPageChanged,
+                m_textCache.get(), &TextCacheManager::setFocusPage);
     }
 }
 
@@ -683,19 +722,55 @@ void PDFDocumentSession::updateCacheAfterStateChange()
 
 void PDFDocumentSession::setPaperEffectEnabled(bool enabled)
 {
-    if (m_renderer) {
-        m_renderer->setPaperEffectEnabled(enabled);
+    if (m_paperEffectEnabled == enabled) {
+        return;
+    }
+
+    // 原始页面和已生成的派生图层都保留，重新开启时直接复用
+    m_paperEffectEnabled = enabled;
+    emit paperEffectChanged(enabled);
+}
+
+bool PDFDocumentSession::paperEffectEnabled() const
+{
+    return m_paperEffectEnabled;
+}
+
+QImage PDFDocumentSession::composePage(int pageIndex, double zoom, int rotation, const QImage& source)
+{
+    if (!m_paperEffectEnabled || source.isNull()) {
+        return source;
+    }
+
+    const QImage layer = m_pageCache->getLayer(pageIndex, zoom, rotation);
+    if (!layer.isNull()) {
+        return layer;
+    }
 
-        // 清空缓存以便重新渲染
-        if (m_pageCache) {
-            m_pageCache->clear();
-        }
+    // 在后台线程生成，完成前先显示原始页面
+    const PageCacheKey key(pageIndex, zoom, rotation);
+    if (!m_pendingLayers.contains(key)) {
+        m_pendingLayers.append(key);
 
-        emit paperEffectChanged(enabled);
+        const int generation = m_paperLayerGeneration;
+        m_paperEffectPool.start([this, key, source, generation]() {
+            const QImage result = m_paperEffect->enhance(source);
+            QMetaObject::invokeMethod(this, [this, key, result, generation]() {
+                finishPaperLayer(key, result, generation);
+            }, Qt::QueuedConnection);
+        });
     }
+
+    return source;
 }
 
-bool PDFDocumentSession::paperEffectEnabled() const
+void PDFDocumentSession::finishPaperLayer(const PageCacheKey& key, const QImage& layer, int generation)
 {
-    return m_renderer ? m_renderer->paperEffectEnabled() : false;
+    if (generation != m_paperLayerGeneration) {
+        return;     // 文档已关闭
+    }
+
+    m_pendingLayers.removeOne(key);
+    m_pageCache->setLayer(key.pageIndex, key.zoom, key.rotation, layer);
+    emit paperLayerReady(key.pageIndex);
 }
@@ -6,15 +6,18 @@
 #include <QImage>
 #include <QSize>
 #include <QPointF>
+#include <QList>
+#include <QThreadPool>
 #include <memory>
 
 #include "datastructure.h"
+#include "pagecachemanager.h"
 #include "textcachemanager.h"
 #include "pdfcontenthandler.h"
 #include "pdfdocumentstate.h"
 
 class PerThreadMuPDFRenderer;
-class PageCacheManager;
+class PaperEffectEnhancer;
 class PDFViewHandler;
 class PDFContentHandler;
 class PDFInteractionHandler;
@@ -189,7 +192,8 @@ public:
     void startSearch(const QString& query,
                      bool caseSensitive = false,
                      bool wholeWords = false,
-                     int startPage = 0);
+                     int startPage = 0,
+                     bool foldInsensitive = false);
 
     /**
      * @brief 取消搜索
@@ -206,6 +210,11 @@ public:
      */
     SearchResult findPrevious();
 
+    /**
+     * @brief 跳转到指定索引的搜索结果
+     */
+    SearchResult findAt(int index);
+
     /**
      * @brief 开始文本选择
      */
@@ -292,9 +301,26 @@ public:
     void saveViewportState(int scrollY);
     void clearViewportRestore();
 
+    // ==================== 纸质效果 ====================
+
+    /**
+     * @brief 开关纸质效果
+     *
+     * 纸质效果不参与渲染，页面缓存始终保存原始渲染结果；
+     * 效果图作为派生图层与原始页面一起缓存，切换时无需重新渲染。
+     */
     void setPaperEffectEnabled(bool enabled);
     bool paperEffectEnabled() const;
 
+    /**
+     * @brief 获取用于显示的页面图像
+     *
+     * 派生图层在后台线程生成，生成完成前返回 source，完成后发出 paperLayerReady()
+     * @param source 原始渲染结果
+     * @return 纸质效果开启且图层已生成时为派生图层，否则为 source
+     */
+    QImage composePage(int pageIndex, double zoom, int rotation, const QImage& source);
+
 signals:
     /**
      * @brief 文档加载状态变化
@@ -430,10 +456,18 @@ signals:
 
     void paperEffectChanged(bool enabled);
 
+    /**
+     * @brief 页面的纸质效果图层已生成（需要重绘）
+     */
+    void paperLayerReady(int pageIndex);
+
 private:
     void setupConnections();
     void updateCacheAfterStateChange();
 
+    // 后台生成的图层回到主线程后写入页面缓存
+    void finishPaperLayer(const PageCacheKey& key, const QImage& layer, int generation);
+
 private:
     // 核心组件
     std::unique_ptr<PerThreadMuPDFRenderer> m_renderer;
@@ -447,6 +481,13 @@ private:
 
     // State（集中管理状态）
     std::unique_ptr<PDFDocumentState> m_state;
+
+    // 纸质效果（显示时合成）
+    std::unique_ptr<PaperEffectEnhancer> m_paperEffect;
+    bool m_paperEffectEnabled;
+    QThreadPool m_paperEffectPool;          // 生成派生图层（单线程：PaperEffectEnhancer 不可重入）
+    QList<PageCacheKey> m_pendingLayers;    // 正在生成的图层（只有可见页，数量很少）
+    int m_paperLayerGeneration;             // 关闭文档时递增，丢弃过期结果
 };
 
 #endif // PDFDOCUMENTSESSION_H
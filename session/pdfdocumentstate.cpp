@@ -33,6 +33,11 @@ void PDFDocumentState::setDocumentLoaded(bool loaded, const QString& path,
     m_isTextPDF = isTextPDF;
 }
 
+void PDFDocumentState::setTextPDF(bool isTextPDF)
+{
+    m_isTextPDF = isTextPDF;
+}
+
 void PDFDocumentState::setCurrentPage(int pageIndex)
 {
     if (m_currentPage != pageIndex) {
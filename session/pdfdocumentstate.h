@@ -115,6 +115,7 @@ public:
 
     void setDocumentLoaded(bool loaded, const QString& path = QString(),
                            int pageCount = 0, bool isTextPDF = false);
+    void setTextPDF(bool isTextPDF);
     void setCurrentPage(int pageIndex);
     void setCurrentZoom(double zoom);
     void setCurrentZoomMode(ZoomMode mode);
@@ -15,7 +15,24 @@ TextSelector::TextSelector(PerThreadMuPDFRenderer* renderer,
     , m_hasAnchor(false)
     , m_startPageIndex(-1)
     , m_startZoom(1.0)
+    , m_highlightFirstChar(-1)
+    , m_highlightLastLine(-1)
 {
+    // 命中测试和高亮先用只有文本的数据（字符位置按行估算），补齐字符边界框后重算
+    if (m_textCache) {
+        connect(m_textCache, &TextCacheManager::pageGeometryReady,
+                this, &TextSelector::onPageGeometryReady);
+    }
+}
+
+void TextSelector::onPageGeometryReady(int pageIndex)
+{
+    if (!m_selection.isValid() || m_selection.pageIndex != pageIndex) {
+        return;
+    }
+
+    buildSelection();
+    emit selectionChanged();
 }
 
 void TextSelector::startSelection(int pageIndex, const QPointF& pagePos, double zoom,
@@ -25,7 +42,7 @@ void TextSelector::startSelection(int pageIndex, const QPointF& pagePos, double
         return;
     }
 
-    PageTextData pageData = m_textCache->getPageTextData(pageIndex);
+    PageTextData pageData = m_textCache->requestPageGeometry(pageIndex);
     if (!pageData.isValid()) {
         return;
     }
@@ -84,7 +101,7 @@ void TextSelector::updateSelection(int pageIndex, const QPointF& pagePos, double
         return;
     }
 
-    PageTextData pageData = m_textCache->getPageTextData(pageIndex);
+    PageTextData pageData = m_textCache->requestPageGeometry(pageIndex);
     if (!pageData.isValid()) {
         return;
     }
@@ -144,7 +161,7 @@ void TextSelector::extendSelection(int pageIndex, const QPointF& pagePos, double
         return;
     }
 
-    PageTextData pageData = m_textCache->getPageTextData(pageIndex);
+    PageTextData pageData = m_textCache->requestPageGeometry(pageIndex);
     if (!pageData.isValid()) {
         return;
     }
@@ -163,7 +180,7 @@ void TextSelector::selectWord(int pageIndex, const QPointF& pagePos, double zoom
         return;
     }
 
-    PageTextData pageData = m_textCache->getPageTextData(pageIndex);
+    PageTextData pageData = m_textCache->requestPageGeometry(pageIndex);
     if (!pageData.isValid()) {
         return;
     }
@@ -189,7 +206,7 @@ void TextSelector::selectLine(int pageIndex, const QPointF& pagePos, double zoom
         return;
     }
 
-    PageTextData pageData = m_textCache->getPageTextData(pageIndex);
+    PageTextData pageData = m_textCache->requestPageGeometry(pageIndex);
     if (!pageData.isValid()) {
         return;
     }
@@ -214,7 +231,7 @@ void TextSelector::selectBlock(int pageIndex, const QPointF& pagePos, double zoo
         return;
     }
 
-    PageTextData pageData = m_textCache->getPageTextData(pageIndex);
+    PageTextData pageData = m_textCache->requestPageGeometry(pageIndex);
     if (!pageData.isValid()) {
         return;
     }
@@ -239,19 +256,18 @@ void TextSelector::selectAll(int pageIndex)
         return;
     }
 
-    PageTextData pageData = m_textCache->getPageTextData(pageIndex);
-    if (!pageData.isValid() || pageData.blocks.isEmpty()) {
+    PageTextData pageData = m_textCache->requestPageGeometry(pageIndex);
+    if (!pageData.isValid() || pageData.isEmpty()) {
         return;
     }
 
     // 找到第一个和最后一个字符
     CharPosition start(0, 0, 0);
 
-    const TextBlock& lastBlock = pageData.blocks.last();
-    const TextLine& lastLine = lastBlock.lines.last();
-    CharPosition end(pageData.blocks.size() - 1,
-                     lastBlock.lines.size() - 1,
-                     lastLine.chars.size() - 1);
+    const int lastBlock = pageData.blockCount() - 1;
+    const int lastLine = pageData.lineCount(lastBlock) - 1;
+    CharPosition end(lastBlock, lastLine,
+                     pageData.charCount(lastBlock, lastLine) - 1);
 
     setSelectionRange(pageIndex, start, end, SelectionMode::Character);
 }
@@ -267,9 +283,21 @@ void TextSelector::endSelection()
 
 void TextSelector::clearSelection()
 {
+    if (m_textCache && m_selection.pageIndex >= 0) {
+        m_textCache->setPinnedPages(TextCacheManager::PinSelection, QSet<int>());
+    }
+
     m_selection.clear();
     m_isSelecting = false;
     m_hasAnchor = false;
+
+    // 释放索引持有的页面数据，不妨碍文本缓存淘汰
+    m_indexedData = PageTextData();
+    m_hitIndex = PageHitIndex();
+    m_highlightLines.clear();
+    m_highlightFirstChar = -1;
+    m_highlightLastLine = -1;
+
     emit selectionChanged();
 }
 
@@ -292,75 +320,87 @@ CharPosition TextSelector::hitTestCharacter(const PageTextData& pageData,
     // 将屏幕坐标转换为页面坐标（去除缩放）
     QPointF pageCoord(pos.x() / zoom, pos.y() / zoom);
 
-    double minDistance = std::numeric_limits<double>::max();
-    CharPosition result;
-
-    for (int b = 0; b < pageData.blocks.size(); ++b) {
-        const TextBlock& block = pageData.blocks[b];
-
-        for (int l = 0; l < block.lines.size(); ++l) {
-            const TextLine& line = block.lines[l];
+    const PageHitIndex& index = hitIndex(pageData);
+    if (index.bandCount() == 0) {
+        return CharPosition();
+    }
 
-            if (line.chars.isEmpty()) continue;
+    double minDistance = std::numeric_limits<double>::max();
+    int bestChar = -1;
+
+    // 条带内的行按页面顺序排列，与逐块逐行遍历的结果一致
+    const int band = index.bandOf(pageCoord.y());
+    for (int i = index.bandLineStarts[band]; i < index.bandLineStarts[band + 1]; ++i) {
+        const int lineOrdinal = index.bandLines[i];
+        const int lineFirst = pageData.lineCharStarts[lineOrdinal];
+        const int charCount = pageData.lineCharCount(lineOrdinal);
+
+        // 检查是否在行的垂直范围内（扩大容差到50%）
+        const QRectF lineRect = pageData.lineRect(lineOrdinal);
+        double lineTop = lineRect.top();
+        double lineBottom = lineRect.bottom();
+        double verticalMargin = lineRect.height() * 0.5;
+
+        // 如果不在行的垂直范围内，跳过
+        if (pageCoord.y() < lineTop - verticalMargin ||
+            pageCoord.y() > lineBottom + verticalMargin) {
+            continue;
+        }
 
-            // 检查是否在行的垂直范围内（扩大容差到50%）
-            double lineTop = line.bbox.top();
-            double lineBottom = line.bbox.bottom();
-            double verticalMargin = line.bbox.height() * 0.5;
+        // 在行的水平范围内查找最近的字符
+        for (int c = 0; c < charCount; ++c) {
+            const QRectF charRect = pageData.charRect(lineFirst + c);
 
-            // 如果不在行的垂直范围内，跳过
-            if (pageCoord.y() < lineTop - verticalMargin ||
-                pageCoord.y() > lineBottom + verticalMargin) {
-                continue;
+            // 如果点在字符bbox内，直接返回
+            if (charRect.contains(pageCoord)) {
+                bestChar = lineFirst + c;
+                minDistance = -1.0;
+                break;
             }
 
-            // 在行的水平范围内查找最近的字符
-            for (int c = 0; c < line.chars.size(); ++c) {
-                const TextChar& ch = line.chars[c];
+            // 计算到字符中心的距离
+            QPointF charCenter = charRect.center();
+            double distance = QLineF(pageCoord, charCenter).length();
 
-                // 如果点在字符bbox内，直接返回
-                if (ch.bbox.contains(pageCoord)) {
-                    return CharPosition(b, l, c);
-                }
+            if (distance < minDistance) {
+                minDistance = distance;
+                bestChar = lineFirst + c;
+            }
+        }
 
-                // 计算到字符中心的距离
-                QPointF charCenter = ch.bbox.center();
-                double distance = QLineF(pageCoord, charCenter).length();
+        if (minDistance < 0.0) {
+            break;
+        }
 
+        // 如果点在行内但超过最后一个字符，选择最后一个字符
+        if (pageCoord.y() >= lineTop && pageCoord.y() <= lineBottom) {
+            const double lastRight = pageData.charRect(lineFirst + charCount - 1).right();
+            const double firstLeft = pageData.charRect(lineFirst).left();
+            if (pageCoord.x() > lastRight) {
+                double distance = pageCoord.x() - lastRight;
                 if (distance < minDistance) {
                     minDistance = distance;
-                    result = CharPosition(b, l, c);
+                    bestChar = lineFirst + charCount - 1;
                 }
             }
-
-            // 如果点在行内但超过最后一个字符，选择最后一个字符
-            if (pageCoord.y() >= lineTop && pageCoord.y() <= lineBottom) {
-                if (pageCoord.x() > line.chars.last().bbox.right()) {
-                    int lastCharIdx = line.chars.size() - 1;
-                    double distance = pageCoord.x() - line.chars.last().bbox.right();
-                    if (distance < minDistance) {
-                        minDistance = distance;
-                        result = CharPosition(b, l, lastCharIdx);
-                    }
-                }
-                // 如果点在第一个字符之前，选择第一个字符
-                else if (pageCoord.x() < line.chars.first().bbox.left()) {
-                    double distance = line.chars.first().bbox.left() - pageCoord.x();
-                    if (distance < minDistance) {
-                        minDistance = distance;
-                        result = CharPosition(b, l, 0);
-                    }
+            // 如果点在第一个字符之前，选择第一个字符
+            else if (pageCoord.x() < firstLeft) {
+                double distance = firstLeft - pageCoord.x();
+                if (distance < minDistance) {
+                    minDistance = distance;
+                    bestChar = lineFirst;
                 }
             }
         }
     }
 
+    CharPosition result;
+    pageData.locateChar(bestChar, &result.blockIndex, &result.lineIndex, &result.charIndex);
     return result;
 }
 
-static inline bool isCJK(QChar ch)
+static inline bool isCJK(char32_t u)
 {
-    uint u = ch.unicode();
     return (u >= 0x4E00 && u <= 0x9FFF) ||    // CJK Unified Ideographs
            (u >= 0x3400 && u <= 0x4DBF) ||    // CJK Extension A
            (u >= 0xF900 && u <= 0xFAFF) ||    // CJK Compatibility Ideographs
@@ -374,8 +414,9 @@ void TextSelector::findWordBoundary(
     CharPosition* start,
     CharPosition* end)
 {
-    const TextLine& line = pageData.blocks[pos.blockIndex].lines[pos.lineIndex];
-    QChar c = line.chars[pos.charIndex].character;
+    const int lineFirst = pageData.charOrdinal(pos.blockIndex, pos.lineIndex, 0);
+    const int charCount = pageData.charCount(pos.blockIndex, pos.lineIndex);
+    char32_t c = pageData.codepoint(lineFirst + pos.charIndex);
 
     // ★★★ 如果是中文/日文/韩文：单字为“词” ★★★
     if (isCJK(c)) {
@@ -387,14 +428,14 @@ void TextSelector::findWordBoundary(
     // 原英文处理逻辑
     int startIdx = pos.charIndex;
     while (startIdx > 0) {
-        QChar prev = line.chars[startIdx - 1].character;
+        char32_t prev = pageData.codepoint(lineFirst + startIdx - 1);
         if (isWordSeparator(prev)) break;
         startIdx--;
     }
 
     int endIdx = pos.charIndex;
-    while (endIdx < line.chars.size() - 1) {
-        QChar next = line.chars[endIdx + 1].character;
+    while (endIdx < charCount - 1) {
+        char32_t next = pageData.codepoint(lineFirst + endIdx + 1);
         if (isWordSeparator(next)) break;
         endIdx++;
     }
@@ -409,22 +450,21 @@ void TextSelector::findLineBoundary(const PageTextData& pageData,
                                     CharPosition* start,
                                     CharPosition* end)
 {
-    if (!pos.isValid() || pos.blockIndex >= pageData.blocks.size()) {
+    if (!pos.isValid() || pos.blockIndex >= pageData.blockCount()) {
         return;
     }
 
-    const TextBlock& block = pageData.blocks[pos.blockIndex];
-    if (pos.lineIndex >= block.lines.size()) {
+    if (pos.lineIndex >= pageData.lineCount(pos.blockIndex)) {
         return;
     }
 
-    const TextLine& line = block.lines[pos.lineIndex];
-    if (line.chars.isEmpty()) {
+    const int charCount = pageData.charCount(pos.blockIndex, pos.lineIndex);
+    if (charCount == 0) {
         return;
     }
 
     *start = CharPosition(pos.blockIndex, pos.lineIndex, 0);
-    *end = CharPosition(pos.blockIndex, pos.lineIndex, line.chars.size() - 1);
+    *end = CharPosition(pos.blockIndex, pos.lineIndex, charCount - 1);
 }
 
 void TextSelector::findBlockBoundary(const PageTextData& pageData,
@@ -432,12 +472,12 @@ void TextSelector::findBlockBoundary(const PageTextData& pageData,
                                      CharPosition* start,
                                      CharPosition* end)
 {
-    if (!pos.isValid() || pos.blockIndex >= pageData.blocks.size()) {
+    if (!pos.isValid() || pos.blockIndex >= pageData.blockCount()) {
         return;
     }
 
-    const TextBlock& block = pageData.blocks[pos.blockIndex];
-    if (block.lines.isEmpty()) {
+    const int lineCount = pageData.lineCount(pos.blockIndex);
+    if (lineCount == 0) {
         return;
     }
 
@@ -445,19 +485,18 @@ void TextSelector::findBlockBoundary(const PageTextData& pageData,
     *start = CharPosition(pos.blockIndex, 0, 0);
 
     // 块的结束：最后一行最后一个字符
-    const TextLine& lastLine = block.lines.last();
-    *end = CharPosition(pos.blockIndex, block.lines.size() - 1,
-                        lastLine.chars.size() - 1);
+    *end = CharPosition(pos.blockIndex, lineCount - 1,
+                        pageData.charCount(pos.blockIndex, lineCount - 1) - 1);
 }
 
-bool TextSelector::isWordSeparator(QChar ch) const
+bool TextSelector::isWordSeparator(char32_t ch) const
 {
     // 空格、标点、换行等都是单词分隔符
-    return ch.isSpace() || ch.isPunct() ||
+    return QChar::isSpace(ch) || QChar::isPunct(ch) ||
            ch == '\n' || ch == '\r' || ch == '\t' ||
-           ch.category() == QChar::Separator_Space ||
-           ch.category() == QChar::Separator_Line ||
-           ch.category() == QChar::Separator_Paragraph;
+           QChar::category(ch) == QChar::Separator_Space ||
+           QChar::category(ch) == QChar::Separator_Line ||
+           QChar::category(ch) == QChar::Separator_Paragraph;
 }
 
 void TextSelector::setSelectionRange(int pageIndex,
@@ -465,6 +504,11 @@ void TextSelector::setSelectionRange(int pageIndex,
                                      const CharPosition& end,
                                      SelectionMode mode)
 {
+    // 选择所在页的文本固定在缓存中，拖拽时不会被淘汰
+    if (m_textCache && pageIndex != m_selection.pageIndex) {
+        m_textCache->setPinnedPages(TextCacheManager::PinSelection, QSet<int>{pageIndex});
+    }
+
     m_selection.pageIndex = pageIndex;
     m_selection.mode = mode;
 
@@ -495,13 +539,13 @@ void TextSelector::buildSelection()
         return;
     }
 
-    PageTextData pageData = m_textCache->getPageTextData(m_selection.pageIndex);
+    PageTextData pageData = m_textCache->requestPageGeometry(m_selection.pageIndex);
     if (!pageData.isValid()) {
         return;
     }
 
     m_selection.selectedText = extractSelectedText(pageData);
-    m_selection.highlightRects = calculateHighlightRects(pageData);
+    updateHighlightRects(pageData);
 }
 
 QString TextSelector::extractSelectedText(const PageTextData& pageData)
@@ -515,20 +559,23 @@ QString TextSelector::extractSelectedText(const PageTextData& pageData)
     int endLine = m_selection.endLineIndex;
     int endChar = m_selection.endCharIndex;
 
-    for (int b = startBlock; b <= endBlock && b < pageData.blocks.size(); ++b) {
-        const TextBlock& block = pageData.blocks[b];
+    for (int b = startBlock; b <= endBlock && b < pageData.blockCount(); ++b) {
+        const int lineCount = pageData.lineCount(b);
 
         int firstLine = (b == startBlock) ? startLine : 0;
-        int lastLine = (b == endBlock) ? endLine : block.lines.size() - 1;
+        int lastLine = (b == endBlock) ? endLine : lineCount - 1;
 
-        for (int l = firstLine; l <= lastLine && l < block.lines.size(); ++l) {
-            const TextLine& line = block.lines[l];
+        for (int l = firstLine; l <= lastLine && l < lineCount; ++l) {
+            const int lineFirst = pageData.charOrdinal(b, l, 0);
+            const int charCount = pageData.charCount(b, l);
 
             int firstChar = (b == startBlock && l == startLine) ? startChar : 0;
-            int lastChar = (b == endBlock && l == endLine) ? endChar : line.chars.size() - 1;
+            int lastChar = (b == endBlock && l == endLine) ? endChar : charCount - 1;
+            lastChar = qMin(lastChar, charCount - 1);
 
-            for (int c = firstChar; c <= lastChar && c < line.chars.size(); ++c) {
-                text.append(line.chars[c].character);
+            if (firstChar <= lastChar) {
+                text.append(QString::fromUcs4(pageData.codepoints.constData() + lineFirst + firstChar,
+                                              lastChar - firstChar + 1));
             }
 
             // 行尾添加换行符（除了最后一个字符）
@@ -546,44 +593,78 @@ QString TextSelector::extractSelectedText(const PageTextData& pageData)
     return text;
 }
 
-QVector<QRectF> TextSelector::calculateHighlightRects(const PageTextData& pageData)
+void TextSelector::updateHighlightRects(const PageTextData& pageData)
 {
-    QVector<QRectF> rects;
-
-    int startBlock = m_selection.startBlockIndex;
-    int startLine = m_selection.startLineIndex;
-    int startChar = m_selection.startCharIndex;
-    int endBlock = m_selection.endBlockIndex;
-    int endLine = m_selection.endLineIndex;
-    int endChar = m_selection.endCharIndex;
-
-    for (int b = startBlock; b <= endBlock && b < pageData.blocks.size(); ++b) {
-        const TextBlock& block = pageData.blocks[b];
+    const PageHitIndex& index = hitIndex(pageData);
 
-        int firstLine = (b == startBlock) ? startLine : 0;
-        int lastLine = (b == endBlock) ? endLine : block.lines.size() - 1;
+    QVector<QRectF>& rects = m_selection.highlightRects;
 
-        for (int l = firstLine; l <= lastLine && l < block.lines.size(); ++l) {
-            const TextLine& line = block.lines[l];
+    if (m_selection.endBlockIndex >= pageData.blockCount()
+        || m_selection.endLineIndex >= pageData.lineCount(m_selection.endBlockIndex)) {
+        rects.clear();
+        m_highlightLines.clear();
+        m_highlightFirstChar = -1;
+        return;
+    }
 
-            if (line.chars.isEmpty()) continue;
+    const int firstChar = pageData.charOrdinal(m_selection.startBlockIndex,
+                                               m_selection.startLineIndex,
+                                               m_selection.startCharIndex);
+    const int lastChar = pageData.charOrdinal(m_selection.endBlockIndex,
+                                              m_selection.endLineIndex,
+                                              m_selection.endCharIndex);
+    const int firstLine = pageData.lineOrdinal(m_selection.startBlockIndex,
+                                               m_selection.startLineIndex);
+    const int lastLine = pageData.lineOrdinal(m_selection.endBlockIndex,
+                                              m_selection.endLineIndex);
+
+    // 起点不变时，新旧终点之前的行高亮完全相同，直接保留
+    int keep = 0;
+    if (firstChar == m_highlightFirstChar && m_highlightLines.size() == rects.size()) {
+        const int stableEnd = qMin(m_highlightLastLine, lastLine);
+        while (keep < m_highlightLines.size() && m_highlightLines[keep] < stableEnd) {
+            ++keep;
+        }
+    }
+    rects.resize(keep);
+    m_highlightLines.resize(keep);
 
-            int firstChar = (b == startBlock && l == startLine) ? startChar : 0;
-            int lastChar = (b == endBlock && l == endLine) ? endChar : line.chars.size() - 1;
+    const int fromLine = (keep > 0) ? m_highlightLines.last() + 1 : firstLine;
+    for (int line = fromLine; line <= lastLine; ++line) {
+        const int charCount = pageData.lineCharCount(line);
+        if (charCount == 0) continue;
 
-            if (firstChar >= line.chars.size() || lastChar >= line.chars.size()) {
-                continue;
-            }
+        const int lineFirst = pageData.lineCharStarts[line];
+        const int lineLast = lineFirst + charCount - 1;
+        const int from = qMax(firstChar, lineFirst);
+        const int to = qMin(lastChar, lineLast);
+        if (from > to) continue;
 
-            // 合并同一行的字符bbox
-            QRectF lineRect = line.chars[firstChar].bbox;
-            for (int c = firstChar + 1; c <= lastChar && c < line.chars.size(); ++c) {
-                lineRect = lineRect.united(line.chars[c].bbox);
-            }
-
-            rects.append(lineRect);
+        // 整行选中时使用索引中缓存的行矩形，否则合并选中部分的字符bbox
+        if (from == lineFirst && to == lineLast) {
+            rects.append(index.lineFullRects[line]);
+        } else {
+            rects.append(pageData.charRangeRect(from, to - from + 1));
         }
+        m_highlightLines.append(line);
     }
 
-    return rects;
+    m_highlightFirstChar = firstChar;
+    m_highlightLastLine = lastLine;
+}
+
+const PageHitIndex& TextSelector::hitIndex(const PageTextData& pageData)
+{
+    // 换页、被淘汰后重新载入或补齐字符几何信息时，页面数据不再是同一份
+    if (m_hitIndex.pageIndex != pageData.pageIndex
+        || m_indexedData.codepoints.constData() != pageData.codepoints.constData()
+        || m_indexedData.charBoxes.constData() != pageData.charBoxes.constData()) {
+        m_indexedData = pageData;
+        m_hitIndex.build(pageData);
+
+        m_highlightLines.clear();
+        m_highlightFirstChar = -1;
+        m_highlightLastLine = -1;
+    }
+    return m_hitIndex;
 }
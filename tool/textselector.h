@@ -194,9 +194,16 @@ signals:
      */
     void scrollRequested(int direction);
 
+private slots:
+    /**
+     * @brief 页面补齐字符边界框后重算当前选择的文本和高亮
+     */
+    void onPageGeometryReady(int pageIndex);
+
 private:
     /**
      * @brief 命中测试：找到位置对应的字符
+     * 只检查命中测试索引中鼠标所在条带的行
      */
     CharPosition hitTestCharacter(const PageTextData& pageData,
                                   const QPointF& pos,
@@ -233,7 +240,7 @@ private:
     /**
      * @brief 判断字符是否为单词分隔符
      */
-    bool isWordSeparator(QChar ch) const;
+    bool isWordSeparator(char32_t ch) const;
 
     /**
      * @brief 设置选择范围（从两个位置）
@@ -255,9 +262,15 @@ private:
     QString extractSelectedText(const PageTextData& pageData);
 
     /**
-     * @brief 计算选择范围的高亮矩形
+     * @brief 更新选择范围的高亮矩形
+     * 起点不变时（拖拽只移动终点）保留终点之前没有变化的行，只重算其后的行
+     */
+    void updateHighlightRects(const PageTextData& pageData);
+
+    /**
+     * @brief 获取页面的命中测试索引（页面数据被替换时重建）
      */
-    QVector<QRectF> calculateHighlightRects(const PageTextData& pageData);
+    const PageHitIndex& hitIndex(const PageTextData& pageData);
 
     /**
      * @brief 获取字符在页面中的全局索引
@@ -288,6 +301,15 @@ private:
     // Word/Line模式的初始位置
     CharPosition m_wordStart;
     CharPosition m_wordEnd;
+
+    // 命中测试索引（只保留选择所在页）
+    PageTextData m_indexedData;             ///< 建立索引时的页面数据（用于判断数据是否被替换）
+    PageHitIndex m_hitIndex;
+
+    // 增量高亮
+    QVector<int> m_highlightLines;          ///< 每个高亮矩形对应的页面行序号
+    int m_highlightFirstChar;               ///< 高亮矩形对应的起始字符序号
+    int m_highlightLastLine;                ///< 高亮矩形对应的结束行序号
 };
 
 #endif // TEXTSELECTOR_H
@@ -0,0 +1,55 @@
+#ifndef LEGACYPAPEREFFECT_H
+#define LEGACYPAPEREFFECT_H
+
+#include "papereffectenhancer.h"
+
+/**
+ * @brief 纸张效果的原始实现（BGR Mat + 整页浮点矩阵）
+ *
+ * 从定点实现之前的 PaperEffectEnhancer 原样保留，只用于 paperbench
+ * 对照速度和输出，不参与主程序构建。
+ */
+class LegacyPaperEffect
+{
+public:
+    explicit LegacyPaperEffect(const AdvancedOptions& opt = AdvancedOptions());
+    ~LegacyPaperEffect();
+
+    // 主要处理函数
+    QImage enhance(const QImage& input);
+
+    // 设置和获取参数
+    void setOptions(const AdvancedOptions& opt);
+    AdvancedOptions options() const { return m_options; }
+
+private:
+    // 格式转换
+    cv::Mat qImageToCvMat(const QImage& image);
+    QImage cvMatToQImage(const cv::Mat& mat);
+
+    // 核心处理函数
+    cv::Mat createTextMask(const cv::Mat& img);
+    void applyPaperBackground(cv::Mat& img, const cv::Mat& textMask);
+    void featherMask(cv::Mat& mask, int radius);
+
+    // 1. 自适应阈值计算
+    int calculateAdaptiveThreshold(const cv::Mat& gray);
+
+    // 2. 生成纸张纹理
+    cv::Mat generatePaperTexture(const cv::Size& size);
+    void applyPaperTexture(cv::Mat& img, const cv::Mat& mask);
+
+    // 3. 检测文字边缘
+    cv::Mat detectTextEdges(const cv::Mat& gray);
+
+    // 4. 创建渐进式强度遮罩
+    cv::Mat createProgressiveIntensityMask(const cv::Size& size);
+
+    AdvancedOptions m_options;
+
+    // 纹理缓存（避免重复生成）
+    cv::Mat m_cachedTexture;
+    cv::Size m_cachedTextureSize;
+};
+
+#endif // LEGACYPAPEREFFECT_H
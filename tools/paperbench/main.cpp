@@ -0,0 +1,164 @@
+#include "papereffectenhancer.h"
+#include "paperblend.h"
+#include "legacypapereffect.h"
+#include <QElapsedTimer>
+#include <QImage>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+/**
+ * paperbench：纸张效果的速度与输出对照
+ *
+ * 用法：paperbench [图片路径] [迭代次数]
+ * 不给图片时生成一张 300 DPI 的 A4 文字页（2480 × 3508）。
+ * 1. 校验 PaperBlend::blendRow（SSE2）与标量实现逐字节一致，不一致时返回 1
+ * 2. 分别计时原始浮点实现和当前定点实现，比较两者输出的差异
+ */
+
+namespace {
+
+QImage syntheticPage()
+{
+    QImage page(2480, 3508, QImage::Format_RGB888);
+    page.fill(QColor(250, 250, 248));
+
+    cv::Mat view(page.height(), page.width(), CV_8UC3, page.bits(),
+                 static_cast<size_t>(page.bytesPerLine()));
+    const std::string line = "The quick brown fox jumps over the lazy dog 0123456789";
+    for (int y = 300; y < page.height() - 300; y += 64) {
+        cv::putText(view, line + " " + line, cv::Point(240, y), cv::FONT_HERSHEY_SIMPLEX,
+                    1.1, cv::Scalar(20, 20, 20), 2, cv::LINE_AA);
+    }
+    return page;
+}
+
+int checkBlendKernel()
+{
+    std::mt19937 gen(12345);
+    std::uniform_int_distribution<int> byte(0, 255);
+
+    int mismatches = 0;
+    std::vector<int> lengths;
+    for (int n = 0; n <= 64; ++n) {
+        lengths.push_back(n);
+    }
+    lengths.push_back(2480 * 3);
+
+    for (int count : lengths) {
+        std::vector<uchar> pixels(count), paper(count), weight(count), add(count);
+        for (int i = 0; i < count; ++i) {
+            pixels[i] = uchar(byte(gen));
+            paper[i] = uchar(byte(gen));
+            weight[i] = uchar(byte(gen));
+            add[i] = uchar(byte(gen) & 0x1f);
+        }
+
+        std::vector<uchar> expected = pixels;
+        PaperBlend::blendRowScalar(expected.data(), paper.data(), weight.data(), add.data(), count);
+        PaperBlend::blendRow(pixels.data(), paper.data(), weight.data(), add.data(), count);
+
+        for (int i = 0; i < count; ++i) {
+            if (pixels[i] != expected[i]) {
+                ++mismatches;
+            }
+        }
+    }
+
+#if defined(PAPER_BLEND_SSE2)
+    const char* path = "SSE2";
+#else
+    const char* path = "scalar";
+#endif
+    std::printf("blendRow (%s) vs scalar: %d mismatched bytes\n", path, mismatches);
+    return mismatches;
+}
+
+template <typename Enhancer>
+double timeEnhance(Enhancer& enhancer, const QImage& input, int iterations, QImage* output)
+{
+    *output = enhancer.enhance(input);     // 预热（生成纹理缓存）
+
+    QElapsedTimer timer;
+    double best = 0;
+    for (int i = 0; i < iterations; ++i) {
+        timer.start();
+        *output = enhancer.enhance(input);
+        const double ms = timer.nsecsElapsed() / 1e6;
+        best = (i == 0) ? ms : std::min(best, ms);
+    }
+    return best;
+}
+
+void compareOutputs(const QImage& a, const QImage& b)
+{
+    if (a.size() != b.size() || a.format() != b.format()) {
+        std::printf("  outputs differ in size or format\n");
+        return;
+    }
+
+    const int rowBytes = a.width() * (a.format() == QImage::Format_Grayscale8 ? 1 : 3);
+    int maxDiff = 0;
+    qint64 sumDiff = 0;
+    qint64 over2 = 0;
+    for (int y = 0; y < a.height(); ++y) {
+        const uchar* pa = a.constScanLine(y);
+        const uchar* pb = b.constScanLine(y);
+        for (int i = 0; i < rowBytes; ++i) {
+            const int diff = std::abs(pa[i] - pb[i]);
+            maxDiff = std::max(maxDiff, diff);
+            sumDiff += diff;
+            over2 += diff > 2;
+        }
+    }
+
+    const double total = double(rowBytes) * a.height();
+    std::printf("  max diff %d, mean diff %.3f, bytes off by >2: %.3f%%\n",
+                maxDiff, sumDiff / total, 100.0 * over2 / total);
+}
+
+void runCase(const char* name, const QImage& input, const AdvancedOptions& options, int iterations)
+{
+    LegacyPaperEffect legacy(options);
+    PaperEffectEnhancer current(options);
+
+    QImage legacyOut;
+    QImage currentOut;
+    const double legacyMs = timeEnhance(legacy, input, iterations, &legacyOut);
+    const double currentMs = timeEnhance(current, input, iterations, &currentOut);
+
+    std::printf("%s (%dx%d): legacy %.1f ms, current %.1f ms, %.2fx\n",
+                name, input.width(), input.height(), legacyMs, currentMs, legacyMs / currentMs);
+    compareOutputs(legacyOut, currentOut);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const int mismatches = checkBlendKernel();
+
+    QImage page = (argc > 1) ? QImage(QString::fromLocal8Bit(argv[1])) : syntheticPage();
+    if (page.isNull()) {
+        std::fprintf(stderr, "cannot load %s\n", argv[1]);
+        return 2;
+    }
+    page = page.convertToFormat(QImage::Format_RGB888);
+    const int iterations = (argc > 2) ? std::max(1, std::atoi(argv[2])) : 5;
+
+    // 纹理是随机噪点，两种实现不可能逐像素一致；关闭纹理时只剩量化误差
+    AdvancedOptions withTexture;
+    AdvancedOptions withoutTexture;
+    withoutTexture.enablePaperTexture = false;
+
+    runCase("RGB888, texture", page, withTexture, iterations);
+    runCase("RGB888, no texture", page, withoutTexture, iterations);
+
+    const QImage gray = page.convertToFormat(QImage::Format_Grayscale8);
+    runCase("Gray8, texture", gray, withTexture, iterations);
+    runCase("Gray8, no texture", gray, withoutTexture, iterations);
+
+    return mismatches == 0 ? 0 : 1;
+}
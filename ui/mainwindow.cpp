@@ -1,5 +1,6 @@
 #include "mainwindow.h"
 #include "pdfdocumenttab.h"
+#include "multidocsearchpanel.h"
 #include "dictionaryconnector.h"
 #include "ocrstatusindicator.h"
 #include "ocrmanager.h"
@@ -27,6 +28,8 @@ MainWindow::MainWindow(QWidget* parent)
     : QMainWindow(parent)
     , m_tabWidget(nullptr)
     , m_navigationDock(nullptr)
+    , m_multiDocSearchDock(nullptr)
+    , m_multiDocSearchPanel(nullptr)
     , m_toolBar(nullptr)
     , m_pageSpinBox(nullptr)
     , m_zoomComboBox(nullptr)
@@ -54,6 +57,14 @@ MainWindow::MainWindow(QWidget* parent)
     addDockWidget(Qt::LeftDockWidgetArea, m_navigationDock);
     m_navigationDock->setVisible(false);
 
+    // 多文档搜索面板
+    m_multiDocSearchDock = new QDockWidget(tr("多文档搜索"), this);
+    m_multiDocSearchDock->setAllowedAreas(Qt::BottomDockWidgetArea | Qt::RightDockWidgetArea);
+    m_multiDocSearchPanel = new MultiDocSearchPanel(m_multiDocSearchDock);
+    m_multiDocSearchDock->setWidget(m_multiDocSearchPanel);
+    addDockWidget(Qt::BottomDockWidgetArea, m_multiDocSearchDock);
+    m_multiDocSearchDock->setVisible(false);
+
     // 创建UI组件
     createActions();
     createMenuBar();
@@ -152,6 +163,7 @@ void MainWindow::closeTab(int index)
     m_tabWidget->removeTab(index);
     tab->deleteLater();
 
+    updateMultiDocSearchScope();
     updateUIState();
 }
 
@@ -187,6 +199,9 @@ void MainWindow::connectTabSignals(PDFDocumentTab* tab)
     connect(tab, &PDFDocumentTab::documentLoaded,
             this, &MainWindow::onCurrentTabDocumentLoaded);
 
+    connect(tab, &PDFDocumentTab::documentTypeChanged,
+            this, &MainWindow::onCurrentTabDocumentTypeChanged);
+
     // 视图状态变化
     connect(tab, &PDFDocumentTab::pageChanged,
             this, &MainWindow::onCurrentTabPageChanged);
@@ -442,6 +457,67 @@ void MainWindow::showSearchBar()
     }
 }
 
+void MainWindow::showMultiDocSearch()
+{
+    updateMultiDocSearchScope();
+    m_multiDocSearchDock->setVisible(true);
+    m_multiDocSearchPanel->showAndFocus();
+}
+
+void MainWindow::onMultiDocSearchResultActivated(const QString& filePath, int pageIndex)
+{
+    // 已打开则切换到对应标签页
+    QString canonicalPath = QFileInfo(filePath).canonicalFilePath();
+    for (int i = 0; i < m_tabWidget->count(); ++i) {
+        PDFDocumentTab* tab = qobject_cast<PDFDocumentTab*>(m_tabWidget->widget(i));
+        if (tab && tab->isDocumentLoaded() &&
+            QFileInfo(tab->documentPath()).canonicalFilePath() == canonicalPath) {
+            m_tabWidget->setCurrentIndex(i);
+            tab->goToPage(pageIndex);
+            return;
+        }
+    }
+
+    // 否则在新标签页中打开
+    PDFDocumentTab* tab = currentTab();
+    if (!tab || tab->isDocumentLoaded()) {
+        tab = createNewTab();
+    }
+
+    QString errorMsg;
+    if (!tab->loadDocument(filePath, &errorMsg)) {
+        QMessageBox::critical(this, tr("错误"),
+                              tr("打开失败:\n%1\n\n错误: %2")
+                                  .arg(filePath).arg(errorMsg));
+        if (m_tabWidget->count() > 1) {
+            closeTab(m_tabWidget->indexOf(tab));
+        }
+        return;
+    }
+
+    tab->goToPage(pageIndex);
+}
+
+QStringList MainWindow::openDocumentPaths() const
+{
+    QStringList paths;
+    for (int i = 0; i < m_tabWidget->count(); ++i) {
+        PDFDocumentTab* tab = qobject_cast<PDFDocumentTab*>(m_tabWidget->widget(i));
+        if (tab && tab->isDocumentLoaded()) {
+            paths.append(tab->documentPath());
+        }
+    }
+    paths.removeDuplicates();
+    return paths;
+}
+
+void MainWindow::updateMultiDocSearchScope()
+{
+    if (m_multiDocSearchPanel) {
+        m_multiDocSearchPanel->setOpenDocumentPaths(openDocumentPaths());
+    }
+}
+
 void MainWindow::findNext()
 {
     if (PDFDocumentTab* tab = currentTab()) {
@@ -569,6 +645,8 @@ void MainWindow::onCurrentTabDocumentLoaded(const QString& filePath, int pageCou
         updateTabTitle(index);
     }
 
+    updateMultiDocSearchScope();
+
     // 如果是当前标签页,更新UI
     if (tab == currentTab()) {
         updateWindowTitle();
@@ -598,6 +676,23 @@ void MainWindow::onCurrentTabDocumentLoaded(const QString& filePath, int pageCou
     updateUIState();
 }
 
+void MainWindow::onCurrentTabDocumentTypeChanged(bool isTextPDF)
+{
+    PDFDocumentTab* tab = qobject_cast<PDFDocumentTab*>(QObject::sender());
+    if (!tab || tab != currentTab()) {
+        return;
+    }
+
+    m_paperEffectAction->setEnabled(!isTextPDF);
+
+    // 检测为文本 PDF 时关闭增强功能
+    if (isTextPDF) {
+        m_paperEffectAction->setChecked(false);
+    }
+
+    updateUIState();
+}
+
 void MainWindow::onCurrentTabSearchCompleted(const QString& query, int totalMatches)
 {
     Q_UNUSED(query);
@@ -650,6 +745,11 @@ void MainWindow::createActions()
     m_findPreviousAction->setEnabled(false);
     connect(m_findPreviousAction, &QAction::triggered, this, &MainWindow::findPrevious);
 
+    m_multiDocSearchAction = new QAction(tr("在多个文档中查找..."), this);
+    m_multiDocSearchAction->setShortcut(QKeySequence(tr("Ctrl+Shift+F")));
+    m_multiDocSearchAction->setToolTip(tr("在已打开的文档或文件夹中搜索 (Ctrl+Shift+F)"));
+    connect(m_multiDocSearchAction, &QAction::triggered, this, &MainWindow::showMultiDocSearch);
+
 
     m_firstPageAction = new QAction(QIcon(":icons/resources/icons/first-arrow.png"),
                                     tr("首页"), this);
@@ -782,6 +882,8 @@ void MainWindow::createMenuBar()
     editMenu->addAction(m_findAction);
     editMenu->addAction(m_findNextAction);
     editMenu->addAction(m_findPreviousAction);
+    editMenu->addSeparator();
+    editMenu->addAction(m_multiDocSearchAction);
 
     // 视图菜单
     QMenu* viewMenu = menuBar()->addMenu(tr("&视图"));
@@ -927,6 +1029,10 @@ void MainWindow::setupConnections()
     connect(m_tabWidget, &QTabWidget::tabCloseRequested,
             this, &MainWindow::onTabCloseRequested);
 
+    // 多文档搜索结果跳转
+    connect(m_multiDocSearchPanel, &MultiDocSearchPanel::resultActivated,
+            this, &MainWindow::onMultiDocSearchResultActivated);
+
     // 防抖定时器
     connect(&m_resizeDebounceTimer, &QTimer::timeout, this, [this]() {
         PDFDocumentTab* tab = currentTab();
@@ -1062,7 +1168,7 @@ void MainWindow::updateUIState()
             } else if (tab->isTextPDF()) {
                 tooltip = tr("启用OCR取词 (Ctrl+Shift+O)\n"
                              "按 Ctrl+Q 触发识别\n"
-                             "💡 当前是文本PDF，不需要OCR");
+                             "💡 当前是文本PDF，只识别没有文本层的页面");
             } else {
                 tooltip = tr("启用OCR取词 (Ctrl+Shift+O)\n"
                              "按 Ctrl+Q 触发识别\n"
@@ -1443,7 +1549,7 @@ void MainWindow::onOCRHoverEnabledChanged(bool enabled)
     // 通知所有Tab更新
     for (int i = 0; i < m_tabWidget->count(); ++i) {
         PDFDocumentTab* tab = qobject_cast<PDFDocumentTab*>(m_tabWidget->widget(i));
-        if (tab && tab->isDocumentLoaded() && !tab->isTextPDF()) {
+        if (tab && tab->isDocumentLoaded()) {
             tab->updateOCRHoverState();
         }
     }
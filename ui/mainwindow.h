@@ -16,6 +16,7 @@ class QLabel;
 class QActionGroup;
 class PDFDocumentTab;
 class OCRStatusIndicator;
+class MultiDocSearchPanel;
 
 class MainWindow : public QMainWindow
 {
@@ -64,6 +65,8 @@ private slots:
     void showSearchBar();
     void findNext();
     void findPrevious();
+    void showMultiDocSearch();
+    void onMultiDocSearchResultActivated(const QString& filePath, int pageIndex);
 
     // 文本操作
     void copySelectedText();
@@ -75,6 +78,7 @@ private slots:
     void onCurrentTabContinuousScrollChanged(bool continuous);
     void onCurrentTabTextSelectionChanged();
     void onCurrentTabDocumentLoaded(const QString& filePath, int pageCount);
+    void onCurrentTabDocumentTypeChanged(bool isTextPDF);
     void onCurrentTabSearchCompleted(const QString& query, int totalMatches);
 
     void togglePaperEffect();
@@ -104,6 +108,8 @@ private:
     void disconnectTabSignals(PDFDocumentTab* tab);
     void closeTab(int index);
     void updateTabTitle(int index);
+    QStringList openDocumentPaths() const;
+    void updateMultiDocSearchScope();
 
     // 样式
     void applyModernStyle();
@@ -117,6 +123,8 @@ private:
     // UI组件
     QTabWidget* m_tabWidget;
     QDockWidget* m_navigationDock;
+    QDockWidget* m_multiDocSearchDock;
+    MultiDocSearchPanel* m_multiDocSearchPanel;
     QToolBar* m_toolBar;
     QSpinBox* m_pageSpinBox;
     QComboBox* m_zoomComboBox;
@@ -135,6 +143,7 @@ private:
     QAction* m_findAction;
     QAction* m_findNextAction;
     QAction* m_findPreviousAction;
+    QAction* m_multiDocSearchAction;
 
     QAction* m_zoomInAction;
     QAction* m_zoomOutAction;
@@ -0,0 +1,324 @@
+#include "multidocsearchpanel.h"
+#include "multidocsearchmanager.h"
+#include "appconfig.h"
+
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+#include <QLineEdit>
+#include <QComboBox>
+#include <QPushButton>
+#include <QCheckBox>
+#include <QLabel>
+#include <QTreeWidget>
+#include <QHeaderView>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QDebug>
+
+MultiDocSearchPanel::MultiDocSearchPanel(QWidget* parent)
+    : QWidget(parent)
+    , m_searchManager(new MultiDocSearchManager(this))
+    , m_queryEdit(nullptr)
+    , m_scopeCombo(nullptr)
+    , m_folderButton(nullptr)
+    , m_caseSensitiveCheck(nullptr)
+    , m_wholeWordsCheck(nullptr)
+    , m_foldInsensitiveCheck(nullptr)
+    , m_searchButton(nullptr)
+    , m_statusLabel(nullptr)
+    , m_resultTree(nullptr)
+{
+    setupUI();
+    setupConnections();
+    updateUI();
+}
+
+MultiDocSearchPanel::~MultiDocSearchPanel()
+{
+}
+
+void MultiDocSearchPanel::setOpenDocumentPaths(const QStringList& filePaths)
+{
+    m_openDocumentPaths = filePaths;
+    updateUI();
+}
+
+void MultiDocSearchPanel::showAndFocus()
+{
+    show();
+    m_queryEdit->setFocus();
+    m_queryEdit->selectAll();
+}
+
+void MultiDocSearchPanel::setupUI()
+{
+    QVBoxLayout* mainLayout = new QVBoxLayout(this);
+    mainLayout->setContentsMargins(5, 5, 5, 5);
+    mainLayout->setSpacing(5);
+
+    // 搜索条件
+    QHBoxLayout* queryLayout = new QHBoxLayout();
+    queryLayout->setSpacing(5);
+
+    m_queryEdit = new QLineEdit(this);
+    m_queryEdit->setPlaceholderText(tr("在多个文档中查找..."));
+    m_queryEdit->setClearButtonEnabled(true);
+    queryLayout->addWidget(m_queryEdit, 1);
+
+    m_scopeCombo = new QComboBox(this);
+    m_scopeCombo->addItem(tr("已打开的文档"), OpenDocuments);
+    m_scopeCombo->addItem(tr("文件夹"), Folder);
+    queryLayout->addWidget(m_scopeCombo);
+
+    m_folderButton = new QPushButton(tr("选择文件夹..."), this);
+    m_folderButton->setVisible(false);
+    queryLayout->addWidget(m_folderButton);
+
+    m_caseSensitiveCheck = new QCheckBox(tr("大小写敏感"), this);
+    queryLayout->addWidget(m_caseSensitiveCheck);
+
+    m_wholeWordsCheck = new QCheckBox(tr("整个单词"), this);
+    queryLayout->addWidget(m_wholeWordsCheck);
+
+    m_foldInsensitiveCheck = new QCheckBox(tr("忽略变音/全半角"), this);
+    queryLayout->addWidget(m_foldInsensitiveCheck);
+
+    m_searchButton = new QPushButton(tr("搜索"), this);
+    queryLayout->addWidget(m_searchButton);
+
+    mainLayout->addLayout(queryLayout);
+
+    // 状态
+    m_statusLabel = new QLabel(this);
+    m_statusLabel->setObjectName("multiDocSearchStatus");
+    mainLayout->addWidget(m_statusLabel);
+
+    // 结果（按文档分组）
+    m_resultTree = new QTreeWidget(this);
+    m_resultTree->setColumnCount(2);
+    m_resultTree->setHeaderLabels({tr("位置"), tr("上下文")});
+    m_resultTree->header()->setSectionResizeMode(0, QHeaderView::ResizeToContents);
+    m_resultTree->header()->setStretchLastSection(true);
+    m_resultTree->setUniformRowHeights(true);
+    m_resultTree->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_resultTree->setFrameShape(QFrame::NoFrame);
+    mainLayout->addWidget(m_resultTree, 1);
+}
+
+void MultiDocSearchPanel::setupConnections()
+{
+    connect(m_queryEdit, &QLineEdit::returnPressed,
+            this, &MultiDocSearchPanel::performSearch);
+
+    connect(m_searchButton, &QPushButton::clicked, this, [this]() {
+        if (m_searchManager->isSearching()) {
+            m_searchManager->cancelSearch();
+        } else {
+            performSearch();
+        }
+    });
+
+    connect(m_folderButton, &QPushButton::clicked,
+            this, &MultiDocSearchPanel::chooseFolder);
+
+    connect(m_scopeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MultiDocSearchPanel::onScopeChanged);
+
+    connect(m_resultTree, &QTreeWidget::itemActivated,
+            this, &MultiDocSearchPanel::onItemActivated);
+
+    // 搜索管理器信号
+    connect(m_searchManager, &MultiDocSearchManager::searchStarted,
+            this, &MultiDocSearchPanel::onSearchStarted);
+    connect(m_searchManager, &MultiDocSearchManager::documentResultsReady,
+            this, &MultiDocSearchPanel::onDocumentResultsReady);
+    connect(m_searchManager, &MultiDocSearchManager::documentFinished,
+            this, &MultiDocSearchPanel::onDocumentFinished);
+    connect(m_searchManager, &MultiDocSearchManager::searchProgress,
+            this, &MultiDocSearchPanel::onSearchProgress);
+    connect(m_searchManager, &MultiDocSearchManager::searchCompleted,
+            this, &MultiDocSearchPanel::onSearchCompleted);
+    connect(m_searchManager, &MultiDocSearchManager::searchCancelled,
+            this, &MultiDocSearchPanel::onSearchCancelled);
+}
+
+void MultiDocSearchPanel::performSearch()
+{
+    QString query = m_queryEdit->text().trimmed();
+    if (query.isEmpty()) {
+        return;
+    }
+
+    QStringList filePaths;
+    if (m_scopeCombo->currentData().toInt() == Folder) {
+        if (m_folderPath.isEmpty()) {
+            chooseFolder();
+            if (m_folderPath.isEmpty()) {
+                return;
+            }
+        }
+        filePaths = MultiDocSearchManager::collectPdfFiles(m_folderPath);
+    } else {
+        filePaths = m_openDocumentPaths;
+    }
+
+    m_resultTree->clear();
+    m_documentItems.clear();
+
+    if (filePaths.isEmpty()) {
+        m_statusLabel->setText(tr("没有可搜索的文档"));
+        return;
+    }
+
+    SearchOptions options;
+    options.caseSensitive = m_caseSensitiveCheck->isChecked();
+    options.wholeWords = m_wholeWordsCheck->isChecked();
+    options.foldInsensitive = m_foldInsensitiveCheck->isChecked();
+    options.maxResults = AppConfig::instance().multiDocSearchMaxResultsPerDoc();
+
+    m_searchManager->startSearch(filePaths, query, options);
+    updateUI();
+}
+
+void MultiDocSearchPanel::chooseFolder()
+{
+    QString dir = QFileDialog::getExistingDirectory(this, tr("选择要搜索的文件夹"), m_folderPath);
+    if (dir.isEmpty()) {
+        return;
+    }
+
+    m_folderPath = dir;
+    updateUI();
+}
+
+void MultiDocSearchPanel::onScopeChanged(int index)
+{
+    Q_UNUSED(index);
+    updateUI();
+}
+
+void MultiDocSearchPanel::onSearchStarted(int totalDocuments)
+{
+    m_statusLabel->setText(tr("正在搜索 %1 个文档...").arg(totalDocuments));
+    updateUI();
+}
+
+void MultiDocSearchPanel::onDocumentResultsReady(const QString& filePath,
+                                                 const QVector<SearchResult>& results)
+{
+    QTreeWidgetItem* docItem = documentItem(filePath);
+
+    for (const SearchResult& result : results) {
+        QTreeWidgetItem* item = new QTreeWidgetItem(docItem);
+        item->setText(0, tr("第 %1 页").arg(result.pageIndex + 1));
+        item->setText(1, result.context);
+        item->setData(0, FilePathRole, filePath);
+        item->setData(0, PageIndexRole, result.pageIndex);
+    }
+}
+
+void MultiDocSearchPanel::onDocumentFinished(const QString& filePath, int matchCount,
+                                             const QString& error)
+{
+    if (!error.isEmpty()) {
+        QTreeWidgetItem* docItem = documentItem(filePath);
+        docItem->setText(1, tr("无法打开: %1").arg(error));
+        return;
+    }
+
+    // 无匹配的文档不显示分组
+    if (matchCount == 0 && !m_documentItems.contains(filePath)) {
+        return;
+    }
+
+    QTreeWidgetItem* docItem = documentItem(filePath);
+    docItem->setText(1, tr("%1 处匹配").arg(matchCount));
+}
+
+void MultiDocSearchPanel::onSearchProgress(int finishedDocuments, int totalDocuments,
+                                           int totalMatches)
+{
+    m_statusLabel->setText(tr("搜索中... 已完成 %1/%2 个文档, %3 处匹配")
+                               .arg(finishedDocuments)
+                               .arg(totalDocuments)
+                               .arg(totalMatches));
+}
+
+void MultiDocSearchPanel::onSearchCompleted(const QString& query, int totalDocuments,
+                                            int totalMatches)
+{
+    Q_UNUSED(totalDocuments);
+    updateUI();
+
+    m_statusLabel->setText(tr("“%1”: 在 %2 个文档中找到 %3 处匹配")
+                               .arg(query)
+                               .arg(m_documentItems.size())
+                               .arg(totalMatches));
+}
+
+void MultiDocSearchPanel::onSearchCancelled()
+{
+    updateUI();
+    m_statusLabel->setText(tr("搜索已停止"));
+}
+
+void MultiDocSearchPanel::onItemActivated(QTreeWidgetItem* item, int column)
+{
+    Q_UNUSED(column);
+
+    if (!item) {
+        return;
+    }
+
+    QString filePath = item->data(0, FilePathRole).toString();
+    QVariant pageData = item->data(0, PageIndexRole);
+
+    // 分组节点跳转到第一页
+    int pageIndex = pageData.isValid() ? pageData.toInt() : 0;
+    if (!filePath.isEmpty()) {
+        emit resultActivated(filePath, pageIndex);
+    }
+}
+
+void MultiDocSearchPanel::updateUI()
+{
+    bool searching = m_searchManager->isSearching();
+    bool folderScope = m_scopeCombo->currentData().toInt() == Folder;
+
+    m_searchButton->setText(searching ? tr("停止") : tr("搜索"));
+    m_folderButton->setVisible(folderScope);
+    m_folderButton->setToolTip(m_folderPath);
+    m_folderButton->setText(m_folderPath.isEmpty()
+                                ? tr("选择文件夹...")
+                                : QFileInfo(m_folderPath).fileName());
+
+    m_scopeCombo->setEnabled(!searching);
+    m_caseSensitiveCheck->setEnabled(!searching);
+    m_wholeWordsCheck->setEnabled(!searching);
+    m_foldInsensitiveCheck->setEnabled(!searching);
+
+    if (!searching && !folderScope && m_resultTree->topLevelItemCount() == 0) {
+        m_statusLabel->setText(tr("范围: %1 个已打开的文档").arg(m_openDocumentPaths.size()));
+    }
+}
+
+QTreeWidgetItem* MultiDocSearchPanel::documentItem(const QString& filePath)
+{
+    auto it = m_documentItems.constFind(filePath);
+    if (it != m_documentItems.constEnd()) {
+        return it.value();
+    }
+
+    QTreeWidgetItem* docItem = new QTreeWidgetItem(m_resultTree);
+    docItem->setText(0, QFileInfo(filePath).fileName());
+    docItem->setToolTip(0, filePath);
+    docItem->setData(0, FilePathRole, filePath);
+    docItem->setExpanded(true);
+
+    QFont font = docItem->font(0);
+    font.setBold(true);
+    docItem->setFont(0, font);
+
+    m_documentItems.insert(filePath, docItem);
+    return docItem;
+}
@@ -0,0 +1,94 @@
+#ifndef MULTIDOCSEARCHPANEL_H
+#define MULTIDOCSEARCHPANEL_H
+
+#include <QWidget>
+#include <QHash>
+#include <QStringList>
+#include "datastructure.h"
+
+class MultiDocSearchManager;
+class QLineEdit;
+class QComboBox;
+class QPushButton;
+class QCheckBox;
+class QLabel;
+class QTreeWidget;
+class QTreeWidgetItem;
+
+/**
+ * @brief 多文档搜索面板
+ *
+ * 职责：
+ * 1. 选择搜索范围（已打开的文档 / 指定文件夹）
+ * 2. 通过 MultiDocSearchManager 发起并行搜索
+ * 3. 按文档分组流式显示结果，双击结果请求跳转
+ */
+class MultiDocSearchPanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit MultiDocSearchPanel(QWidget* parent = nullptr);
+    ~MultiDocSearchPanel();
+
+    /**
+     * @brief 更新“已打开的文档”范围对应的文件列表
+     */
+    void setOpenDocumentPaths(const QStringList& filePaths);
+
+    void showAndFocus();
+
+signals:
+    /**
+     * @brief 请求打开（或切换到）文档并跳转到指定页
+     */
+    void resultActivated(const QString& filePath, int pageIndex);
+
+private slots:
+    void performSearch();
+    void chooseFolder();
+    void onScopeChanged(int index);
+    void onSearchStarted(int totalDocuments);
+    void onDocumentResultsReady(const QString& filePath, const QVector<SearchResult>& results);
+    void onDocumentFinished(const QString& filePath, int matchCount, const QString& error);
+    void onSearchProgress(int finishedDocuments, int totalDocuments, int totalMatches);
+    void onSearchCompleted(const QString& query, int totalDocuments, int totalMatches);
+    void onSearchCancelled();
+    void onItemActivated(QTreeWidgetItem* item, int column);
+
+private:
+    void setupUI();
+    void setupConnections();
+    void updateUI();
+    QTreeWidgetItem* documentItem(const QString& filePath);
+
+    enum SearchScope {
+        OpenDocuments = 0,
+        Folder = 1
+    };
+
+    // 结果项数据角色
+    static constexpr int FilePathRole = Qt::UserRole + 1;
+    static constexpr int PageIndexRole = Qt::UserRole + 2;
+
+private:
+    MultiDocSearchManager* m_searchManager;
+
+    QLineEdit* m_queryEdit;
+    QComboBox* m_scopeCombo;
+    QPushButton* m_folderButton;
+    QCheckBox* m_caseSensitiveCheck;
+    QCheckBox* m_wholeWordsCheck;
+    QCheckBox* m_foldInsensitiveCheck;
+    QPushButton* m_searchButton;
+    QLabel* m_statusLabel;
+    QTreeWidget* m_resultTree;
+
+    QStringList m_openDocumentPaths;
+    QString m_folderPath;
+
+    // 文件路径 -> 分组节点
+    QHash<QString, QTreeWidgetItem*> m_documentItems;
+};
+
+#endif // MULTIDOCSEARCHPANEL_H
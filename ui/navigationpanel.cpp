@@ -158,7 +158,7 @@ void NavigationPanel::onTabChanged(int index) {
                 if (!unloadedVisible.isEmpty()) {
                     qInfo() << "NavigationPanel: Tab switched, found" << unloadedVisible.size() << "unloaded visible pages";
                     if (m_session && m_session->contentHandler()) {
-                        m_session->contentHandler()->syncLoadUnloadedPages(unloadedVisible);
+                        m_session->contentHandler()->requestThumbnails(unloadedVisible);
                     }
                 }
             }
@@ -330,27 +330,11 @@ void NavigationPanel::setupConnections()
     connect(m_thumbnailWidget, &ThumbnailWidget::pageJumpRequested,
             this, &NavigationPanel::pageJumpRequested);
 
-    // 监听ThumbnailWidget的可见区域变化，通知ContentHandler加载
+    // 监听ThumbnailWidget的可见区域变化，通知ContentHandler调度加载
     connect(m_thumbnailWidget, &ThumbnailWidget::visibleRangeChanged,
-            this, [this](const QSet<int>& visibleIndices, int margin) {
+            this, [this](const QSet<int>& visibleIndices, int preloadPages, bool scrolling) {
                 if (m_session && m_session->contentHandler()) {
-                    m_session->contentHandler()->handleVisibleRangeChanged(visibleIndices, margin);
-                }
-            });
-
-    // 连接慢速滚动信号（仅大文档生效）
-    connect(m_thumbnailWidget, &ThumbnailWidget::slowScrollDetected,
-            this, [this](const QSet<int>& visiblePages) {
-                if (m_session && m_session->contentHandler()) {
-                    m_session->contentHandler()->handleVisibleRangeChanged(visiblePages, 0);
-                }
-            });
-
-    // 保留滚动停止时的同步加载连接
-    connect(m_thumbnailWidget, &ThumbnailWidget::syncLoadRequested,
-            this, [this](const QSet<int>& unloadedVisible) {
-                if (m_session && m_session->contentHandler()) {
-                    m_session->contentHandler()->syncLoadUnloadedPages(unloadedVisible);
+                    m_session->contentHandler()->handleVisibleRangeChanged(visibleIndices, preloadPages, scrolling);
                 }
             });
 
@@ -376,9 +360,14 @@ void NavigationPanel::setupConnections()
         connect(m_session->contentHandler(), &PDFContentHandler::thumbnailsInitialized,
                 this, [this](int pageCount) {
                     qInfo() << "NavigationPanel: Initializing" << pageCount << "thumbnail placeholders";
+                    m_thumbnailWidget->setThumbnailRotation(m_session->state()->currentRotation());
                     m_thumbnailWidget->initializeThumbnails(pageCount);
                 });
 
+        // 视图旋转 - 缩略图在绘制时跟随旋转，不重新渲染
+        connect(m_session, &PDFDocumentSession::currentRotationChanged,
+                m_thumbnailWidget, &ThumbnailWidget::setThumbnailRotation);
+
         // 缩略图加载完成 - UI更新图片
         connect(m_session, &PDFDocumentSession::thumbnailLoaded,
                 this, [this](int pageIndex, const QImage& thumbnail) {
@@ -404,8 +393,8 @@ void NavigationPanel::setupConnections()
 
             // 加载开始
             connect(manager, &ThumbnailManagerV2::loadingStarted,
-                    this, [this](int totalPages, const QString& strategy) {
-                        qInfo() << "Thumbnail loading started:" << strategy << "for" << totalPages << "pages";
+                    this, [this](int totalPages) {
+                        qInfo() << "Thumbnail loading started for" << totalPages << "pages";
                         m_thumbnailStatusLabel->setText(tr("加载开始..."));
                     });
 
@@ -415,15 +404,6 @@ void NavigationPanel::setupConnections()
                         m_thumbnailStatusLabel->setText(status);
                     });
 
-            // 批次进度（中文档）
-            connect(manager, &ThumbnailManagerV2::batchCompleted,
-                    this, [this](int current, int total) {
-                        m_thumbnailProgressBar->setVisible(true);
-                        m_thumbnailProgressBar->setMaximum(total);
-                        m_thumbnailProgressBar->setValue(current);
-                        m_thumbnailProgressBar->setFormat(QString("%1/%2").arg(current).arg(total));
-                    });
-
             // 全部完成
             connect(manager, &ThumbnailManagerV2::allCompleted,
                     this, [this]() {
@@ -438,17 +418,14 @@ void NavigationPanel::setupConnections()
                         });
                     });
 
-            // 加载进度（用于同步加载阶段）
+            // 加载进度
             connect(manager, &ThumbnailManagerV2::loadProgress,
                     this, [this](int current, int total) {
                         if (total > 0) {
-                            int percentage = current * 100 / total;
-                            m_thumbnailStatusLabel->setText(
-                                tr("加载中: %1/%2 (%3%)")
-                                    .arg(current)
-                                    .arg(total)
-                                    .arg(percentage)
-                                );
+                            m_thumbnailProgressBar->setVisible(true);
+                            m_thumbnailProgressBar->setMaximum(total);
+                            m_thumbnailProgressBar->setValue(current);
+                            m_thumbnailProgressBar->setFormat(QString("%1/%2").arg(current).arg(total));
                         }
                     });
         }
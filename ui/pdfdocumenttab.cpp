@@ -135,6 +135,9 @@ void PDFDocumentTab::setupConnections()
     connect(m_session, &PDFDocumentSession::documentError,
             this, &PDFDocumentTab::documentError);
 
+    connect(m_session, &PDFDocumentSession::documentTypeChanged,
+            this, &PDFDocumentTab::onDocumentTypeChanged);
+
     connect(m_session, &PDFDocumentSession::currentPageChanged,
             this, &PDFDocumentTab::onPageChanged);
 
@@ -243,6 +246,12 @@ void PDFDocumentTab::setupConnections()
     connect(m_session, &PDFDocumentSession::paperEffectChanged,
             this, &PDFDocumentTab::paperEffectChanged);
 
+    // 纸质效果图层在后台生成，完成后重绘
+    connect(m_session, &PDFDocumentSession::paperLayerReady,
+            m_pageWidget, [this](int) {
+                m_pageWidget->update();
+            });
+
 
     // PageWidget的OCR悬停信号
     connect(m_pageWidget, &PDFPageWidget::ocrHoverTriggered,
@@ -517,10 +526,6 @@ void PDFDocumentTab::onDocumentLoaded(const QString& filePath, int pageCount)
         m_navigationPanel->loadDocument(pageCount);
     }
 
-    if (m_session->state()->isTextPDF()) {
-        m_session->textCache()->startPreload();
-    }
-
     QTimer::singleShot(0, this, [this]() {
         const PDFDocumentState* state = m_session->state();
         if (state->isDocumentLoaded()) {
@@ -536,6 +541,17 @@ void PDFDocumentTab::onDocumentLoaded(const QString& filePath, int pageCount)
     emit documentLoaded(filePath, pageCount);
 }
 
+void PDFDocumentTab::onDocumentTypeChanged(bool isTextPDF)
+{
+    // 类型检测在首屏渲染之后才完成，按检测结果刷新 OCR 取词状态
+    updateOCRHoverState();
+
+    // 文本版预加载文本层；扫描版只做页面分析（OCR 按页判断是否有文本层）
+    m_session->textCache()->startPreload(m_session->state()->currentPage(), !isTextPDF);
+
+    emit documentTypeChanged(isTextPDF);
+}
+
 void PDFDocumentTab::onPageChanged(int pageIndex)
 {
     // 更新导航面板
@@ -826,6 +842,7 @@ void PDFDocumentTab::refreshVisiblePages()
     // 标记可见页面
     PageCacheManager* cache = m_session->pageCache();
     cache->markVisiblePages(visiblePages);
+    m_session->textCache()->setPinnedPages(TextCacheManager::PinVisible, visiblePages);
 
     // 渲染可见页面
     double zoom = state->currentZoom();
@@ -950,7 +967,7 @@ void PDFDocumentTab::setPaperEffectEnabled(bool enabled)
 {
     if (m_session) {
         m_session->setPaperEffectEnabled(enabled);
-        renderAndUpdatePages();
+        m_pageWidget->update();     // 只需重绘，原始页面无需重新渲染
         emit paperEffectChanged(enabled);
     }
 }
@@ -964,8 +981,8 @@ void PDFDocumentTab::updateOCRHoverState()
 {
     bool enabled = OCRManager::instance().isOCRHoverEnabled();
 
-    // 如果不是扫描版PDF，强制禁用
-    if (!isDocumentLoaded() || isTextPDF()) {
+    // 是否对某一页识别由 PageWidget 按页面分析结果决定（文本版中的扫描页也可识别）
+    if (!isDocumentLoaded()) {
         enabled = false;
     }
 
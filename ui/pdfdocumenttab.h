@@ -124,6 +124,7 @@ signals:
 
     void documentLoaded(const QString& filePath, int pageCount);
     void documentError(const QString& errorMessage);
+    void documentTypeChanged(bool isTextPDF);
     void pageChanged(int pageIndex);
     void zoomChanged(double zoom);
     void displayModeChanged(PageDisplayMode mode);
@@ -135,6 +136,7 @@ signals:
 private slots:
 
     void onDocumentLoaded(const QString& filePath, int pageCount);
+    void onDocumentTypeChanged(bool isTextPDF);
     void onPageChanged(int pageIndex);
     void onZoomChanged(double zoom);
     void onDisplayModeChanged(PageDisplayMode mode);
@@ -4,7 +4,9 @@
 #include "perthreadmupdfrenderer.h"
 #include "pagecachemanager.h"
 #include "pdfinteractionhandler.h"
+#include "searchmanager.h"
 #include "textselector.h"
+#include "textcachemanager.h"
 #include "linkmanager.h"
 #include "ocrmanager.h"
 #include "appconfig.h"
@@ -265,9 +267,8 @@ void PDFPageWidget::paintSinglePageMode(QPainter& painter)
     int x = (width() - m_currentImage.width()) / 2;
     int y = (height() - m_currentImage.height()) / 2;
 
-    drawPageImage(painter, m_currentImage, x, y);
-
     const PDFDocumentState* state = m_session->state();
+    drawPageImage(painter, state->currentPage(), m_currentImage, x, y);
     drawOverlays(painter, state->currentPage(), x, y, state->currentZoom());
 }
 
@@ -286,13 +287,13 @@ void PDFPageWidget::paintDoublePageMode(QPainter& painter)
     // 第一页
     int x1 = startX;
     int y1 = startY + (maxHeight - m_currentImage.height()) / 2;
-    drawPageImage(painter, m_currentImage, x1, y1);
+    drawPageImage(painter, currentPage, m_currentImage, x1, y1);
     drawOverlays(painter, currentPage, x1, y1, actualZoom);
 
     // 第二页
     int x2 = startX + m_currentImage.width() + AppConfig::DOUBLE_PAGE_SPACING;
     int y2 = startY + (maxHeight - m_secondImage.height()) / 2;
-    drawPageImage(painter, m_secondImage, x2, y2);
+    drawPageImage(painter, currentPage + 1, m_secondImage, x2, y2);
 
     if (!m_secondImage.isNull()) {
         int nextPage = currentPage + 1;
@@ -332,7 +333,7 @@ void PDFPageWidget::paintContinuousMode(QPainter& painter, const QRect& visibleR
 
         int pageBottom = pageY + pageImage.height();
         if (pageBottom >= visibleRect.top() && pageY <= visibleRect.bottom()) {
-            drawPageImage(painter, pageImage, pageX, pageY);
+            drawPageImage(painter, pageIndex, pageImage, pageX, pageY);
             drawOverlays(painter, pageIndex, pageX, pageY, actualZoom);
         }
     }
@@ -359,14 +360,16 @@ void PDFPageWidget::paintContinuousMode(QPainter& painter, const QRect& visibleR
     }
 }
 
-void PDFPageWidget::drawPageImage(QPainter& painter, const QImage& image, int x, int y)
+void PDFPageWidget::drawPageImage(QPainter& painter, int pageIndex, const QImage& image, int x, int y)
 {
     // 阴影
     QRect shadowRect = image.rect().translated(x + AppConfig::SHADOW_OFFSET, y + AppConfig::SHADOW_OFFSET);
     painter.fillRect(shadowRect, QColor(0, 0, 0, 100));
 
-    // 页面
-    painter.drawImage(x, y, image);
+    // 页面（纸质效果图层在后台生成，生成前先显示原始渲染结果）
+    const PDFDocumentState* state = m_session->state();
+    painter.drawImage(x, y, m_session->composePage(pageIndex, state->currentZoom(),
+                                                   state->currentRotation(), image));
 }
 
 void PDFPageWidget::drawPagePlaceholder(QPainter& painter, const QRect& rect, int pageIndex)
@@ -392,25 +395,35 @@ void PDFPageWidget::drawSearchHighlights(QPainter& painter, int pageIndex, int p
     PDFInteractionHandler* handler = m_session->interactionHandler();
     if (!handler) return;
 
-    QVector<SearchResult> results = handler->getPageSearchResults(pageIndex);
-    if (results.isEmpty()) return;
+    // 持有快照即可无锁读取，只遍历该页的结果块，无需扫描或拷贝结果
+    SearchResultSnapshotPtr snapshot = handler->searchResultSnapshot();
+    if (!snapshot) return;
+
+    const QVector<int>& pageChunks = snapshot->pageChunkIndices(pageIndex);
+    if (pageChunks.isEmpty()) return;
 
     const PDFDocumentState* state = m_session->state();
     int currentMatchIndex = state->searchCurrentMatchIndex();
 
-    for (const SearchResult& result : results) {
-        bool isCurrent = false; // 判断逻辑保持不变
+    for (int chunk : pageChunks) {
+        const QVector<SearchResult>& results = *snapshot->chunks[chunk];
+        const int firstIndex = snapshot->chunkStarts[chunk];
+
+        for (int i = 0; i < results.size(); ++i) {
+            const SearchResult& result = results[i];
+            bool isCurrent = (firstIndex + i == currentMatchIndex);
 
-        for (const QRectF& quad : result.quads) {
-            QRectF scaledQuad(quad.x() * zoom, quad.y() * zoom, quad.width() * zoom, quad.height() * zoom);
-            scaledQuad.translate(pageX, pageY);
+            for (const QRectF& quad : result.quads) {
+                QRectF scaledQuad(quad.x() * zoom, quad.y() * zoom, quad.width() * zoom, quad.height() * zoom);
+                scaledQuad.translate(pageX, pageY);
 
-            if (isCurrent) {
-                painter.fillRect(scaledQuad, QColor(255, 165, 0, 120));
-                painter.setPen(QPen(QColor(255, 140, 0), 2));
-                painter.drawRect(scaledQuad);
-            } else {
-                painter.fillRect(scaledQuad, QColor(255, 255, 0, 80));
+                if (isCurrent) {
+                    painter.fillRect(scaledQuad, QColor(255, 165, 0, 120));
+                    painter.setPen(QPen(QColor(255, 140, 0), 2));
+                    painter.drawRect(scaledQuad);
+                } else {
+                    painter.fillRect(scaledQuad, QColor(255, 255, 0, 80));
+                }
             }
         }
     }
@@ -509,6 +522,12 @@ void PDFPageWidget::triggerOCRAtCurrentPosition()
         return;
     }
 
+    // 只对没有文本层的页面做 OCR
+    if (!isOCRPage(pageIndex)) {
+        qDebug() << "Page" << pageIndex << "has a text layer, OCR skipped";
+        return;
+    }
+
     // 提取悬浮区域的图像
     QImage image = extractHoverRegion(hoverPos);
     if (!image.isNull()) {
@@ -525,11 +544,20 @@ void PDFPageWidget::mouseMoveEvent(QMouseEvent* event)
     // 始终更新鼠标位置(用于快捷键触发OCR)
     m_lastHoverPos = event->pos();
 
-    // OCR模式下不需要定时器,只记录位置
-    if (m_ocrHoverEnabled) {
-        // 可以在这里更新光标样式
-        event->accept();
-        return;
+    // OCR模式下不需要定时器,只记录位置；有文本层的页面照常选择文本
+    if (m_ocrHoverEnabled && !m_isTextSelecting) {
+        const int hoverPage = getPageAtPos(event->pos(), nullptr, nullptr);
+        if (hoverPage >= 0 && isOCRPage(hoverPage)) {
+            if (cursor().shape() != Qt::CrossCursor) {
+                setCursor(Qt::CrossCursor);
+            }
+            event->accept();
+            return;
+        }
+
+        if (cursor().shape() == Qt::CrossCursor) {
+            setCursor(defaultCursorShape());
+        }
     }
 
     const PDFDocumentState* state = m_session->state();
@@ -629,21 +657,33 @@ void PDFPageWidget::setOCRHoverEnabled(bool enabled)
         m_hoverTimer.stop();
     }
 
-    // 修改光标样式
-    if (enabled) {
-        setCursor(Qt::CrossCursor);
-    } else {
-        const PDFDocumentState* state = m_session->state();
-        if (state && state->isTextPDF()) {
-            setCursor(Qt::IBeamCursor);
-        } else {
-            setCursor(Qt::ArrowCursor);
-        }
+    // 修改光标样式（启用后在没有文本层的页面上显示十字光标，见 mouseMoveEvent）
+    if (!enabled || cursor().shape() == Qt::CrossCursor) {
+        setCursor(defaultCursorShape());
     }
 
     qInfo() << "OCR hover enabled changed to:" << enabled;
 }
 
+bool PDFPageWidget::isOCRPage(int pageIndex) const
+{
+    // 文本版中夹带的扫描页、扫描版中的文字页都按页面分析结果判断
+    PageAnalysis analysis;
+    if (m_session->textCache()->pageAnalysis(pageIndex, &analysis)) {
+        return !analysis.hasTextLayer;
+    }
+
+    // 页面分析尚未完成
+    const PDFDocumentState* state = m_session->state();
+    return !(state && state->isTextPDF());
+}
+
+Qt::CursorShape PDFPageWidget::defaultCursorShape() const
+{
+    const PDFDocumentState* state = m_session->state();
+    return (state && state->isTextPDF()) ? Qt::IBeamCursor : Qt::ArrowCursor;
+}
+
 QImage PDFPageWidget::extractHoverRegion(const QPoint& pos)
 {
     /*
@@ -80,7 +80,7 @@ public:
     QSize calculateRequiredSize() const;
 
     /**
-     * @brief 设置OCR悬停模式
+     * @brief 设置OCR悬停模式（只对没有文本层的页面生效，见 isOCRPage()）
      */
     void setOCRHoverEnabled(bool enabled);
 
@@ -151,7 +151,7 @@ private:
     void paintDoublePageMode(QPainter& painter);
     void paintContinuousMode(QPainter& painter, const QRect& visibleRect);
 
-    void drawPageImage(QPainter& painter, const QImage& image, int x, int y);
+    void drawPageImage(QPainter& painter, int pageIndex, const QImage& image, int x, int y);
     void drawPagePlaceholder(QPainter& painter, const QRect& rect, int pageIndex);
 
     // 绘制叠加层（高亮、链接等）
@@ -162,6 +162,11 @@ private:
 
 private:
     void setupOCRHover();
+
+    // 页面是否需要 OCR：有页面分析结果时按该页是否有文本层判断，否则按文档类型
+    bool isOCRPage(int pageIndex) const;
+    Qt::CursorShape defaultCursorShape() const;
+
     QImage extractHoverRegion(const QPoint& pos);
     QRect calculateHoverRect(const QPoint& pos);
 
@@ -2,15 +2,19 @@
 #include "pdfdocumentsession.h"
 #include "pdfdocumentstate.h"
 #include "pdfinteractionhandler.h"
+#include "searchresultmodel.h"
 
 #include <QHBoxLayout>
 #include <QVBoxLayout>
 #include <QKeyEvent>
 #include <QStyle>
+#include <QListView>
 
 SearchWidget::SearchWidget(PDFDocumentSession* session, QWidget* parent)
     : QWidget(parent)
     , m_session(session)
+    , m_resultList(nullptr)
+    , m_resultModel(nullptr)
     , m_isSearching(false)
 {
     setupUI();
@@ -32,9 +36,14 @@ QString SearchWidget::searchText() const
 
 void SearchWidget::setupUI()
 {
-    QHBoxLayout* mainLayout = new QHBoxLayout(this);
+    QVBoxLayout* outerLayout = new QVBoxLayout(this);
+    outerLayout->setContentsMargins(0, 0, 0, 0);
+    outerLayout->setSpacing(0);
+
+    QHBoxLayout* mainLayout = new QHBoxLayout();
     mainLayout->setContentsMargins(5, 5, 5, 5);
     mainLayout->setSpacing(5);
+    outerLayout->addLayout(mainLayout);
 
     QLabel* searchLabel = new QLabel(tr("查找:"), this);
     mainLayout->addWidget(searchLabel);
@@ -67,14 +76,38 @@ void SearchWidget::setupUI()
     m_wholeWordsCheck = new QCheckBox(tr("整个单词"), this);
     mainLayout->addWidget(m_wholeWordsCheck);
 
+    m_foldInsensitiveCheck = new QCheckBox(tr("忽略变音/全半角"), this);
+    m_foldInsensitiveCheck->setToolTip(tr("忽略变音符号、全角/半角和大小写差异"));
+    mainLayout->addWidget(m_foldInsensitiveCheck);
+
     mainLayout->addStretch();
 
+    m_resultListButton = new QToolButton(this);
+    m_resultListButton->setText(tr("结果列表"));
+    m_resultListButton->setCheckable(true);
+    m_resultListButton->setAutoRaise(true);
+    mainLayout->addWidget(m_resultListButton);
+
     m_closeButton = new QToolButton(this);
     m_closeButton->setIcon(style()->standardIcon(QStyle::SP_TitleBarCloseButton));
     m_closeButton->setAutoRaise(true);
     m_closeButton->setToolTip(tr("关闭 (Esc)"));
     mainLayout->addWidget(m_closeButton);
 
+    // 结果列表：只在展开时才会拉取结果和生成上下文
+    m_resultModel = new SearchResultModel(this);
+    if (m_session && m_session->interactionHandler()) {
+        m_resultModel->setSearchManager(m_session->interactionHandler()->searchManager());
+    }
+
+    m_resultList = new QListView(this);
+    m_resultList->setModel(m_resultModel);
+    m_resultList->setUniformItemSizes(true);
+    m_resultList->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_resultList->setMaximumHeight(180);
+    m_resultList->setVisible(false);
+    outerLayout->addWidget(m_resultList);
+
     setStyleSheet(R"(
         SearchWidget {
             background-color: palette(window);
@@ -96,10 +129,18 @@ void SearchWidget::setupConnections()
     // 选项变化时重新搜索
     connect(m_caseSensitiveCheck, &QCheckBox::toggled, this, &SearchWidget::performSearch);
     connect(m_wholeWordsCheck, &QCheckBox::toggled, this, &SearchWidget::performSearch);
+    connect(m_foldInsensitiveCheck, &QCheckBox::toggled, this, &SearchWidget::performSearch);
 
     // 关闭按钮
     connect(m_closeButton, &QToolButton::clicked, this, &SearchWidget::closeRequested);
 
+    // 结果列表
+    connect(m_resultListButton, &QToolButton::toggled, this, [this](bool checked) {
+        m_resultList->setVisible(checked);
+        m_resultModel->setActive(checked);
+    });
+    connect(m_resultList, &QListView::clicked, this, &SearchWidget::onResultListClicked);
+
     // Session 信号
     connect(m_session, &PDFDocumentSession::searchCompleted,
             this, &SearchWidget::onSearchCompleted);
@@ -127,14 +168,17 @@ void SearchWidget::performSearch()
         m_session->cancelSearch();
     }
 
+    m_resultModel->reset();
+
 
     if (m_session) {
         bool caseSensitive = m_caseSensitiveCheck->isChecked();
         bool wholeWords = m_wholeWordsCheck->isChecked();
+        bool foldInsensitive = m_foldInsensitiveCheck->isChecked();
 
         int startPage = m_session->state()->currentPage();
 
-        m_session->startSearch(query, caseSensitive, wholeWords, startPage);
+        m_session->startSearch(query, caseSensitive, wholeWords, startPage, foldInsensitive);
 
         if (m_session->interactionHandler()) {
             m_session->interactionHandler()->addSearchHistory(query);
@@ -216,6 +260,20 @@ void SearchWidget::onSearchProgress(int currentPage, int totalPages, int matchCo
                               .arg(matchCount));
 }
 
+void SearchWidget::onResultListClicked(const QModelIndex& index)
+{
+    if (!index.isValid()) {
+        return;
+    }
+
+    int matchIndex = index.data(SearchResultModel::MatchIndexRole).toInt();
+    SearchResult result = m_session->findAt(matchIndex);
+    if (result.isValid()) {
+        navigateToResult(result);
+        updateUI();
+    }
+}
+
 void SearchWidget::navigateToResult(const SearchResult& result)
 {
     if (!result.isValid()) {
@@ -11,6 +11,8 @@
 #include "datastructure.h"
 
 class PDFDocumentSession;
+class SearchResultModel;
+class QListView;
 
 /**
  * @brief 搜索工具栏组件
@@ -45,6 +47,7 @@ private slots:
     void performSearch();
     void onSearchCompleted(const QString& query, int totalMatches);
     void onSearchProgress(int currentPage, int totalPages, int matchCount);
+    void onResultListClicked(const QModelIndex& index);
 
 protected:
     void keyPressEvent(QKeyEvent* event) override;
@@ -64,8 +67,14 @@ private:
     QLabel* m_matchLabel;
     QCheckBox* m_caseSensitiveCheck;
     QCheckBox* m_wholeWordsCheck;
+    QCheckBox* m_foldInsensitiveCheck;
+    QToolButton* m_resultListButton;
     QToolButton* m_closeButton;
 
+    // 结果列表（分页加载，上下文按需生成）
+    QListView* m_resultList;
+    SearchResultModel* m_resultModel;
+
     bool m_isSearching;
 };
 
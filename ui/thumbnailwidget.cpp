@@ -1,42 +1,57 @@
 #include "thumbnailwidget.h"
 #include "thumbnailmanagerv2.h"
-#include <QVBoxLayout>
 #include <QMouseEvent>
 #include <QPainter>
 #include <QPainterPath>
-#include <QGraphicsDropShadowEffect>
+#include <QPaintEvent>
 #include <QScrollBar>
+#include <QTransform>
 #include <QDebug>
 #include <QDateTime>
 
+namespace {
+
+constexpr int ITEM_MARGIN = 8;          // 单元格内边距
+constexpr int LABEL_SPACING = 6;        // 图片与页码之间的间距
+constexpr int CORNER_RADIUS = 4;
+
+QFont labelFont(const QFont& base, bool bold)
+{
+    QFont font = base;
+    font.setPointSize(9);
+    font.setBold(bold);
+    return font;
+}
+
+} // namespace
+
 ThumbnailWidget::ThumbnailWidget(QWidget* parent)
-    : QScrollArea(parent)
-    , m_container(nullptr)
-    , m_layout(nullptr)
+    : QAbstractScrollArea(parent)
+    , m_pageCount(0)
     , m_thumbnailWidth(DEFAULT_THUMBNAIL_WIDTH)
+    , m_cellWidth(0)
+    , m_cellHeight(0)
+    , m_labelHeight(0)
+    , m_gridLeft(THUMBNAIL_SPACING)
     , m_currentPage(-1)
+    , m_hoverPage(-1)
     , m_columnsPerRow(2)
+    , m_rotation(0)
     , m_scrollState(ScrollState::IDLE)
     , m_manager(nullptr)
 {
-    m_container = new QWidget(this);
-    m_layout = new QGridLayout(m_container);
-    m_layout->setSpacing(THUMBNAIL_SPACING);
-    m_layout->setContentsMargins(
-        THUMBNAIL_SPACING, THUMBNAIL_SPACING,
-        THUMBNAIL_SPACING, THUMBNAIL_SPACING
-        );
-
-    setWidget(m_container);
-    setWidgetResizable(true);
-
     setStyleSheet(R"(
-        QScrollArea {
+        QAbstractScrollArea {
             background-color: #F5F5F5;
             border: none;
         }
     )");
 
+    viewport()->setMouseTracking(true);
+    viewport()->setAutoFillBackground(false);
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    verticalScrollBar()->setSingleStep(20);
+
     m_throttleTimer = new QTimer(this);
     m_throttleTimer->setSingleShot(true);
     m_throttleTimer->setInterval(30);
@@ -48,6 +63,8 @@ ThumbnailWidget::ThumbnailWidget(QWidget* parent)
     m_debounceTimer->setInterval(150);
     connect(m_debounceTimer, &QTimer::timeout,
             this, &ThumbnailWidget::onScrollDebounce);
+
+    updateLayout();
 }
 
 ThumbnailWidget::~ThumbnailWidget()
@@ -62,10 +79,6 @@ void ThumbnailWidget::setThumbnailManager(ThumbnailManagerV2* manager)
     m_manager = manager;
 }
 
-bool ThumbnailWidget::isLargeLoadMode() {
-    return m_manager->thumbnailLoadStrategy()->type() == LoadStrategyType::LARGE_DOC;
-}
-
 void ThumbnailWidget::initializeThumbnails(int pageCount)
 {
     clear();
@@ -75,52 +88,22 @@ void ThumbnailWidget::initializeThumbnails(int pageCount)
         return;
     }
 
-    qInfo() << "ThumbnailWidget: Initializing" << pageCount << "thumbnail placeholders";
-
-    int availableWidth = viewport()->width() - 2 * THUMBNAIL_SPACING;
-    int itemWidth = m_thumbnailWidth + 20;
-    m_columnsPerRow = qMax(1, availableWidth / itemWidth);
-
-    qDebug() << "ThumbnailWidget: viewport width =" << viewport()->width()
-             << ", availableWidth =" << availableWidth
-             << ", itemWidth =" << itemWidth
-             << ", columns =" << m_columnsPerRow;
-
-    for (int i = 0; i < pageCount; ++i) {
-        auto* item = new ThumbnailItem(i, m_thumbnailWidth, m_container);
-        item->setPlaceholder(tr("第%1页").arg(i + 1));
-
-        connect(item, &ThumbnailItem::clicked,
-                this, &ThumbnailWidget::onThumbnailClicked);
-
-        int row = i / m_columnsPerRow;
-        int col = i % m_columnsPerRow;
-        m_layout->addWidget(item, row, col);
-
-        m_thumbnailItems[i] = item;
-    }
+    m_pageCount = pageCount;
+    m_states.fill(ItemState::Placeholder, pageCount);
+    updateLayout();
+    viewport()->update();
 
-    qInfo() << "ThumbnailWidget: Created" << pageCount << "placeholder items";
+    qInfo() << "ThumbnailWidget: Initialized" << pageCount << "thumbnails"
+            << ", columns =" << m_columnsPerRow;
 
-    // 延迟发送初始可见信号
+    // 延迟发送初始可见信号（等待停靠窗口完成布局，viewport 尺寸才是最终值）
     QTimer::singleShot(100, this, [this]() {
-        // 强制布局立即计算
-        m_container->adjustSize();
-        m_layout->activate();
-        QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
-
         QSet<int> initialVisible = getVisibleIndices(0);
 
         qDebug() << "ThumbnailWidget: Initial visible count =" << initialVisible.size();
         if (initialVisible.isEmpty()) {
-            qWarning() << "ThumbnailWidget: No initial visible items found!";
-            // 打印前几个widget的geometry用于调试
-            for (int i = 0; i < qMin(5, m_thumbnailItems.size()); ++i) {
-                if (m_thumbnailItems.contains(i)) {
-                    qDebug() << "  Widget" << i << "geometry:"
-                             << m_thumbnailItems[i]->geometry();
-                }
-            }
+            qWarning() << "ThumbnailWidget: No initial visible items found!"
+                       << "viewport:" << viewport()->size();
         }
 
         emit initialVisibleReady(initialVisible);
@@ -129,9 +112,6 @@ void ThumbnailWidget::initializeThumbnails(int pageCount)
 
 void ThumbnailWidget::clear()
 {
-    if (!m_layout)
-        return;
-
     qDebug() << "ThumbnailWidget::clear() - Start";
 
     if (m_throttleTimer && m_throttleTimer->isActive()) {
@@ -141,34 +121,43 @@ void ThumbnailWidget::clear()
         m_debounceTimer->stop();
     }
 
-    while (QLayoutItem* item = m_layout->takeAt(0)) {
-        if (QWidget* w = item->widget()) {
-            w->deleteLater();
-        }
-        delete item;
-    }
-
-    m_thumbnailItems.clear();
+    m_pageCount = 0;
+    m_states.clear();
+    m_pixmaps.clear();
     m_scrollHistory.clear();
     m_currentPage = -1;
+    m_hoverPage = -1;
 
-    m_layout->invalidate();
+    updateLayout();
+    viewport()->unsetCursor();
+    viewport()->update();
 
     qDebug() << "ThumbnailWidget::clear() - Finished";
 }
 
 void ThumbnailWidget::highlightCurrentPage(int pageIndex)
 {
-    if (m_currentPage >= 0 && m_thumbnailItems.contains(m_currentPage)) {
-        m_thumbnailItems[m_currentPage]->setHighlight(false);
+    const int previous = m_currentPage;
+    m_currentPage = pageIndex;
+
+    updateCell(previous);
+
+    if (m_currentPage < 0 || m_currentPage >= m_pageCount) {
+        return;
     }
 
-    m_currentPage = pageIndex;
+    updateCell(m_currentPage);
 
-    if (m_currentPage >= 0 && m_thumbnailItems.contains(m_currentPage)) {
-        auto* item = m_thumbnailItems[m_currentPage];
-        item->setHighlight(true);
-        ensureWidgetVisible(item, 50, 50);
+    // 确保当前页在可见区内（上下各留 50 像素）
+    const QRect cell = cellRect(m_currentPage);
+    const int top = verticalScrollBar()->value();
+    const int height = viewport()->height();
+    constexpr int margin = 50;
+
+    if (cell.top() - margin < top) {
+        verticalScrollBar()->setValue(cell.top() - margin);
+    } else if (cell.bottom() + margin > top + height) {
+        verticalScrollBar()->setValue(cell.bottom() + margin - height);
     }
 }
 
@@ -181,25 +170,52 @@ void ThumbnailWidget::setThumbnailSize(int width)
 
     if (m_thumbnailWidth != width) {
         m_thumbnailWidth = width;
+        m_pixmaps.clear();
+        updateLayout();
+        viewport()->update();
     }
 }
 
+void ThumbnailWidget::setThumbnailRotation(int rotation)
+{
+    int normalized = rotation % 360;
+    if (normalized < 0) normalized += 360;
+
+    if (m_rotation == normalized) {
+        return;
+    }
+
+    // 缩略图原图不旋转，只需按新角度重新生成可见区的绘制结果
+    m_rotation = normalized;
+    m_pixmaps.clear();
+    updateLayout();
+    viewport()->update();
+}
+
 void ThumbnailWidget::onThumbnailLoaded(int pageIndex, const QImage& thumbnail)
 {
-    if (!m_thumbnailItems.contains(pageIndex)) {
+    if (pageIndex < 0 || pageIndex >= m_pageCount) {
         return;
     }
 
-    ThumbnailItem* item = m_thumbnailItems[pageIndex];
-    item->setThumbnail(thumbnail);
+    m_states[pageIndex] = thumbnail.isNull() ? ItemState::Error : ItemState::Loaded;
+    m_pixmaps.remove(pageIndex);
+
+    // 只有可见的缩略图立即生成绘制结果，其余等滚动到时再从缓存取原图
+    const QRect cell = cellRect(pageIndex).translated(0, -verticalScrollBar()->value());
+    if (!thumbnail.isNull() && cell.intersects(viewport()->rect())) {
+        const QRect box = imageRect(cell);
+        m_pixmaps.insert(pageIndex, createRoundedPixmap(thumbnail, box.size()));
+        viewport()->update(cell.adjusted(-4, -4, 4, 6));
+    }
 }
 
 void ThumbnailWidget::scrollContentsBy(int dx, int dy)
 {
-    QScrollArea::scrollContentsBy(dx, dy);
+    Q_UNUSED(dx);
+    viewport()->scroll(0, dy);
 
-    if(!isLargeLoadMode()) {
-        m_scrollHistory.clear();
+    if (m_pageCount == 0) {
         return;
     }
 
@@ -214,85 +230,333 @@ void ThumbnailWidget::scrollContentsBy(int dx, int dy)
 
 void ThumbnailWidget::resizeEvent(QResizeEvent* event)
 {
-    QScrollArea::resizeEvent(event);
+    QAbstractScrollArea::resizeEvent(event);
+
+    const int oldColumns = m_columnsPerRow;
+    updateLayout();
+
+    if (m_columnsPerRow != oldColumns) {
+        qDebug() << "ThumbnailWidget: Columns changed to" << m_columnsPerRow;
+
+        if (m_pageCount > 0) {
+            m_debounceTimer->start();
+        }
+    }
+}
+
+// ========== 布局 ==========
+
+void ThumbnailWidget::updateLayout()
+{
+    const int imageHeight = imageBoxHeight();
+    m_labelHeight = QFontMetrics(labelFont(font(), true)).height();
+    m_cellWidth = m_thumbnailWidth + 2 * ITEM_MARGIN;
+    m_cellHeight = ITEM_MARGIN + imageHeight + LABEL_SPACING + m_labelHeight + ITEM_MARGIN;
 
     int availableWidth = viewport()->width() - 2 * THUMBNAIL_SPACING;
     int itemWidth = m_thumbnailWidth + 20;
-    int newColumns = qMax(1, availableWidth / itemWidth);
+    m_columnsPerRow = qMax(1, availableWidth / itemWidth);
 
-    if (newColumns != m_columnsPerRow) {
-        m_columnsPerRow = newColumns;
+    // 网格水平居中
+    const int gridWidth = m_columnsPerRow * m_cellWidth + (m_columnsPerRow - 1) * THUMBNAIL_SPACING;
+    m_gridLeft = qMax(THUMBNAIL_SPACING, (viewport()->width() - gridWidth) / 2);
 
-        qDebug() << "ThumbnailWidget: Columns changed to" << m_columnsPerRow;
+    const int rows = rowCount();
+    const int contentHeight = rows > 0
+        ? 2 * THUMBNAIL_SPACING + rows * rowPitch() - THUMBNAIL_SPACING
+        : 0;
 
-        for (int i = 0; i < m_thumbnailItems.size(); ++i) {
-            int row = i / m_columnsPerRow;
-            int col = i % m_columnsPerRow;
+    verticalScrollBar()->setPageStep(viewport()->height());
+    verticalScrollBar()->setRange(0, qMax(0, contentHeight - viewport()->height()));
+}
 
-            QLayoutItem* layoutItem = m_layout->itemAtPosition(row, col);
-            if (!layoutItem || layoutItem->widget() != m_thumbnailItems[i]) {
-                m_layout->removeWidget(m_thumbnailItems[i]);
-                m_layout->addWidget(m_thumbnailItems[i], row, col);
-            }
-        }
+int ThumbnailWidget::rowCount() const
+{
+    return (m_pageCount + m_columnsPerRow - 1) / m_columnsPerRow;
+}
 
-        if(isLargeLoadMode()) {
-            m_throttleTimer->start();
-        }
+QRect ThumbnailWidget::cellRect(int index) const
+{
+    const int row = index / m_columnsPerRow;
+    const int col = index % m_columnsPerRow;
+    return QRect(m_gridLeft + col * (m_cellWidth + THUMBNAIL_SPACING),
+                 THUMBNAIL_SPACING + row * rowPitch(),
+                 m_cellWidth, m_cellHeight);
+}
+
+QRect ThumbnailWidget::imageRect(const QRect& cell) const
+{
+    return QRect(cell.left() + ITEM_MARGIN, cell.top() + ITEM_MARGIN,
+                 m_thumbnailWidth, imageBoxHeight());
+}
+
+int ThumbnailWidget::imageBoxHeight() const
+{
+    // 旋转 90/270 度时按横向页面留位置
+    const bool quarterTurn = (m_rotation % 180) != 0;
+    return static_cast<int>(quarterTurn ? m_thumbnailWidth / A4_RATIO : m_thumbnailWidth * A4_RATIO);
+}
+
+int ThumbnailWidget::indexAt(const QPoint& viewportPos) const
+{
+    const QPoint pos = viewportPos + QPoint(0, verticalScrollBar()->value());
+
+    const int row = (pos.y() - THUMBNAIL_SPACING) / rowPitch();
+    const int col = (pos.x() - m_gridLeft) / (m_cellWidth + THUMBNAIL_SPACING);
+    if (pos.y() < THUMBNAIL_SPACING || pos.x() < m_gridLeft ||
+        col >= m_columnsPerRow || row >= rowCount()) {
+        return -1;
     }
+
+    const int index = row * m_columnsPerRow + col;
+    if (index >= m_pageCount || !cellRect(index).contains(pos)) {
+        return -1;  // 落在间距里
+    }
+    return index;
 }
 
-void ThumbnailWidget::onScrollThrottle()
+void ThumbnailWidget::visibleRange(int margin, int* first, int* last) const
 {
-    if(!isLargeLoadMode()) {
+    *first = 0;
+    *last = -1;
+    if (m_pageCount == 0) {
         return;
     }
 
-    // 只有在应该响应滚动时才通知
-    if (m_manager && m_manager->shouldRespondToScroll()) {
-        notifyVisibleRange();
+    const int top = verticalScrollBar()->value() - margin;
+    const int bottom = verticalScrollBar()->value() + viewport()->height() + margin;
+
+    const int firstRow = qMax(0, (top - THUMBNAIL_SPACING) / rowPitch());
+    const int lastRow = qMin(rowCount() - 1, qMax(0, (bottom - THUMBNAIL_SPACING) / rowPitch()));
+    if (lastRow < firstRow) {
+        return;
     }
+
+    *first = firstRow * m_columnsPerRow;
+    *last = qMin(m_pageCount - 1, (lastRow + 1) * m_columnsPerRow - 1);
 }
 
-void ThumbnailWidget::onScrollDebounce()
+void ThumbnailWidget::updateCell(int index)
 {
-    if(!isLargeLoadMode()) {
+    if (index < 0 || index >= m_pageCount) {
         return;
     }
+    // 含阴影范围
+    viewport()->update(cellRect(index)
+                           .translated(0, -verticalScrollBar()->value())
+                           .adjusted(-4, -4, 4, 6));
+}
 
-    m_scrollState = ScrollState::IDLE;
-    m_scrollHistory.clear();
+// ========== 绘制 ==========
 
-    qDebug() << "ThumbnailWidget: Scroll stopped";
+void ThumbnailWidget::paintEvent(QPaintEvent* event)
+{
+    QPainter painter(viewport());
+    painter.fillRect(event->rect(), QColor(0xF5, 0xF5, 0xF5));
+
+    int first = 0;
+    int last = -1;
+    visibleRange(0, &first, &last);
+
+    const int scrollY = verticalScrollBar()->value();
+    for (int index = first; index <= last; ++index) {
+        const QRect cell = cellRect(index).translated(0, -scrollY);
+        if (cell.adjusted(-4, -4, 4, 6).intersects(event->rect())) {
+            paintCell(painter, index, cell);
+        }
+    }
 
-    // 检查当前Tab是否可见
-    if (!isVisible()) {
-        qDebug() << "ThumbnailWidget: Not visible, ignoring scroll stop";
-        return;
+    releaseOffscreenPixmaps(first, last);
+}
+
+void ThumbnailWidget::paintCell(QPainter& painter, int index, const QRect& cell)
+{
+    const bool highlighted = (index == m_currentPage);
+    const bool hovered = (index == m_hoverPage);
+    const QRect box = imageRect(cell);
+
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    // 阴影（悬停时加深）
+    const int shadowAlpha = hovered ? 22 : 14;
+    const int shadowOffset = hovered ? 4 : 2;
+    painter.setPen(Qt::NoPen);
+    for (int spread = 3; spread >= 1; --spread) {
+        painter.setBrush(QColor(0, 0, 0, shadowAlpha / spread));
+        painter.drawRoundedRect(QRectF(box.adjusted(-spread, -spread + shadowOffset,
+                                                    spread, spread + shadowOffset)),
+                                CORNER_RADIUS + spread, CORNER_RADIUS + spread);
+    }
+
+    // 背景
+    painter.setBrush(Qt::white);
+    painter.drawRoundedRect(QRectF(box), CORNER_RADIUS, CORNER_RADIUS);
+
+    const ItemState state = m_states[index];
+    QPixmap pixmap = (state == ItemState::Loaded) ? pixmapFor(index, box) : QPixmap();
+
+    if (!pixmap.isNull()) {
+        const QSizeF size = pixmap.deviceIndependentSize();
+        const QPointF topLeft(box.left() + (box.width() - size.width()) / 2.0,
+                              box.top() + (box.height() - size.height()) / 2.0);
+        painter.drawPixmap(topLeft, pixmap);
+    } else {
+        painter.setPen(state == ItemState::Error ? QColor(0xF4, 0x43, 0x36) : QColor(0x99, 0x99, 0x99));
+        painter.setFont(labelFont(font(), false));
+        painter.drawText(box, Qt::AlignCenter,
+                         state == ItemState::Error ? tr("加载失败") : tr("第%1页").arg(index + 1));
+    }
+
+    // 边框
+    QColor borderColor(0xE0, 0xE0, 0xE0);
+    qreal borderWidth = 1.0;
+    if (highlighted) {
+        borderColor = QColor(0x21, 0x96, 0xF3);
+        borderWidth = 3.0;
+    } else if (hovered) {
+        borderColor = QColor(0x64, 0xB5, 0xF6);
+        borderWidth = 2.0;
+    }
+    painter.setPen(QPen(borderColor, borderWidth));
+    painter.setBrush(Qt::NoBrush);
+    const qreal inset = borderWidth / 2.0;
+    painter.drawRoundedRect(QRectF(box).adjusted(inset, inset, -inset, -inset),
+                            CORNER_RADIUS, CORNER_RADIUS);
+
+    // 页码
+    const QRect labelRect(cell.left(), box.bottom() + 1 + LABEL_SPACING,
+                          cell.width(), m_labelHeight);
+    painter.setFont(labelFont(font(), highlighted));
+    painter.setPen(highlighted ? QColor(0x21, 0x96, 0xF3) : QColor(0x66, 0x66, 0x66));
+    painter.drawText(labelRect, Qt::AlignCenter, tr("第%1页").arg(index + 1));
+}
+
+QPixmap ThumbnailWidget::pixmapFor(int index, const QRect& imageBox)
+{
+    auto it = m_pixmaps.constFind(index);
+    if (it != m_pixmaps.constEnd()) {
+        return it.value();
     }
 
-    // 检查是否应该响应滚动停止(避免批次加载期间触发)
-    if (m_manager && !m_manager->shouldRespondToScroll()) {
-        qDebug() << "ThumbnailWidget: Ignoring scroll stop during batch loading";
-        return;
+    const QImage image = m_manager ? m_manager->getThumbnail(index) : QImage();
+    if (image.isNull()) {
+        // 原图已不在缓存中，重新标记为未加载，等待下次加载请求
+        m_states[index] = ItemState::Placeholder;
+        return QPixmap();
+    }
+
+    QPixmap pixmap = createRoundedPixmap(image, imageBox.size());
+    m_pixmaps.insert(index, pixmap);
+    return pixmap;
+}
+
+QPixmap ThumbnailWidget::createRoundedPixmap(const QImage& image, const QSize& boxSize) const
+{
+    // 按屏幕像素比缩放，高DPI屏幕上保持清晰
+    const qreal dpr = devicePixelRatioF();
+
+    // 先缩放再旋转：旋转只作用于缩小后的图像，90 度的倍数是行列转置，不需要插值
+    const bool quarterTurn = (m_rotation % 180) != 0;
+    const QSize fitSize = quarterTurn ? boxSize.transposed() : boxSize;
+    QImage scaled = image.scaled(fitSize * dpr, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    if (m_rotation != 0) {
+        scaled = scaled.transformed(QTransform().rotate(m_rotation));
     }
 
-    // 检查可见区域是否有未加载的占位页
-    QSet<int> unloadedVisible = getUnloadedVisiblePages();
+    QPixmap rounded(scaled.size());
+    rounded.fill(Qt::transparent);
 
-    qDebug() << "onScrollDebounce:" << unloadedVisible;
+    QPainter painter(&rounded);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
 
-    if (!unloadedVisible.isEmpty()) {
-        qInfo() << "ThumbnailWidget: Found" << unloadedVisible.size()
-        << "unloaded visible pages after scroll stop, triggering sync load";
+    QPainterPath path;
+    path.addRoundedRect(QRectF(rounded.rect()), CORNER_RADIUS * dpr, CORNER_RADIUS * dpr);
+    painter.setClipPath(path);
+    painter.drawImage(0, 0, scaled);
+    painter.end();
+
+    rounded.setDevicePixelRatio(dpr);
+    return rounded;
+}
 
-        emit syncLoadRequested(unloadedVisible);
+void ThumbnailWidget::releaseOffscreenPixmaps(int first, int last)
+{
+    // 可见区上下各保留一行，来回小幅滚动时不必重建
+    const int keepFirst = first - m_columnsPerRow;
+    const int keepLast = last + m_columnsPerRow;
+
+    for (auto it = m_pixmaps.begin(); it != m_pixmaps.end();) {
+        if (it.key() < keepFirst || it.key() > keepLast) {
+            it = m_pixmaps.erase(it);
+        } else {
+            ++it;
+        }
     }
 }
 
-void ThumbnailWidget::onThumbnailClicked(int pageIndex)
+// ========== 鼠标 ==========
+
+void ThumbnailWidget::mousePressEvent(QMouseEvent* event)
 {
-    emit pageJumpRequested(pageIndex);
+    if (event->button() == Qt::LeftButton) {
+        const int index = indexAt(event->position().toPoint());
+        if (index >= 0) {
+            emit pageJumpRequested(index);
+        }
+    }
+    QAbstractScrollArea::mousePressEvent(event);
+}
+
+void ThumbnailWidget::mouseMoveEvent(QMouseEvent* event)
+{
+    const int index = indexAt(event->position().toPoint());
+    if (index != m_hoverPage) {
+        const int previous = m_hoverPage;
+        m_hoverPage = index;
+        updateCell(previous);
+        updateCell(index);
+
+        if (index >= 0) {
+            viewport()->setCursor(Qt::PointingHandCursor);
+        } else {
+            viewport()->unsetCursor();
+        }
+    }
+    QAbstractScrollArea::mouseMoveEvent(event);
+}
+
+void ThumbnailWidget::leaveEvent(QEvent* event)
+{
+    if (m_hoverPage >= 0) {
+        const int previous = m_hoverPage;
+        m_hoverPage = -1;
+        updateCell(previous);
+        viewport()->unsetCursor();
+    }
+    QAbstractScrollArea::leaveEvent(event);
+}
+
+void ThumbnailWidget::onScrollThrottle()
+{
+    notifyVisibleRange(true);
+}
+
+void ThumbnailWidget::onScrollDebounce()
+{
+    m_scrollState = ScrollState::IDLE;
+    m_scrollHistory.clear();
+
+    qDebug() << "ThumbnailWidget: Scroll stopped";
+
+    // 检查当前Tab是否可见
+    if (!isVisible()) {
+        qDebug() << "ThumbnailWidget: Not visible, ignoring scroll stop";
+        return;
+    }
+
+    // 滚动停止：按最大预加载范围调度，并允许后台补齐
+    notifyVisibleRange(false);
 }
 
 // ========== 可见性判断方法 ==========
@@ -300,31 +564,21 @@ void ThumbnailWidget::onThumbnailClicked(int pageIndex)
 QSet<int> ThumbnailWidget::getVisibleIndices(int margin) const
 {
     QSet<int> visible;
-    if (m_thumbnailItems.isEmpty())
-        return visible;
+
+    int first = 0;
+    int last = -1;
+    visibleRange(margin, &first, &last);
 
     // 以 viewport 为基准的可见区域，加一点上下 margin 作为预加载区域
-    QRect visibleRect = viewport()->rect();
-    qDebug() << "getVisibleIndices visibleRect 1:" << visibleRect;
+    QRect visibleRect = viewport()->rect().translated(0, verticalScrollBar()->value());
     visibleRect.adjust(0, -margin, 0, margin);
-    qDebug() << "getVisibleIndices visibleRect 2:" << visibleRect;
-
-    for (auto it = m_thumbnailItems.constBegin(); it != m_thumbnailItems.constEnd(); ++it) {
-        int index = it.key();
-        ThumbnailItem* item = it.value();
-        if (!item)
-            continue;
-
-        // 把 item 的矩形转换到 viewport 坐标系
-        QPoint topLeft = item->mapTo(viewport(), QPoint(0, 0));
-        QRect itemRect(topLeft, item->size());
 
-        if (itemRect.intersects(visibleRect)) {
+    for (int index = first; index <= last; ++index) {
+        if (cellRect(index).intersects(visibleRect)) {
             visible.insert(index);
         }
     }
 
-    qDebug() << "ThumbnailWidget::getVisibleIndices" << visible;
     return visible;
 }
 
@@ -337,33 +591,28 @@ QSet<int> ThumbnailWidget::getUnloadedVisiblePages() const
         return unloaded;
     }
 
-    if (m_thumbnailItems.isEmpty()) {
-        return unloaded;
-    }
-
-    // 获取严格可见区域(不带margin)
-    QSet<int> visible = getVisibleIndices(0);
-
-    // 检查哪些页面还是占位符
+    // 获取严格可见区域(不带margin)，检查哪些页面还是占位符
+    const QSet<int> visible = getVisibleIndices(0);
     for (int pageIndex : visible) {
-        if (m_thumbnailItems.contains(pageIndex)) {
-            ThumbnailItem* item = m_thumbnailItems[pageIndex];
-            qDebug() << "ThumbnailWidget: getUnloadedVisiblePages" << pageIndex << "hasImage=" << item->hasImage();
-            if (!item->hasImage()) {
-                unloaded.insert(pageIndex);
-            }
+        if (m_states[pageIndex] != ItemState::Loaded) {
+            unloaded.insert(pageIndex);
         }
     }
 
     return unloaded;
 }
 
-void ThumbnailWidget::notifyVisibleRange()
+void ThumbnailWidget::notifyVisibleRange(bool scrolling)
 {
-    int margin = getPreloadMargin(m_scrollState);
-    QSet<int> visible = getVisibleIndices(margin);
+    if (m_pageCount == 0) {
+        return;
+    }
 
-    emit visibleRangeChanged(visible, margin);
+    // 预加载边距（像素）换算成页数：整行计算
+    const int margin = getPreloadMargin(m_scrollState);
+    const int rows = (margin + rowPitch() - 1) / rowPitch();
+
+    emit visibleRangeChanged(getVisibleIndices(0), rows * m_columnsPerRow, scrolling);
 }
 
 // ========== 辅助方法 ==========
@@ -419,206 +668,3 @@ int ThumbnailWidget::getPreloadMargin(ScrollState state) const
     }
     return 800;
 }
-
-// ================================================================
-//                       ThumbnailItem
-// ================================================================
-
-ThumbnailItem::ThumbnailItem(int pageIndex, int width, QWidget* parent)
-    : QWidget(parent)
-    , m_pageIndex(pageIndex)
-    , m_width(width)
-    , m_hasImage(false)
-    , m_isHighlighted(false)
-    , m_isHovered(false)
-{
-    m_height = static_cast<int>(width * ThumbnailWidget::A4_RATIO);
-
-    auto* layout = new QVBoxLayout(this);
-    layout->setContentsMargins(8, 8, 8, 8);
-    layout->setSpacing(6);
-
-    m_imageContainer = new QWidget(this);
-    auto* containerLayout = new QVBoxLayout(m_imageContainer);
-    containerLayout->setContentsMargins(0, 0, 0, 0);
-
-    m_imageLabel = new QLabel(m_imageContainer);
-    m_imageLabel->setFixedSize(width, m_height);
-    m_imageLabel->setAlignment(Qt::AlignCenter);
-    m_imageLabel->setScaledContents(false);
-
-    updateStyle();
-
-    containerLayout->addWidget(m_imageLabel);
-
-    auto* shadow = new QGraphicsDropShadowEffect(this);
-    shadow->setBlurRadius(12);
-    shadow->setColor(QColor(0, 0, 0, 40));
-    shadow->setOffset(0, 2);
-    m_imageContainer->setGraphicsEffect(shadow);
-
-    m_pageLabel = new QLabel(tr("第%1页").arg(pageIndex + 1), this);
-    m_pageLabel->setAlignment(Qt::AlignCenter);
-    QFont font = m_pageLabel->font();
-    font.setPointSize(9);
-    m_pageLabel->setFont(font);
-    m_pageLabel->setStyleSheet("QLabel { color: #666666; }");
-
-    layout->addWidget(m_imageContainer);
-    layout->addWidget(m_pageLabel);
-
-    setFixedWidth(width + 16);
-    setCursor(Qt::PointingHandCursor);
-    setMouseTracking(true);
-}
-
-void ThumbnailItem::setPlaceholder(const QString& text)
-{
-    m_hasImage = false;
-    m_imageLabel->setText(text);
-    m_imageLabel->setStyleSheet(
-        "QLabel { "
-        "    background-color: white; "
-        "    border: 1px solid #E0E0E0; "
-        "    border-radius: 4px; "
-        "    color: #999999; "
-        "}"
-        );
-
-    QFont font = m_imageLabel->font();
-    font.setPointSize(9);
-    m_imageLabel->setFont(font);
-}
-
-void ThumbnailItem::setThumbnail(const QImage& image)
-{
-    if (image.isNull()) {
-        setError(tr("加载失败"));
-        return;
-    }
-
-    m_hasImage = true;
-
-    QImage scaled = image.scaled(
-        m_imageLabel->size(),
-        Qt::KeepAspectRatio,
-        Qt::SmoothTransformation
-        );
-
-    QPixmap pixmap = createRoundedPixmap(scaled);
-    m_imageLabel->setPixmap(pixmap);
-    m_imageLabel->setText(QString());
-
-    updateStyle();
-}
-
-void ThumbnailItem::setError(const QString& error)
-{
-    m_hasImage = false;
-    m_imageLabel->setText(error);
-    m_imageLabel->setStyleSheet(
-        "QLabel { "
-        "    background-color: white; "
-        "    border: 1px solid #E0E0E0; "
-        "    border-radius: 4px; "
-        "    color: #F44336; "
-        "}"
-        );
-
-    QFont font = m_imageLabel->font();
-    font.setPointSize(8);
-    m_imageLabel->setFont(font);
-}
-
-void ThumbnailItem::setHighlight(bool highlight)
-{
-    m_isHighlighted = highlight;
-    updateStyle();
-
-    if (highlight) {
-        m_pageLabel->setStyleSheet("QLabel { color: #2196F3; font-weight: bold; }");
-    } else {
-        m_pageLabel->setStyleSheet("QLabel { color: #666666; }");
-    }
-}
-
-void ThumbnailItem::updateStyle()
-{
-    if (!m_hasImage) {
-        return;
-    }
-
-    QString baseStyle = R"(
-        QLabel {
-            background-color: white;
-            border-radius: 4px;
-        }
-    )";
-
-    if (m_isHighlighted) {
-        m_imageLabel->setStyleSheet(baseStyle +
-                                    "QLabel { border: 3px solid #2196F3; }");
-    } else if (m_isHovered) {
-        m_imageLabel->setStyleSheet(baseStyle +
-                                    "QLabel { border: 2px solid #64B5F6; }");
-    } else {
-        m_imageLabel->setStyleSheet(baseStyle +
-                                    "QLabel { border: 1px solid #E0E0E0; }");
-    }
-}
-
-QPixmap ThumbnailItem::createRoundedPixmap(const QImage& image)
-{
-    QPixmap pixmap = QPixmap::fromImage(image);
-    QPixmap rounded(pixmap.size());
-    rounded.fill(Qt::transparent);
-
-    QPainter painter(&rounded);
-    painter.setRenderHint(QPainter::Antialiasing);
-    painter.setRenderHint(QPainter::SmoothPixmapTransform);
-
-    QPainterPath path;
-    path.addRoundedRect(rounded.rect(), 4, 4);
-    painter.setClipPath(path);
-    painter.drawPixmap(0, 0, pixmap);
-
-    return rounded;
-}
-
-void ThumbnailItem::mousePressEvent(QMouseEvent* event)
-{
-    if (event->button() == Qt::LeftButton) {
-        emit clicked(m_pageIndex);
-    }
-    QWidget::mousePressEvent(event);
-}
-
-void ThumbnailItem::enterEvent(QEnterEvent* event)
-{
-    m_isHovered = true;
-    updateStyle();
-
-    if (auto* shadow = qobject_cast<QGraphicsDropShadowEffect*>(
-            m_imageContainer->graphicsEffect())) {
-        shadow->setBlurRadius(16);
-        shadow->setColor(QColor(0, 0, 0, 60));
-        shadow->setOffset(0, 4);
-    }
-
-    QWidget::enterEvent(event);
-}
-
-void ThumbnailItem::leaveEvent(QEvent* event)
-{
-    m_isHovered = false;
-    updateStyle();
-
-    if (auto* shadow = qobject_cast<QGraphicsDropShadowEffect*>(
-            m_imageContainer->graphicsEffect())) {
-        shadow->setBlurRadius(12);
-        shadow->setColor(QColor(0, 0, 0, 40));
-        shadow->setOffset(0, 2);
-    }
-
-    QWidget::leaveEvent(event);
-}
@@ -1,27 +1,32 @@
 #ifndef THUMBNAILWIDGET_H
 #define THUMBNAILWIDGET_H
 
-#include <QScrollArea>
-#include <QGridLayout>
-#include <QLabel>
+#include <QAbstractScrollArea>
+#include <QHash>
+#include <QPixmap>
 #include <QTimer>
 #include <QQueue>
 #include <QSet>
-#include <QMap>
 #include <QVector>
 #include <QRect>
 
-class ThumbnailItem;
 class ThumbnailManagerV2;
 
 enum class ScrollState {
-    IDLE,         // 静止或极慢 (< 500 px/s)   → 触发加载
-    SLOW_SCROLL,  // 慢速滚动 (500-1000 px/s)  → 触发加载
-    FAST_SCROLL,  // 快速滚动 (1000-3000 px/s) → 不加载
-    FLING         // 惯性滑动 (> 3000 px/s)    → 不加载
+    IDLE,         // 静止或极慢 (< 500 px/s)   → 预加载范围最大
+    SLOW_SCROLL,  // 慢速滚动 (500-1000 px/s)
+    FAST_SCROLL,  // 快速滚动 (1000-3000 px/s)
+    FLING         // 惯性滑动 (> 3000 px/s)    → 只加载可见区
 };
 
-class ThumbnailWidget : public QScrollArea
+/**
+ * @brief 缩略图列表（虚拟化绘制）
+ *
+ * 不为每页创建子控件：网格位置按页序号直接计算，整个列表在 viewport 上绘制。
+ * 只为可见行生成圆角缩放后的 QPixmap，滚出可见区的 QPixmap 立即释放，
+ * 缩略图原图由 ThumbnailManagerV2 的缓存持有，页数再多也只占用一屏的绘制资源。
+ */
+class ThumbnailWidget : public QAbstractScrollArea
 {
     Q_OBJECT
 
@@ -34,7 +39,12 @@ public:
     void highlightCurrentPage(int pageIndex);
     void setThumbnailSize(int width);
 
-    // 新增：设置 Manager 引用，用于检查是否应响应滚动
+    /**
+     * @brief 设置缩略图显示旋转角度（0/90/180/270），绘制时旋转，不重新渲染
+     */
+    void setThumbnailRotation(int rotation);
+
+    // 设置 Manager 引用，用于读取缩略图原图
     void setThumbnailManager(ThumbnailManagerV2* manager);
 
     QSet<int> getUnloadedVisiblePages() const;
@@ -45,41 +55,76 @@ public:
 
 signals:
     void pageJumpRequested(int pageIndex);
-    void visibleRangeChanged(const QSet<int>& visibleIndices, int margin);
+    /**
+     * @brief 可见区变化（滚动中节流发送，滚动停止后再发送一次）
+     * @param visibleIndices 严格可见的页面
+     * @param preloadPages 可见区前后各预加载的页数（随滚动速度变化）
+     * @param scrolling 是否仍在滚动
+     */
+    void visibleRangeChanged(const QSet<int>& visibleIndices, int preloadPages, bool scrolling);
     void initialVisibleReady(const QSet<int>& initialVisible);
-    void syncLoadRequested(const QSet<int>& unloadedVisible);
-    void slowScrollDetected(const QSet<int>& visiblePages);
 
 public slots:
     void onThumbnailLoaded(int pageIndex, const QImage& thumbnail);  // 移除 isHighRes 参数
 
 protected:
+    void paintEvent(QPaintEvent* event) override;
     void scrollContentsBy(int dx, int dy) override;
     void resizeEvent(QResizeEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void mouseMoveEvent(QMouseEvent* event) override;
+    void leaveEvent(QEvent* event) override;
 
 private slots:
     void onScrollThrottle();
     void onScrollDebounce();
-    void onThumbnailClicked(int pageIndex);
 
 private:
-    void calculateItemPositions();
-    QRect calculateItemRect(int row, int col) const;
+    /**
+     * @brief 缩略图状态
+     */
+    enum class ItemState : quint8 {
+        Placeholder,    ///< 未加载
+        Loaded,         ///< 已加载（原图在 ThumbnailManagerV2 缓存中）
+        Error           ///< 加载失败
+    };
+
+    // 布局（全部按页序号计算，内容坐标）
+    void updateLayout();
+    int rowCount() const;
+    int rowPitch() const { return m_cellHeight + THUMBNAIL_SPACING; }
+    QRect cellRect(int index) const;
+    QRect imageRect(const QRect& cell) const;
+    int imageBoxHeight() const;
+    int indexAt(const QPoint& viewportPos) const;
+    void visibleRange(int margin, int* first, int* last) const;
+    void updateCell(int index);
+
+    // 绘制
+    void paintCell(QPainter& painter, int index, const QRect& cell);
+    QPixmap pixmapFor(int index, const QRect& imageBox);
+    QPixmap createRoundedPixmap(const QImage& image, const QSize& boxSize) const;
+    void releaseOffscreenPixmaps(int first, int last);
+
     QSet<int> getVisibleIndices(int margin) const;
     ScrollState detectScrollState();
     int getPreloadMargin(ScrollState state) const;
-    void notifyVisibleRange();
-    bool isLargeLoadMode();
+    void notifyVisibleRange(bool scrolling);
 
 private:
-    QWidget* m_container;
-    QGridLayout* m_layout;
-    QMap<int, ThumbnailItem*> m_thumbnailItems;
-    QVector<QRect> m_itemRects;
+    int m_pageCount;
+    QVector<ItemState> m_states;
+    QHash<int, QPixmap> m_pixmaps;      ///< 只保存可见区附近的绘制结果
 
     int m_thumbnailWidth;
+    int m_cellWidth;
+    int m_cellHeight;
+    int m_labelHeight;
+    int m_gridLeft;
     int m_currentPage;
+    int m_hoverPage;
     int m_columnsPerRow;
+    int m_rotation;                     ///< 显示旋转角度（缩略图原图不旋转）
 
     ScrollState m_scrollState;
     QQueue<QPair<int, qint64>> m_scrollHistory;
@@ -87,46 +132,7 @@ private:
     QTimer* m_throttleTimer;
     QTimer* m_debounceTimer;
 
-    ThumbnailManagerV2* m_manager;  // 用于检查加载状态
-};
-
-class ThumbnailItem : public QWidget
-{
-    Q_OBJECT
-
-public:
-    explicit ThumbnailItem(int pageIndex, int width, QWidget* parent = nullptr);
-
-    void setPlaceholder(const QString& text);
-    void setThumbnail(const QImage& image);  // 移除 isHighRes 参数
-    void setError(const QString& error);
-    void setHighlight(bool highlight);
-
-    bool hasImage() const { return m_hasImage; }
-
-signals:
-    void clicked(int pageIndex);
-
-protected:
-    void mousePressEvent(QMouseEvent* event) override;
-    void enterEvent(QEnterEvent* event) override;
-    void leaveEvent(QEvent* event) override;
-
-private:
-    void updateStyle();
-    QPixmap createRoundedPixmap(const QImage& image);
-
-private:
-    int m_pageIndex;
-    int m_width;
-    int m_height;
-    bool m_hasImage;
-    bool m_isHighlighted;
-    bool m_isHovered;
-
-    QWidget* m_imageContainer;
-    QLabel* m_imageLabel;
-    QLabel* m_pageLabel;
+    ThumbnailManagerV2* m_manager;  // 提供缩略图原图
 };
 
 #endif // THUMBNAILWIDGET_H
@@ -1,5 +1,6 @@
 #include "appconfig.h"
 #include <QApplication>
+#include <QStandardPaths>
 
 AppConfig::AppConfig()
     : m_settings(QSettings::IniFormat, QSettings::UserScope,
@@ -21,6 +22,16 @@ AppConfig& AppConfig::instance()
     return instance;
 }
 
+QString AppConfig::textLayerStoreDir() const
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/textlayer";
+}
+
+QString AppConfig::thumbnailStoreDir() const
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/thumbnails";
+}
+
 void AppConfig::loadDefaults()
 {
     // 缓存配置默认值
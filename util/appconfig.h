@@ -60,10 +60,11 @@ public:
     // ========== 文本缓存配置 ==========
 
     /**
-     * @brief 文本缓存最大页数
+     * @brief 文本缓存内存上限（MB）
+     * 超出时淘汰最久未访问且未固定的页面，被淘汰的页面按需从磁盘文本层读回或重新提取
      * -1 表示不限制(缓存所有页面)
      */
-    static constexpr int MAX_TEXT_CACHE_SIZE = -1;
+    static constexpr int MAX_TEXT_CACHE_MB = 128;
 
     /**
      * @brief PDF类型检测时的采样页数
@@ -78,10 +79,144 @@ public:
 
     /**
      * @brief 文本预加载优先页数
-     * 文档加载时优先加载前N页的文本
+     * 优先提取当前页前后N页的文本（由近及远），翻页后按新位置重新排序
      */
     static constexpr int TEXT_PRELOAD_PRIORITY_PAGES = 10;
 
+    /**
+     * @brief 是否把提取的文本层持久化到磁盘
+     * 重新打开同一文档时直接映射已有文本层，只提取缺失的页
+     */
+    static constexpr bool TEXT_LAYER_STORE_ENABLED = true;
+
+    /**
+     * @brief 文本层目录的总大小上限（MB）
+     * 超出时打开文档前删除最久未使用的文本层文件，-1 表示不限制
+     */
+    static constexpr int TEXT_LAYER_STORE_MAX_MB = 512;
+
+    /**
+     * @brief 按需获取未提取页面文本时的最长等待时间（毫秒）
+     */
+    static constexpr int TEXT_ON_DEMAND_WAIT_MS = 1000;
+
+    /**
+     * @brief 单页提取耗时超过该值（毫秒）时输出日志
+     */
+    static constexpr int TEXT_SLOW_PAGE_LOG_MS = 200;
+
+    /**
+     * @brief 后台预加载是否只提取文本（不含字符边界框）
+     * 选择、高亮需要时再按页完整提取，预加载更快、占用内存更少
+     */
+    static constexpr bool TEXT_PRELOAD_TEXT_ONLY = true;
+
+    /**
+     * @brief 文本预加载进度信号的最短间隔（毫秒）
+     * 工作线程只累加计数，主线程按此间隔发出进度，避免逐页刷新进度条
+     */
+    static constexpr int TEXT_PROGRESS_INTERVAL_MS = 100;
+
+    // ========== 搜索配置 ==========
+
+    /**
+     * @brief 单文档搜索最大匹配数
+     * -1 表示不限制（结果分页投递给搜索结果列表）
+     */
+    static constexpr int SEARCH_MAX_RESULTS = -1;
+
+    /**
+     * @brief 搜索结果列表每次加载的条数
+     */
+    static constexpr int SEARCH_RESULT_PAGE_SIZE = 100;
+
+    /**
+     * @brief 文本预加载时是否为中文文本建立分词索引
+     * 开启后“全词匹配”对中文按 jieba 分词边界判断
+     */
+    static constexpr bool SEARCH_CJK_WORD_INDEX = true;
+
+    // ========== 多文档搜索配置 ==========
+
+    /**
+     * @brief 多文档搜索同时处理的最大文档数
+     * 每个工作线程同一时刻只持有一个文档，因此也是内存中文档文本的上限
+     */
+    static constexpr int MULTI_DOC_SEARCH_MAX_DOCUMENTS = 4;
+
+    /**
+     * @brief 多文档搜索时单个文档的最大匹配数
+     */
+    static constexpr int MULTI_DOC_SEARCH_MAX_RESULTS_PER_DOC = 500;
+
+    // ========== 缩略图配置 ==========
+
+    /**
+     * @brief 是否把渲染好的缩略图持久化到磁盘
+     * 重新打开同一文档时直接从缩略图文件读取，只渲染缺失的页
+     */
+    static constexpr bool THUMBNAIL_STORE_ENABLED = true;
+
+    /**
+     * @brief 缩略图目录的总大小上限（MB）
+     * 超出时打开文档前删除最久未使用的缩略图文件，-1 表示不限制
+     */
+    static constexpr int THUMBNAIL_STORE_MAX_MB = 256;
+
+    /**
+     * @brief 缩略图每个渲染任务的最大页数
+     * 任务越小，滚动后取消过期请求越及时
+     */
+    static constexpr int THUMBNAIL_TASK_PAGES = 4;
+
+    /**
+     * @brief 滚动停止后后台补齐的缩略图页数上限（从可见区向外）
+     */
+    static constexpr int THUMBNAIL_BACKFILL_LIMIT = 400;
+
+    /**
+     * @brief 后台补齐同时占用的渲染线程数
+     * 其余线程留给可见区，滚动到新位置时可立即开始渲染
+     */
+    static constexpr int THUMBNAIL_BACKFILL_WORKERS = 1;
+
+    /**
+     * @brief 缩略图内存缓存上限（MB）
+     * 超出时淘汰最久未访问且不在视口附近的缩略图，滚回时从缩略图文件读回
+     * -1 表示不限制
+     */
+    static constexpr int MAX_THUMBNAIL_CACHE_MB = 64;
+
+    /**
+     * @brief 缩略图内存缓存是否使用紧凑编码
+     * 灰度页存为 8 位灰度，彩色页压缩存放，滚入视口时解码
+     */
+    static constexpr bool THUMBNAIL_CACHE_COMPACT = true;
+
+    /**
+     * @brief 页面自带 /Thumb 图像的最小可用宽度（相对缩略图渲染宽度）
+     * 更小的内嵌缩略图放大后过于模糊，改为解码或渲染页面
+     */
+    static constexpr double THUMBNAIL_EMBEDDED_MIN_SCALE = 0.5;
+
+    /**
+     * @brief 单图像页判定：图像至少覆盖页面面积的比例
+     * 达到时直接降采样解码该图像作为缩略图，不运行完整渲染
+     */
+    static constexpr double THUMBNAIL_IMAGE_PAGE_COVERAGE = 0.9;
+
+    /**
+     * @brief 缩略图渲染的抗锯齿级别（0-8 位，主视图为 8）
+     * 缩略图缩得很小，低级别抗锯齿肉眼看不出差别
+     */
+    static constexpr int THUMBNAIL_AA_LEVEL = 2;
+
+    /**
+     * @brief 每个缩略图渲染器缓存的 display list 数量
+     * 同一页再次渲染（调整缩略图大小、缓存淘汰后重建）时不必重新解释页面
+     */
+    static constexpr int THUMBNAIL_DISPLAY_LIST_CACHE_SIZE = 8;
+
     // ========== 缓存配置 ==========
 
     /// 最大缓存页面数
@@ -109,9 +244,12 @@ public:
     void setDefaultWindowSize(const QSize& size);
 
     /**
-     * @brief 获取文本缓存最大页数
+     * @brief 获取文本缓存内存上限（字节，-1 表示不限制）
      */
-    int maxTextCacheSize() const { return MAX_TEXT_CACHE_SIZE; }
+    qint64 maxTextCacheBytes() const
+    {
+        return MAX_TEXT_CACHE_MB < 0 ? -1 : qint64(MAX_TEXT_CACHE_MB) * 1024 * 1024;
+    }
 
     /**
      * @brief 获取PDF类型检测采样页数
@@ -123,6 +261,135 @@ public:
      */
     int textPreloadPriorityPages() const { return TEXT_PRELOAD_PRIORITY_PAGES; }
 
+    /**
+     * @brief 是否启用文本层持久化
+     */
+    bool textLayerStoreEnabled() const { return TEXT_LAYER_STORE_ENABLED; }
+
+    /**
+     * @brief 获取文本层目录大小上限（字节，-1 表示不限制）
+     */
+    qint64 textLayerStoreMaxBytes() const
+    {
+        return TEXT_LAYER_STORE_MAX_MB < 0 ? -1 : qint64(TEXT_LAYER_STORE_MAX_MB) * 1024 * 1024;
+    }
+
+    /**
+     * @brief 获取按需文本请求的最长等待时间
+     */
+    int textOnDemandWaitMs() const { return TEXT_ON_DEMAND_WAIT_MS; }
+
+    /**
+     * @brief 获取慢页日志阈值
+     */
+    int textSlowPageLogMs() const { return TEXT_SLOW_PAGE_LOG_MS; }
+
+    /**
+     * @brief 后台预加载是否只提取文本
+     */
+    bool textPreloadTextOnly() const { return TEXT_PRELOAD_TEXT_ONLY; }
+
+    /**
+     * @brief 获取预加载进度信号间隔
+     */
+    int textProgressIntervalMs() const { return TEXT_PROGRESS_INTERVAL_MS; }
+
+    /**
+     * @brief 文本层文件目录（位于用户缓存目录下）
+     */
+    QString textLayerStoreDir() const;
+
+    /**
+     * @brief 获取单文档搜索最大匹配数
+     */
+    int searchMaxResults() const { return SEARCH_MAX_RESULTS; }
+
+    /**
+     * @brief 获取搜索结果列表分页大小
+     */
+    int searchResultPageSize() const { return SEARCH_RESULT_PAGE_SIZE; }
+
+    /**
+     * @brief 是否建立中文分词索引
+     */
+    bool searchCJKWordIndex() const { return SEARCH_CJK_WORD_INDEX; }
+
+    /**
+     * @brief 获取多文档搜索并发文档数
+     */
+    int multiDocSearchMaxDocuments() const { return MULTI_DOC_SEARCH_MAX_DOCUMENTS; }
+
+    /**
+     * @brief 获取多文档搜索单文档最大匹配数
+     */
+    int multiDocSearchMaxResultsPerDoc() const { return MULTI_DOC_SEARCH_MAX_RESULTS_PER_DOC; }
+
+    /**
+     * @brief 是否启用缩略图持久化
+     */
+    bool thumbnailStoreEnabled() const { return THUMBNAIL_STORE_ENABLED; }
+
+    /**
+     * @brief 缩略图文件目录（位于用户缓存目录下）
+     */
+    QString thumbnailStoreDir() const;
+
+    /**
+     * @brief 获取缩略图目录大小上限（字节，-1 表示不限制）
+     */
+    qint64 thumbnailStoreMaxBytes() const
+    {
+        return THUMBNAIL_STORE_MAX_MB < 0 ? -1 : qint64(THUMBNAIL_STORE_MAX_MB) * 1024 * 1024;
+    }
+
+    /**
+     * @brief 获取缩略图单个渲染任务的最大页数
+     */
+    int thumbnailTaskPages() const { return THUMBNAIL_TASK_PAGES; }
+
+    /**
+     * @brief 获取缩略图后台补齐页数上限
+     */
+    int thumbnailBackfillLimit() const { return THUMBNAIL_BACKFILL_LIMIT; }
+
+    /**
+     * @brief 获取缩略图后台补齐线程数
+     */
+    int thumbnailBackfillWorkers() const { return THUMBNAIL_BACKFILL_WORKERS; }
+
+    /**
+     * @brief 获取缩略图缓存内存上限（字节，-1 表示不限制）
+     */
+    qint64 maxThumbnailCacheBytes() const
+    {
+        return MAX_THUMBNAIL_CACHE_MB < 0 ? -1 : qint64(MAX_THUMBNAIL_CACHE_MB) * 1024 * 1024;
+    }
+
+    /**
+     * @brief 缩略图缓存是否使用紧凑编码
+     */
+    bool thumbnailCacheCompact() const { return THUMBNAIL_CACHE_COMPACT; }
+
+    /**
+     * @brief 获取内嵌缩略图最小可用宽度比例
+     */
+    double thumbnailEmbeddedMinScale() const { return THUMBNAIL_EMBEDDED_MIN_SCALE; }
+
+    /**
+     * @brief 获取单图像页的最小覆盖比例
+     */
+    double thumbnailImagePageCoverage() const { return THUMBNAIL_IMAGE_PAGE_COVERAGE; }
+
+    /**
+     * @brief 获取缩略图渲染抗锯齿级别
+     */
+    int thumbnailAALevel() const { return THUMBNAIL_AA_LEVEL; }
+
+    /**
+     * @brief 获取缩略图渲染器缓存的 display list 数量
+     */
+    int thumbnailDisplayListCacheSize() const { return THUMBNAIL_DISPLAY_LIST_CACHE_SIZE; }
+
     // ========== 用户偏好 ==========
 
     /// 记住上次打开的文件
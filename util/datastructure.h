@@ -3,9 +3,13 @@
 
 #include <QChar>
 #include <QRectF>
+#include <QSizeF>
 #include <QString>
 #include <QVector>
 #include <QImage>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 struct RenderResult {
     bool success = false;
@@ -41,33 +45,360 @@ enum class PageDisplayMode {
     DoublePage
 };
 
-// 文本字符及其位置信息
-struct TextChar {
-    QChar character;
-    QRectF bbox;  // 字符的边界框
+// 量化矩形：相对页面边界的 16 位定点坐标（每个 8 字节，原 QRectF 为 32 字节）
+struct PackedRect {
+    quint16 x0 = 0;
+    quint16 y0 = 0;
+    quint16 x1 = 0;
+    quint16 y1 = 0;
 };
 
-// 文本行
-struct TextLine {
-    QVector<TextChar> chars;
-    QRectF bbox;  // 行的边界框
+/**
+ * @brief 文本提取的详细程度
+ */
+enum class TextExtractDetail {
+    Full,       ///< 文本 + 每个字符的边界框（选择、高亮、命中测试）
+    TextOnly    ///< 只有文本和行/块边界框（后台预加载、建索引、搜索）
 };
 
-// 文本块
-struct TextBlock {
-    QVector<TextLine> lines;
-    QRectF bbox;  // 块的边界框
-};
-
-// 页面的完整文本信息（纯数据，不包含 MuPDF 对象）
+/**
+ * @brief 页面的完整文本信息（纯数据，不包含 MuPDF 对象）
+ *
+ * 采用扁平的结构数组布局：字符按块、行顺序展开，字符序号即数组下标；
+ * 行、块只保存起点表和边界框。块/行/行内索引通过偏移表换算，
+ * 遍历时访问的是连续内存。
+ */
 struct PageTextData {
     int pageIndex;
-    QVector<TextBlock> blocks;
-    QString fullText;  // 完整文本（用于快速搜索）
+    QRectF bounds;                  // 页面边界（坐标量化基准）
+
+    // 字符
+    QVector<char32_t> codepoints;   // 每个字符的 Unicode 码点
+    QVector<PackedRect> charBoxes;  // 每个字符的边界框（TextOnly 提取时为空）
+
+    // 行（按页面顺序编号）
+    QVector<int> lineCharStarts;    // 每行首字符序号，末尾追加总字符数
+    QVector<PackedRect> lineBoxes;
+
+    // 块
+    QVector<int> blockLineStarts;   // 每块首行序号，末尾追加总行数
+    QVector<PackedRect> blockBoxes;
+
+    // 折叠影子文本（提取时生成，见 TextFolding），用于忽略变音/全半角/大小写的搜索
+    QString foldedText;             // 各行折叠文本，行间以 '\n' 分隔
+    QVector<int> foldedToChar;      // foldedText 每个字符 -> 原字符序号（分隔符为 -1）；逐字一一折叠时为空
+
+    // 中文分词索引（预加载线程中由 ChineseTokenizer 生成，含中文的行才有）
+    QVector<int> wordBreaks;        // 升序的词起点字符序号（含行尾），为空表示未建立
 
     PageTextData() : pageIndex(-1) {}
-    bool isEmpty() const { return blocks.isEmpty(); }
+    bool isEmpty() const { return blockBoxes.isEmpty(); }
+    bool isValid() const { return pageIndex >= 0; }
+
+    // 是否有逐字符边界框（空白页视为有）
+    bool hasCharBoxes() const { return charBoxes.size() == codepoints.size(); }
+
+    // 占用内存估算（字节），用于文本缓存的内存预算
+    qint64 memoryBytes() const
+    {
+        return sizeof(PageTextData)
+               + qint64(codepoints.capacity()) * sizeof(char32_t)
+               + qint64(charBoxes.capacity() + lineBoxes.capacity() + blockBoxes.capacity()) * sizeof(PackedRect)
+               + qint64(lineCharStarts.capacity() + blockLineStarts.capacity()) * sizeof(int)
+               + qint64(foldedText.capacity()) * sizeof(QChar)
+               + qint64(foldedToChar.capacity() + wordBreaks.capacity()) * sizeof(int);
+    }
+
+    // ========== 构建（提取时按顺序调用） ==========
+
+    void beginBlock(const QRectF& bbox)
+    {
+        blockLineStarts.append(lineBoxes.size());
+        blockBoxes.append(pack(bbox));
+    }
+
+    void beginLine(const QRectF& bbox)
+    {
+        lineCharStarts.append(codepoints.size());
+        lineBoxes.append(pack(bbox));
+    }
+
+    void appendChar(char32_t codepoint, const QRectF& bbox)
+    {
+        codepoints.append(codepoint);
+        charBoxes.append(pack(bbox));
+    }
+
+    // TextOnly 提取：不保存字符边界框
+    void appendChar(char32_t codepoint)
+    {
+        codepoints.append(codepoint);
+    }
+
+    // 追加偏移表末尾的总数并释放多余容量
+    void finish()
+    {
+        lineCharStarts.append(codepoints.size());
+        blockLineStarts.append(lineBoxes.size());
+        codepoints.squeeze();
+        charBoxes.squeeze();
+        lineCharStarts.squeeze();
+        lineBoxes.squeeze();
+        blockLineStarts.squeeze();
+        blockBoxes.squeeze();
+    }
+
+    // ========== 访问 ==========
+
+    int blockCount() const { return blockBoxes.size(); }
+    int totalLineCount() const { return lineBoxes.size(); }
+    int totalCharCount() const { return codepoints.size(); }
+
+    // 块内行数
+    int lineCount(int block) const
+    {
+        return blockLineStarts[block + 1] - blockLineStarts[block];
+    }
+
+    // 块内行索引 -> 页面行序号
+    int lineOrdinal(int block, int line) const { return blockLineStarts[block] + line; }
+
+    // 行内字符数（按页面行序号）
+    int lineCharCount(int lineOrdinal) const
+    {
+        return lineCharStarts[lineOrdinal + 1] - lineCharStarts[lineOrdinal];
+    }
+
+    // 行内字符数（按块、行索引）
+    int charCount(int block, int line) const { return lineCharCount(lineOrdinal(block, line)); }
+
+    // 块/行/行内索引 -> 页面字符序号
+    int charOrdinal(int block, int line, int ch) const
+    {
+        return lineCharStarts[lineOrdinal(block, line)] + ch;
+    }
+
+    char32_t codepoint(int charOrdinal) const { return codepoints[charOrdinal]; }
+
+    // 单个字符的文本（辅助平面字符为两个 UTF-16 单元）
+    QString charText(int charOrdinal) const
+    {
+        const char32_t cp = codepoints[charOrdinal];
+        return QString::fromUcs4(&cp, 1);
+    }
+
+    // 没有字符边界框时退化为所在行的边界框
+    QRectF charRect(int charOrdinal) const
+    {
+        if (!hasCharBoxes()) {
+            return lineRect(lineOfChar(charOrdinal));
+        }
+        return unpack(charBoxes[charOrdinal]);
+    }
+
+    QRectF lineRect(int lineOrdinal) const { return unpack(lineBoxes[lineOrdinal]); }
+    QRectF blockRect(int block) const { return unpack(blockBoxes[block]); }
+
+    /**
+     * @brief 合并一段连续字符的边界框
+     */
+    QRectF charRangeRect(int firstChar, int count) const
+    {
+        if (!hasCharBoxes() && count > 0) {
+            const int firstLine = lineOfChar(firstChar);
+            const int lastLine = lineOfChar(firstChar + count - 1);
+            QRectF rect = lineRect(firstLine);
+            for (int line = firstLine + 1; line <= lastLine; ++line) {
+                rect = rect.united(lineRect(line));
+            }
+            return rect;
+        }
+
+        QRectF rect;
+        for (int i = firstChar; i < firstChar + count; ++i) {
+            rect = rect.isNull() ? charRect(i) : rect.united(charRect(i));
+        }
+        return rect;
+    }
+
+    /**
+     * @brief 行文本
+     * @param utf16ToChar 若非空：行内含辅助平面字符时填充 UTF-16 下标 -> 行内字符索引，
+     *        否则清空（表示一一对应）
+     */
+    QString lineText(int lineOrdinal, QVector<int>* utf16ToChar = nullptr) const
+    {
+        const int first = lineCharStarts[lineOrdinal];
+        const int count = lineCharCount(lineOrdinal);
+
+        QString text = QString::fromUcs4(codepoints.constData() + first, count);
+        if (utf16ToChar) {
+            utf16ToChar->clear();
+            if (text.size() != count) {
+                utf16ToChar->reserve(text.size());
+                for (int c = 0; c < count; ++c) {
+                    utf16ToChar->append(c);
+                    if (QChar::requiresSurrogates(codepoints[first + c])) {
+                        utf16ToChar->append(c);
+                    }
+                }
+            }
+        }
+        return text;
+    }
+
+    /**
+     * @brief 将页面字符序号还原为块/行/行内位置
+     * @return 序号有效返回 true
+     */
+    bool locateChar(int charOrdinal, int* blockIndex, int* lineIndex, int* charIndex) const
+    {
+        if (charOrdinal < 0 || lineCharStarts.size() < 2 || charOrdinal >= lineCharStarts.last()) {
+            return false;
+        }
+
+        const int line = lineOfChar(charOrdinal);
+
+        // 二分查找所在块
+        auto blockIt = std::upper_bound(blockLineStarts.cbegin(), blockLineStarts.cend() - 1,
+                                        line) - 1;
+        int block = static_cast<int>(blockIt - blockLineStarts.cbegin());
+
+        if (blockIndex) *blockIndex = block;
+        if (lineIndex) *lineIndex = line - blockLineStarts[block];
+        if (charIndex) *charIndex = charOrdinal - lineCharStarts[line];
+        return true;
+    }
+
+    // 字符所在的页面行序号（二分查找最后一个起点 <= charOrdinal 的行）
+    int lineOfChar(int charOrdinal) const
+    {
+        auto lineIt = std::upper_bound(lineCharStarts.cbegin(), lineCharStarts.cend() - 1,
+                                       charOrdinal) - 1;
+        return static_cast<int>(lineIt - lineCharStarts.cbegin());
+    }
+
+private:
+    PackedRect pack(const QRectF& rect) const
+    {
+        PackedRect packed;
+        if (bounds.width() <= 0 || bounds.height() <= 0) {
+            return packed;
+        }
+        packed.x0 = quantize(rect.left(), bounds.left(), bounds.width());
+        packed.y0 = quantize(rect.top(), bounds.top(), bounds.height());
+        packed.x1 = quantize(rect.right(), bounds.left(), bounds.width());
+        packed.y1 = quantize(rect.bottom(), bounds.top(), bounds.height());
+        return packed;
+    }
+
+    QRectF unpack(const PackedRect& packed) const
+    {
+        const double sx = bounds.width() / 65535.0;
+        const double sy = bounds.height() / 65535.0;
+        return QRectF(QPointF(bounds.left() + packed.x0 * sx, bounds.top() + packed.y0 * sy),
+                      QPointF(bounds.left() + packed.x1 * sx, bounds.top() + packed.y1 * sy));
+    }
+
+    static quint16 quantize(double value, double origin, double extent)
+    {
+        const double q = (value - origin) / extent * 65535.0 + 0.5;
+        return static_cast<quint16>(qBound(0.0, q, 65535.0));
+    }
+};
+
+/**
+ * @brief 页面字符命中测试索引
+ *
+ * 把页面按高度切成若干水平条带，每个条带记录与之相交的行（行的垂直范围上下各扩展
+ * 半个行高，与选择时的命中容差一致），并缓存每行全部字符合并后的边界框。
+ * 鼠标命中测试只需检查所在条带里的几行，不必遍历整页字符。
+ */
+struct PageHitIndex {
+    static constexpr int MAX_BANDS = 1024;
+
+    int pageIndex;
+    double top;                     // 第一个条带的上边界
+    double bandHeight;
+    QVector<int> bandLineStarts;    // 每个条带在 bandLines 中的起点，末尾追加总数
+    QVector<int> bandLines;         // 条带内的页面行序号（升序）
+    QVector<QRectF> lineFullRects;  // 每行全部字符合并的边界框（空行为空矩形）
+
+    PageHitIndex() : pageIndex(-1), top(0.0), bandHeight(1.0) {}
     bool isValid() const { return pageIndex >= 0; }
+
+    int bandCount() const { return qMax(0, int(bandLineStarts.size()) - 1); }
+
+    // y 坐标所在条带（超出范围时取首尾条带）
+    int bandOf(double y) const
+    {
+        const double band = std::floor((y - top) / bandHeight);
+        return static_cast<int>(qBound(0.0, band, double(qMax(0, bandCount() - 1))));
+    }
+
+    void build(const PageTextData& data)
+    {
+        *this = PageHitIndex();
+        pageIndex = data.pageIndex;
+
+        const int lineTotal = data.totalLineCount();
+        lineFullRects.resize(lineTotal);
+
+        QVector<double> lineTops(lineTotal), lineBottoms(lineTotal);
+        double minY = std::numeric_limits<double>::max();
+        double maxY = std::numeric_limits<double>::lowest();
+        int nonEmptyLines = 0;
+
+        for (int line = 0; line < lineTotal; ++line) {
+            const int count = data.lineCharCount(line);
+            if (count == 0) {
+                continue;
+            }
+            const QRectF rect = data.lineRect(line);
+            const double margin = rect.height() * 0.5;
+            lineTops[line] = rect.top() - margin;
+            lineBottoms[line] = rect.bottom() + margin;
+            minY = qMin(minY, lineTops[line]);
+            maxY = qMax(maxY, lineBottoms[line]);
+            lineFullRects[line] = data.charRangeRect(data.lineCharStarts[line], count);
+            ++nonEmptyLines;
+        }
+
+        if (nonEmptyLines == 0) {
+            bandLineStarts = {0, 0};
+            return;
+        }
+
+        const int bands = qBound(1, nonEmptyLines, MAX_BANDS);
+        top = minY;
+        bandHeight = (maxY - minY) / bands;
+        if (bandHeight <= 0.0) {
+            bandHeight = 1.0;
+        }
+        bandLineStarts.fill(0, bands + 1);
+
+        // 两遍：先统计每个条带的行数，再按行序号升序填入
+        for (int line = 0; line < lineTotal; ++line) {
+            if (data.lineCharCount(line) == 0) continue;
+            const int last = bandOf(lineBottoms[line]);
+            for (int band = bandOf(lineTops[line]); band <= last; ++band) {
+                ++bandLineStarts[band + 1];
+            }
+        }
+        for (int band = 0; band < bands; ++band) {
+            bandLineStarts[band + 1] += bandLineStarts[band];
+        }
+
+        bandLines.resize(bandLineStarts.last());
+        QVector<int> fill(bandLineStarts.cbegin(), bandLineStarts.cend() - 1);
+        for (int line = 0; line < lineTotal; ++line) {
+            if (data.lineCharCount(line) == 0) continue;
+            const int last = bandOf(lineBottoms[line]);
+            for (int band = bandOf(lineTops[line]); band <= last; ++band) {
+                bandLines[fill[band]++] = line;
+            }
+        }
+    }
 };
 
 // ========== 搜索选项 ==========
@@ -75,7 +406,8 @@ struct PageTextData {
 struct SearchOptions {
     bool caseSensitive = false;
     bool wholeWords = false;
-    int maxResults = 1000;
+    int maxResults = 1000;      // <= 0 表示不限制
+    bool foldInsensitive = false;  // 忽略变音符号、全半角和大小写（使用折叠影子文本）
 };
 
 // ========== 搜索结果 ==========
@@ -83,12 +415,59 @@ struct SearchOptions {
 struct SearchResult {
     int pageIndex;
     QVector<QRectF> quads;  // 匹配文本的位置
-    QString context;        // 上下文
 
-    SearchResult() : pageIndex(-1) {}
-    explicit SearchResult(int page) : pageIndex(page) {}
+    // 匹配在页面文本中的位置（上下文据此按需生成）
+    int blockIndex;
+    int lineIndex;
+    int charStart;          // 行内起始字符
+    int length;             // 匹配字符数
+
+    QString context;        // 上下文（可选，为空时由 SearchManager 按需生成）
+
+    SearchResult() : pageIndex(-1), blockIndex(-1), lineIndex(-1), charStart(0), length(0) {}
+    explicit SearchResult(int page)
+        : pageIndex(page), blockIndex(-1), lineIndex(-1), charStart(0), length(0) {}
 
     bool isValid() const { return pageIndex >= 0 && !quads.isEmpty(); }
 };
 
+// ========== 链接与页面分析 ==========
+
+/**
+ * @brief PDF链接信息
+ */
+struct PDFLink
+{
+    QRectF rect;          ///< 链接区域（页面坐标）
+    int targetPage;       ///< 目标页码（-1表示外部链接）
+    QString uri;          ///< 链接URI
+
+    PDFLink() : targetPage(-1) {}
+
+    /**
+     * @brief 判断是否为内部链接
+     */
+    bool isInternal() const { return targetPage >= 0; }
+
+    /**
+     * @brief 判断是否为外部链接
+     */
+    bool isExternal() const { return !uri.isEmpty() && targetPage < 0; }
+};
+
+/**
+ * @brief 单页分析结果（一次加载页面得到的除文本以外的信息）
+ *
+ * 由 PerThreadMuPDFRenderer::analyzePage() 与页面文本一起生成
+ */
+struct PageAnalysis {
+    int pageIndex = -1;
+    QSizeF size;                ///< 页面尺寸（点）
+    bool hasTextLayer = false;  ///< 有可见字符（非空白）
+    bool imageOnly = false;     ///< 没有文本但有图像（扫描页，需要 OCR）
+    QVector<PDFLink> links;
+
+    bool isValid() const { return pageIndex >= 0; }
+};
+
 #endif // DATASTRUCTURE_H
@@ -0,0 +1,117 @@
+#include "textfolding.h"
+#include "datastructure.h"
+#include <QHash>
+
+QString TextFolding::foldChar(char32_t codepoint)
+{
+    // ASCII 快速路径：只需大小写折叠
+    if (codepoint < 0x80) {
+        return QString(QChar(codepoint).toLower());
+    }
+
+    // 非 ASCII 字符的折叠结果按线程缓存（提取在工作线程中进行）
+    thread_local QHash<char32_t, QString> cache;
+    auto it = cache.constFind(codepoint);
+    if (it != cache.constEnd()) {
+        return it.value();
+    }
+
+    // NFKD：兼容分解（全角→半角、连字拆分）并把变音符号拆成组合字符
+    const QString decomposed = QString::fromUcs4(&codepoint, 1)
+                                   .normalized(QString::NormalizationForm_KD);
+
+    QString folded;
+    folded.reserve(decomposed.size());
+    for (QChar c : decomposed) {
+        switch (c.category()) {
+        case QChar::Mark_NonSpacing:
+        case QChar::Mark_SpacingCombining:
+        case QChar::Mark_Enclosing:
+            break;  // 去除变音符号
+        default:
+            folded.append(c);
+            break;
+        }
+    }
+
+    folded = folded.toCaseFolded();
+    cache.insert(codepoint, folded);
+    return folded;
+}
+
+QString TextFolding::foldString(const QString& text)
+{
+    QString folded;
+    folded.reserve(text.size());
+    for (char32_t codepoint : text.toUcs4()) {
+        folded.append(foldChar(codepoint));
+    }
+    return folded;
+}
+
+void TextFolding::buildFoldedText(PageTextData& data)
+{
+    data.foldedText.clear();
+    data.foldedToChar.clear();
+
+    const int lineCount = data.totalLineCount();
+    data.foldedText.reserve(data.totalCharCount() + lineCount);
+    data.foldedToChar.reserve(data.totalCharCount() + lineCount);
+
+    // 是否每个字符都恰好折叠为一个 UTF-16 单元
+    bool oneToOne = true;
+
+    for (int line = 0; line < lineCount; ++line) {
+        const int first = data.lineCharStarts[line];
+        const int last = data.lineCharStarts[line + 1];
+
+        for (int charOrdinal = first; charOrdinal < last; ++charOrdinal) {
+            const QString folded = foldChar(data.codepoints[charOrdinal]);
+            data.foldedText.append(folded);
+            for (int i = 0; i < folded.size(); ++i) {
+                data.foldedToChar.append(charOrdinal);
+            }
+            oneToOne = oneToOne && folded.size() == 1;
+        }
+
+        // 行分隔符，保证匹配不跨行
+        data.foldedText.append(QLatin1Char('\n'));
+        data.foldedToChar.append(-1);
+    }
+
+    // 一一对应时映射可由行起点表推算，不必为每个字符保存序号
+    if (oneToOne) {
+        data.foldedToChar = QVector<int>();
+    }
+    data.foldedText.squeeze();
+    data.foldedToChar.squeeze();
+}
+
+int TextFolding::foldedToCharOrdinal(const PageTextData& data, int foldedPos)
+{
+    if (foldedPos < 0 || foldedPos >= data.foldedText.size()) {
+        return -1;
+    }
+
+    if (!data.foldedToChar.isEmpty()) {
+        return data.foldedToChar[foldedPos];
+    }
+
+    // 一一对应：第 L 行在折叠文本中起始于 lineCharStarts[L] + L（前面有 L 个分隔符）
+    int lo = 0;
+    int hi = data.totalLineCount() - 1;
+    while (lo < hi) {
+        const int mid = (lo + hi + 1) / 2;
+        if (data.lineCharStarts[mid] + mid <= foldedPos) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+
+    const int offset = foldedPos - (data.lineCharStarts[lo] + lo);
+    if (offset >= data.lineCharCount(lo)) {
+        return -1;  // 行分隔符
+    }
+    return data.lineCharStarts[lo] + offset;
+}
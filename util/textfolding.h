@@ -0,0 +1,47 @@
+#ifndef TEXTFOLDING_H
+#define TEXTFOLDING_H
+
+#include <QString>
+#include <QChar>
+
+struct PageTextData;
+
+/**
+ * @brief 文本折叠工具
+ *
+ * 折叠规则：NFKD 兼容分解（全角→半角、连字拆分）+ 去除变音符号 + 大小写折叠。
+ * 页面文本在提取时折叠一次并保存映射表，不敏感搜索只需折叠查询串，
+ * 匹配代价与普通搜索相同。
+ */
+class TextFolding
+{
+public:
+    /**
+     * @brief 折叠单个字符（结果可能为 0~N 个字符）
+     */
+    static QString foldChar(char32_t codepoint);
+
+    /**
+     * @brief 折叠字符串（用于查询串）
+     */
+    static QString foldString(const QString& text);
+
+    /**
+     * @brief 为页面文本生成折叠影子文本和映射表
+     *
+     * 填充 PageTextData::foldedText / foldedToChar。
+     * 每个字符都折叠为单个 UTF-16 单元时（绝大多数页面）不保存映射表。
+     */
+    static void buildFoldedText(PageTextData& data);
+
+    /**
+     * @brief 折叠文本下标 -> 原字符序号
+     * @return 行分隔符或越界返回 -1
+     */
+    static int foldedToCharOrdinal(const PageTextData& data, int foldedPos);
+
+private:
+    TextFolding() = delete;
+};
+
+#endif // TEXTFOLDING_H